@@ -0,0 +1,54 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+// Platform definitions of the host build, in place of platform/xbox/PlatformDefs.h and the
+// windows.h of nxdk. Only what the portable core compiled by tools/benchmark uses.
+
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
+#include <stdint.h>
+#include <strings.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+typedef uint32_t DWORD;
+typedef int BOOL;
+typedef void* HANDLE;
+typedef uint8_t BYTE;
+typedef uint16_t WORD;
+typedef unsigned int UINT;
+typedef int64_t __int64;
+
+typedef union _LARGE_INTEGER
+{
+  struct
+  {
+    DWORD LowPart;
+    int32_t HighPart;
+  } u;
+  int64_t QuadPart;
+} LARGE_INTEGER;
+
+#define __stat64 stat64
+
+#define TRUE 1
+#define FALSE 0
+#define MAX_PATH 260
+
+#define stricmp strcasecmp
+#define strcmpi strcasecmp
+#define strnicmp strncasecmp
+
+// little endian
+#define PIXEL_ASHIFT 24
+#define PIXEL_RSHIFT 16
+#define PIXEL_GSHIFT 8
+#define PIXEL_BSHIFT 0
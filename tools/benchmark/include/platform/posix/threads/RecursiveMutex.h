@@ -0,0 +1,20 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <mutex>
+
+namespace XbmcThreads
+{
+  // The host build has no platform/posix tree; the standard recursive mutex is all
+  // CCriticalSection needs from it.
+  class CRecursiveMutex : public std::recursive_mutex
+  {
+  };
+}
@@ -0,0 +1,36 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "filesystem/SpecialProtocol.h"
+#include "utils/Benchmark.h"
+#include "utils/StringUtils.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <unistd.h>
+
+/*! \brief Run a benchmark suite, with the parameters of the Benchmark builtin.
+ *  \details argv[1] = The suite, "core" by default.
+ *           argv[2] = The scale of its data (optional), 1 by default.
+ *           argv[3] = "update" to store the results as the baseline (optional).
+ *  The results and the baseline are kept in the working directory.
+ */
+int main(int argc, char* argv[])
+{
+  const std::string suite = argc > 1 ? argv[1] : "core";
+  const unsigned int scale = argc > 2 ? std::max(atoi(argv[2]), 1) : 1;
+  const bool update = argc > 3 && StringUtils::EqualsNoCase(argv[3], "update");
+
+  char cwd[4096];
+  if (!getcwd(cwd, sizeof(cwd)))
+    return EXIT_FAILURE;
+  CSpecialProtocol::SetTempPath(cwd);
+  CSpecialProtocol::SetProfilePath(cwd);
+
+  return CBenchmark::RunSuite(suite, scale, update) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,244 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+// What the portable core uses of the rest of the application, as it is before any settings,
+// language or add-on are loaded. There are no databases and no network in the host build.
+
+#include "LangInfo.h"
+#include "ServiceBroker.h"
+#include "URL.h"
+#include "Util.h"
+#include "guilib/LocalizeStrings.h"
+#include "network/DNSNameCache.h"
+#include "utils/DatabaseUtils.h"
+#include "utils/FileExtensionProvider.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+
+#include <arpa/inet.h>
+#include <cstdlib>
+
+namespace
+{
+// the add-on manager is never asked for anything, the provider has no add-on extensions
+alignas(void*) char g_addonManager[1];
+} // namespace
+
+CServiceBroker::CServiceBroker() : m_pGUI(nullptr)
+{
+}
+
+CServiceBroker::~CServiceBroker() = default;
+
+CFileExtensionProvider& CServiceBroker::GetFileExtensionProvider()
+{
+  static CFileExtensionProvider provider(*reinterpret_cast<ADDON::CAddonMgr*>(g_addonManager));
+  return provider;
+}
+
+bool CServiceBroker::IsAddonInterfaceUp()
+{
+  return false;
+}
+
+// the defaults of CAdvancedSettings
+CFileExtensionProvider::CFileExtensionProvider(ADDON::CAddonMgr& addonManager)
+  : m_addonManager(addonManager)
+{
+}
+
+CFileExtensionProvider::~CFileExtensionProvider() = default;
+
+std::string CFileExtensionProvider::GetPictureExtensions() const
+{
+  return ".png|.jpg|.jpeg|.bmp|.gif|.ico|.tif|.tiff|.tga|.pcx|.cbz|.zip|.rss|.webp|.jp2|.apng";
+}
+
+std::string CFileExtensionProvider::GetMusicExtensions() const
+{
+  return ".nsv|.m4a|.flac|.aac|.strm|.pls|.rm|.rma|.mpa|.wav|.wma|.ogg|.mp3|.mp2|.m3u|.gdm|.imf|"
+         ".m15|.sfx|.uni|.ac3|.dts|.cue|.aif|.aiff|.wpl|.xspf|.ape|.mac|.mpc|.mp+|.mpp|.shn|.zip|"
+         ".wv|.dsp|.xsp|.xwav|.waa|.wvs|.wam|.gcm|.idsp|.mpdsp|.mss|.spt|.rsd|.sap|.cmc|.cmr|.dmc|"
+         ".mpt|.mpd|.rmt|.tmc|.tm8|.tm2|.oga|.url|.pxml|.tta|.rss|.wtv|.mka|.tak|.opus|.dff|.dsf|"
+         ".m4b|.dtshd";
+}
+
+std::string CFileExtensionProvider::GetVideoExtensions() const
+{
+  return ".m4v|.3g2|.3gp|.nsv|.tp|.ts|.ty|.strm|.pls|.rm|.rmvb|.mpd|.m3u|.m3u8|.ifo|.mov|.qt|"
+         ".divx|.xvid|.bivx|.vob|.nrg|.img|.iso|.udf|.pva|.wmv|.asf|.asx|.ogm|.m2v|.avi|.bin|"
+         ".dat|.mpg|.mpeg|.mp4|.mkv|.mk3d|.avc|.vp3|.svq3|.nuv|.viv|.dv|.fli|.flv|.001|.wpl|.xspf|"
+         ".zip|.vdr|.dvr-ms|.xsp|.mts|.m2t|.m2ts|.evo|.ogv|.sdp|.avs|.rec|.url|.pxml|.vc1|.h264|"
+         ".rcv|.rss|.mpls|.mpl|.webm|.bdmv|.bdm|.wtv|.trp|.f4v";
+}
+
+std::string CFileExtensionProvider::GetSubtitleExtensions() const
+{
+  return ".utf|.utf8|.utf-8|.sub|.srt|.smi|.rt|.txt|.ssa|.text|.ssa|.aqt|.jss|.ass|.vtt|.idx|"
+         ".ifo|.zip|.sup";
+}
+
+bool CFileExtensionProvider::EncodedHostName(const std::string& protocol) const
+{
+  return false;
+}
+
+CLangInfo::CRegion::CRegion()
+{
+  SetDefaults();
+}
+
+void CLangInfo::CRegion::SetDefaults()
+{
+  m_strName = "N/A";
+  m_strLangLocaleName = "English";
+  m_strLangLocaleCodeTwoChar = "en";
+
+  m_strDateFormatShort = "DD/MM/YYYY";
+  m_strDateFormatLong = "DDDD, D MMMM YYYY";
+  m_strTimeFormat = "HH:mm:ss";
+  m_tempUnit = CTemperature::UnitCelsius;
+  m_speedUnit = CSpeed::UnitKilometresPerHour;
+  m_strTimeZone.clear();
+}
+
+CLangInfo::CLangInfo()
+{
+  m_currentRegion = &m_defaultRegion;
+  m_systemLocale = std::locale::classic();
+  m_originalLocale = std::locale::classic();
+  m_forceUnicodeFont = false;
+  m_strGuiCharSet = "CP1252";
+  m_strSubtitleCharSet = "CP1252";
+  m_shortDateFormat = m_defaultRegion.m_strDateFormatShort;
+  m_longDateFormat = m_defaultRegion.m_strDateFormatLong;
+  m_timeFormat = m_defaultRegion.m_strTimeFormat;
+  m_use24HourClock = true;
+  m_temperatureUnit = m_defaultRegion.m_tempUnit;
+  m_speedUnit = m_defaultRegion.m_speedUnit;
+  m_collationtype = 1;
+  m_languageCodeGeneral = "eng";
+}
+
+CLangInfo::~CLangInfo() = default;
+
+void CLangInfo::OnSettingChanged(const std::shared_ptr<const CSetting>& setting)
+{
+}
+
+void CLangInfo::OnSettingsLoaded()
+{
+}
+
+std::string CLangInfo::GetGuiCharSet() const
+{
+  return m_strGuiCharSet;
+}
+
+std::string CLangInfo::GetSubtitleCharSet() const
+{
+  return m_strSubtitleCharSet;
+}
+
+const std::locale& CLangInfo::GetOriginalLocale() const
+{
+  return m_originalLocale;
+}
+
+const std::string& CLangInfo::GetDateFormat(bool bLongDate /* = false */) const
+{
+  return bLongDate ? m_longDateFormat : m_shortDateFormat;
+}
+
+const std::string& CLangInfo::GetTimeFormat() const
+{
+  return m_timeFormat;
+}
+
+const std::string& CLangInfo::MeridiemSymbolToString(MeridiemSymbol symbol)
+{
+  return g_localizeStrings.Get(symbol == MeridiemSymbolAM ? 378 : 379);
+}
+
+std::set<std::string> CLangInfo::GetSortTokens() const
+{
+  // neither langinfo.xml of English nor the default advanced settings have any
+  return m_sortTokens;
+}
+
+bool CLangInfo::UseLocaleCollation()
+{
+  // the accent folding of the internal collation, the classic locale of the host has none
+  return false;
+}
+
+CLocalizeStrings::CLocalizeStrings(void) = default;
+
+CLocalizeStrings::~CLocalizeStrings(void) = default;
+
+const std::string& CLocalizeStrings::Get(uint32_t code) const
+{
+  static const std::string empty;
+  return empty;
+}
+
+CLocalizeStrings g_localizeStrings;
+
+std::string CUtil::ValidatePath(const std::string& path, bool bFixDoubleSlashes /* = false */)
+{
+  std::string result = path;
+  if (URIUtils::IsURL(path) &&
+      (path.find('%') != std::string::npos || StringUtils::StartsWithNoCase(path, "zip:") ||
+       StringUtils::StartsWithNoCase(path, "stack:") ||
+       StringUtils::StartsWithNoCase(path, "multipath:")))
+    return result;
+
+  StringUtils::Replace(result, '\\', '/');
+  if (bFixDoubleSlashes && !result.empty())
+  {
+    // don't touch the :// of URLs
+    for (size_t x = 2; x < result.size() - 1; x++)
+    {
+      if (result[x] == '/' && result[x + 1] == '/' &&
+          !(result[x - 1] == ':' || (result[x - 1] == '/' && result[x - 2] == ':')))
+        result.erase(x, 1);
+    }
+  }
+  return result;
+}
+
+int CUtil::GetRandomNumber()
+{
+  return rand();
+}
+
+bool CDNSNameCache::Lookup(const std::string& strHostName, std::string& strIpAddress)
+{
+  // addresses only, host names aren't resolved
+  in_addr address;
+  if (inet_pton(AF_INET, strHostName.c_str(), &address) != 1)
+    return false;
+
+  strIpAddress = strHostName;
+  return true;
+}
+
+bool DatabaseUtils::GetSelectFields(const Fields& fields,
+                                    const MediaType& mediaType,
+                                    FieldList& selectFields)
+{
+  return false;
+}
+
+bool DatabaseUtils::GetDatabaseResults(const MediaType& mediaType,
+                                       const FieldList& fields,
+                                       const std::unique_ptr<dbiplus::Dataset>& dataset,
+                                       DatabaseResults& results)
+{
+  return false;
+}
@@ -0,0 +1,175 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+// XFILE::CFile of the host build: local files only, through stdio, after translating special://
+// paths. No file factory, caching or buffering.
+
+#include "URL.h"
+#include "filesystem/File.h"
+#include "filesystem/IFile.h"
+#include "filesystem/SpecialProtocol.h"
+#include "utils/BitstreamStats.h"
+
+#include <cstdio>
+
+using namespace XFILE;
+
+namespace
+{
+class CHostFile : public IFile
+{
+public:
+  ~CHostFile() override { Close(); }
+
+  bool Open(const CURL& url) override { return Open(url, "rb"); }
+  bool OpenForWrite(const CURL& url, bool bOverWrite) override
+  {
+    return Open(url, bOverWrite ? "wb" : "ab");
+  }
+  bool Exists(const CURL& url) override
+  {
+    struct __stat64 buffer;
+    return Stat(url, &buffer) == 0;
+  }
+  int Stat(const CURL& url, struct __stat64* buffer) override
+  {
+    return stat64(CSpecialProtocol::TranslatePath(url).c_str(), buffer);
+  }
+  ssize_t Read(void* bufPtr, size_t bufSize) override
+  {
+    const size_t read = fread(bufPtr, 1, bufSize, m_file);
+    return read == 0 && ferror(m_file) ? -1 : static_cast<ssize_t>(read);
+  }
+  ssize_t Write(const void* bufPtr, size_t bufSize) override
+  {
+    return fwrite(bufPtr, 1, bufSize, m_file) == bufSize ? static_cast<ssize_t>(bufSize) : -1;
+  }
+  int64_t Seek(int64_t iFilePosition, int iWhence) override
+  {
+    return fseeko(m_file, iFilePosition, iWhence) == 0 ? GetPosition() : -1;
+  }
+  void Close() override
+  {
+    if (m_file)
+      fclose(m_file);
+    m_file = nullptr;
+  }
+  int64_t GetPosition() override { return ftello(m_file); }
+  int64_t GetLength() override
+  {
+    struct stat buffer;
+    return fstat(fileno(m_file), &buffer) == 0 ? buffer.st_size : -1;
+  }
+  void Flush() override { fflush(m_file); }
+
+private:
+  bool Open(const CURL& url, const char* mode)
+  {
+    m_file = fopen(CSpecialProtocol::TranslatePath(url).c_str(), mode);
+    return m_file != nullptr;
+  }
+
+  FILE* m_file = nullptr;
+};
+} // namespace
+
+CFile::CFile() = default;
+
+CFile::~CFile()
+{
+  Close();
+}
+
+bool CFile::Open(const std::string& strFileName, const unsigned int flags)
+{
+  Close();
+  m_curl = CURL(strFileName);
+  m_flags = flags;
+  m_pFile = std::make_unique<CHostFile>();
+  if (!m_pFile->Open(m_curl))
+  {
+    m_pFile.reset();
+    return false;
+  }
+  return true;
+}
+
+bool CFile::OpenForWrite(const std::string& strFileName, bool bOverWrite)
+{
+  Close();
+  m_curl = CURL(strFileName);
+  m_pFile = std::make_unique<CHostFile>();
+  if (!m_pFile->OpenForWrite(m_curl, bOverWrite))
+  {
+    m_pFile.reset();
+    return false;
+  }
+  return true;
+}
+
+ssize_t CFile::LoadFile(const std::string& filename, std::vector<uint8_t>& outputBuffer)
+{
+  outputBuffer.clear();
+  if (!Open(filename))
+    return 0;
+
+  const int64_t length = GetLength();
+  if (length < 0)
+    return -1;
+
+  outputBuffer.resize(static_cast<size_t>(length));
+  const ssize_t read = Read(outputBuffer.data(), outputBuffer.size());
+  outputBuffer.resize(read > 0 ? read : 0);
+  return read;
+}
+
+ssize_t CFile::Read(void* bufPtr, size_t bufSize)
+{
+  return m_pFile ? m_pFile->Read(bufPtr, bufSize) : -1;
+}
+
+ssize_t CFile::Write(const void* bufPtr, size_t bufSize)
+{
+  return m_pFile ? m_pFile->Write(bufPtr, bufSize) : -1;
+}
+
+void CFile::Flush()
+{
+  if (m_pFile)
+    m_pFile->Flush();
+}
+
+int64_t CFile::Seek(int64_t iFilePosition, int iWhence)
+{
+  return m_pFile ? m_pFile->Seek(iFilePosition, iWhence) : -1;
+}
+
+int64_t CFile::GetLength()
+{
+  return m_pFile ? m_pFile->GetLength() : 0;
+}
+
+void CFile::Close()
+{
+  m_pFile.reset();
+}
+
+bool CFile::Exists(const std::string& strFileName, bool bUseCache)
+{
+  return CHostFile().Exists(CURL(strFileName));
+}
+
+int CFile::Stat(const std::string& strFileName, struct __stat64* buffer)
+{
+  return CHostFile().Stat(CURL(strFileName), buffer);
+}
+
+bool CFile::Delete(const std::string& strFileName)
+{
+  return remove(CSpecialProtocol::TranslatePath(strFileName).c_str()) == 0;
+}
@@ -0,0 +1,79 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+// The parts of CFileItem and of the stack:// and multipath:// directories that URL and URIUtils
+// use. The synthetic library has neither kind of path, the host build lists no directories.
+
+#include "FileItem.h"
+#include "URL.h"
+#include "filesystem/IDirectory.h"
+#include "filesystem/MultiPathDirectory.h"
+#include "filesystem/StackDirectory.h"
+
+using namespace XFILE;
+
+void CFileItem::ResetExtensionCache()
+{
+  for (std::atomic<uint32_t>& cache : m_extensionCache)
+    cache.store(0, std::memory_order_relaxed);
+}
+
+const std::string& CFileItem::GetDynPath() const
+{
+  if (!m_strDynPath.empty())
+    return m_strDynPath;
+  else
+    return m_strPath;
+}
+
+IDirectory::IDirectory()
+{
+  m_flags = DIR_FLAG_DEFAULTS;
+}
+
+IDirectory::~IDirectory(void) = default;
+
+bool IDirectory::IsAllowed(const CURL& url) const
+{
+  return true;
+}
+
+CStackDirectory::CStackDirectory() = default;
+
+CStackDirectory::~CStackDirectory() = default;
+
+bool CStackDirectory::GetDirectory(const CURL& url, CFileItemList& items)
+{
+  return false;
+}
+
+std::string CStackDirectory::GetFirstStackedFile(const std::string& strPath)
+{
+  return "";
+}
+
+bool CStackDirectory::GetPaths(const std::string& strPath, std::vector<std::string>& vecPaths)
+{
+  return false;
+}
+
+bool CStackDirectory::ConstructStackPath(const std::vector<std::string>& paths,
+                                         std::string& stackedPath)
+{
+  return false;
+}
+
+std::string CMultiPathDirectory::GetFirstPath(const std::string& strPath)
+{
+  return "";
+}
+
+bool CMultiPathDirectory::GetPaths(const std::string& path, std::vector<std::string>& paths)
+{
+  return false;
+}
@@ -0,0 +1,42 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+// URL and URIUtils only construct a CFileItemList to list a stack:// path, which stays empty in
+// the host build (see FileItem.cpp). Its real constructor needs the vtables of the list items and
+// with them the GUI, so this declares just the members they call. It must not include FileItem.h.
+
+#include <memory>
+
+class CFileItem;
+
+class CFileItemList
+{
+public:
+  CFileItemList();
+  ~CFileItemList();
+  std::shared_ptr<CFileItem> operator[](int iItem);
+  int Size() const;
+};
+
+CFileItemList::CFileItemList()
+{
+}
+
+CFileItemList::~CFileItemList()
+{
+}
+
+std::shared_ptr<CFileItem> CFileItemList::operator[](int iItem)
+{
+  return nullptr;
+}
+
+int CFileItemList::Size() const
+{
+  return 0;
+}
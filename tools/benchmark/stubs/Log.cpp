@@ -0,0 +1,58 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+// CLog of the host build: every line goes to stderr, there is no log file.
+
+#include "utils/log.h"
+
+#include <cstdio>
+#include <mutex>
+
+static const char* const levelNames[] =
+{"DEBUG", "INFO", "NOTICE", "WARNING", "ERROR", "SEVERE", "FATAL", "NONE"};
+
+namespace
+{
+std::mutex g_logMutex;
+int g_logLevel = LOG_LEVEL_DEBUG;
+} // namespace
+
+void CLog::SetLogLevel(int level)
+{
+  g_logLevel = level;
+}
+
+int CLog::GetLogLevel()
+{
+  return g_logLevel;
+}
+
+bool CLog::IsLogLevelLogged(int loglevel)
+{
+  if (g_logLevel >= LOG_LEVEL_DEBUG)
+    return true;
+  if (g_logLevel <= LOG_LEVEL_NONE)
+    return false;
+
+  return (loglevel & LOGMASK) >= LOGNOTICE;
+}
+
+void CLog::LogString(int logLevel, std::string&& logString)
+{
+  StringUtils::TrimRight(logString);
+  if (logString.empty())
+    return;
+
+  std::unique_lock<std::mutex> lock(g_logMutex);
+  fprintf(stderr, "%7s: %s\n", levelNames[logLevel & LOGMASK], logString.c_str());
+}
+
+void CLog::LogString(int logLevel, int component, std::string&& logString)
+{
+  LogString(logLevel, std::move(logString));
+}
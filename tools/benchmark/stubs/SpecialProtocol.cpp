@@ -0,0 +1,65 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+// CSpecialProtocol of the host build: only the paths set by main.cpp, without profiles, skins or
+// settings.
+
+#include "filesystem/SpecialProtocol.h"
+
+#include "URL.h"
+#include "utils/URIUtils.h"
+#include "utils/log.h"
+
+std::map<std::string, std::string> CSpecialProtocol::m_pathMap;
+
+void CSpecialProtocol::SetProfilePath(const std::string& dir)
+{
+  SetPath("profile", dir);
+  CLog::Log(LOGINFO, "special://profile/ is mapped to: {}", GetPath("profile"));
+}
+
+void CSpecialProtocol::SetTempPath(const std::string& dir)
+{
+  SetPath("temp", dir);
+}
+
+std::string CSpecialProtocol::TranslatePath(const std::string& path)
+{
+  return TranslatePath(CURL(path));
+}
+
+std::string CSpecialProtocol::TranslatePath(const CURL& url)
+{
+  if (!url.IsProtocol("special"))
+    return url.Get();
+
+  const std::string& fullFileName = url.GetFileName();
+  const size_t pos = fullFileName.find('/');
+  const std::string rootDir = fullFileName.substr(0, pos);
+  const std::string basePath = GetPath(rootDir);
+  if (basePath.empty())
+  {
+    CLog::Log(LOGERROR, "CSpecialProtocol: special://{}/ is not mapped", rootDir);
+    return "";
+  }
+
+  return pos == std::string::npos
+             ? basePath
+             : URIUtils::AddFileToFolder(basePath, fullFileName.substr(pos + 1));
+}
+
+void CSpecialProtocol::SetPath(const std::string& key, const std::string& path)
+{
+  m_pathMap[key] = path;
+}
+
+std::string CSpecialProtocol::GetPath(const std::string& key)
+{
+  const auto it = m_pathMap.find(key);
+  return it != m_pathMap.end() ? it->second : "";
+}
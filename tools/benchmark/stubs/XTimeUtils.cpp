@@ -0,0 +1,125 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+// KODI::TIME of the host build. Local time is UTC, so that dates come out the same on every
+// build machine.
+
+#include "utils/XTimeUtils.h"
+
+#include <time.h>
+
+namespace
+{
+// 100 ns intervals from 1601-01-01, the epoch of file times, to 1970-01-01
+constexpr int64_t FILETIME_UNIX_EPOCH = 116444736000000000LL;
+constexpr int64_t FILETIME_PER_SECOND = 10000000LL;
+constexpr int64_t FILETIME_PER_MILLISECOND = 10000LL;
+
+int64_t ToInt(const KODI::TIME::FileTime& fileTime)
+{
+  return static_cast<int64_t>((static_cast<uint64_t>(fileTime.highDateTime) << 32) |
+                              fileTime.lowDateTime);
+}
+
+void FromInt(int64_t time, KODI::TIME::FileTime& fileTime)
+{
+  fileTime.lowDateTime = static_cast<uint32_t>(time);
+  fileTime.highDateTime = static_cast<uint32_t>(static_cast<uint64_t>(time) >> 32);
+}
+} // namespace
+
+namespace KODI
+{
+namespace TIME
+{
+uint32_t GetTimeZoneInformation(TimeZoneInformation* timeZoneInformation)
+{
+  if (!timeZoneInformation)
+    return KODI_TIME_ZONE_ID_INVALID;
+
+  *timeZoneInformation = {};
+  timeZoneInformation->standardName = "UTC";
+  timeZoneInformation->daylightName = "UTC";
+  return KODI_TIME_ZONE_ID_UNKNOWN;
+}
+
+void GetLocalTime(SystemTime* systemTime)
+{
+  timespec now;
+  clock_gettime(CLOCK_REALTIME, &now);
+
+  FileTime fileTime;
+  FromInt(FILETIME_UNIX_EPOCH + now.tv_sec * FILETIME_PER_SECOND + now.tv_nsec / 100, fileTime);
+  FileTimeToSystemTime(&fileTime, systemTime);
+}
+
+int FileTimeToLocalFileTime(const FileTime* fileTime, FileTime* localFileTime)
+{
+  *localFileTime = *fileTime;
+  return 1;
+}
+
+int SystemTimeToFileTime(const SystemTime* systemTime, FileTime* fileTime)
+{
+  if (systemTime->year < 1601 || systemTime->month < 1 || systemTime->month > 12 ||
+      systemTime->day < 1 || systemTime->day > 31 || systemTime->hour > 23 ||
+      systemTime->minute > 59 || systemTime->second > 59 || systemTime->milliseconds > 999)
+    return 0;
+
+  tm time = {};
+  time.tm_year = systemTime->year - 1900;
+  time.tm_mon = systemTime->month - 1;
+  time.tm_mday = systemTime->day;
+  time.tm_hour = systemTime->hour;
+  time.tm_min = systemTime->minute;
+  time.tm_sec = systemTime->second;
+
+  FromInt(FILETIME_UNIX_EPOCH + static_cast<int64_t>(timegm(&time)) * FILETIME_PER_SECOND +
+              systemTime->milliseconds * FILETIME_PER_MILLISECOND,
+          *fileTime);
+  return 1;
+}
+
+long CompareFileTime(const FileTime* fileTime1, const FileTime* fileTime2)
+{
+  const int64_t time1 = ToInt(*fileTime1);
+  const int64_t time2 = ToInt(*fileTime2);
+  return time1 < time2 ? -1 : (time1 > time2 ? 1 : 0);
+}
+
+int FileTimeToSystemTime(const FileTime* fileTime, SystemTime* systemTime)
+{
+  const int64_t time = ToInt(*fileTime);
+  if (time < 0)
+    return 0;
+
+  const time_t seconds = static_cast<time_t>((time - FILETIME_UNIX_EPOCH) / FILETIME_PER_SECOND -
+                                             ((time - FILETIME_UNIX_EPOCH) % FILETIME_PER_SECOND < 0));
+  tm result;
+  if (!gmtime_r(&seconds, &result))
+    return 0;
+
+  systemTime->year = result.tm_year + 1900;
+  systemTime->month = result.tm_mon + 1;
+  systemTime->dayOfWeek = result.tm_wday;
+  systemTime->day = result.tm_mday;
+  systemTime->hour = result.tm_hour;
+  systemTime->minute = result.tm_min;
+  systemTime->second = result.tm_sec;
+  systemTime->milliseconds = static_cast<unsigned short>(
+      (time - FILETIME_UNIX_EPOCH - seconds * FILETIME_PER_SECOND) / FILETIME_PER_MILLISECOND);
+  return 1;
+}
+
+int LocalFileTimeToFileTime(const FileTime* localFileTime, FileTime* fileTime)
+{
+  *fileTime = *localFileTime;
+  return 1;
+}
+} // namespace TIME
+} // namespace KODI
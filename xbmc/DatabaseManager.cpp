@@ -11,9 +11,12 @@
 #include "ServiceBroker.h"
 #include "TextureDatabase.h"
 #include "addons/AddonDatabase.h"
+#include "filesystem/File.h"
 #include "music/MusicDatabase.h"
+#include "pictures/PictureDatabase.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/SettingsComponent.h"
+#include "utils/URIUtils.h"
 #include "utils/log.h"
 #include "video/VideoDatabase.h"
 #include "view/ViewDatabase.h"
@@ -48,6 +51,7 @@ void CDatabaseManager::Initialize()
   }
   { CViewDatabase db; UpdateDatabase(db); }
   { CTextureDatabase db; UpdateDatabase(db); }
+  { CPictureDatabase db; UpdateDatabase(db); }
   { CMusicDatabase db; UpdateDatabase(db, &advancedSettings->m_databaseMusic); }
   { CVideoDatabase db; UpdateDatabase(db, &advancedSettings->m_databaseVideo); }
 
@@ -65,6 +69,28 @@ bool CDatabaseManager::CanOpen(const std::string &name)
   return false; // db isn't even attempted to update yet
 }
 
+bool CDatabaseManager::UpdateSeparateDatabase(CDatabase& db,
+                                              const DatabaseSettings& settings,
+                                              bool recreate /* = false */)
+{
+  std::unique_lock<CCriticalSection> lock(m_section);
+  if (recreate)
+  {
+    db.Close();
+
+    DatabaseSettings dbSettings = settings;
+    db.InitSettings(dbSettings);
+    const std::string path = URIUtils::AddFileToFolder(
+        dbSettings.host, dbSettings.name + std::to_string(db.GetSchemaVersion()) + ".db");
+    if (dbSettings.type == "sqlite3" && XFILE::CFile::Exists(path) && !XFILE::CFile::Delete(path))
+    {
+      CLog::Log(LOGERROR, "Unable to delete database {} to recreate it", dbSettings.name);
+      return false;
+    }
+  }
+  return Update(db, settings);
+}
+
 void CDatabaseManager::UpdateDatabase(CDatabase &db, DatabaseSettings *settings)
 {
   std::string name = db.GetBaseDBName();
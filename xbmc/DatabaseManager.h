@@ -51,6 +51,21 @@ public:
 
   bool IsUpgrading() const { return m_bIsUpgrading; }
 
+  /*! \brief Create or update a database kept apart from the library, like one used for benchmarks.
+
+   The database is named by the given settings. Whether the library databases can be opened
+   doesn't depend on it.
+
+   \param db the database to update, connected to it on success.
+   \param settings the settings of the database, with the name of the database.
+   \param recreate drop the current version of the database first and create it empty, SQLite
+   only.
+   \return true if the database is up to date, false otherwise.
+   */
+  bool UpdateSeparateDatabase(CDatabase& db,
+                              const DatabaseSettings& settings,
+                              bool recreate = false);
+
 private:
   std::atomic<bool> m_bIsUpgrading;
 
@@ -9,6 +9,7 @@
 #include "FileItem.h"
 
 #include "CueDocument.h"
+#include "FileItemListDiscCache.h"
 #include "ServiceBroker.h"
 #include "URL.h"
 #include "Util.h"
@@ -37,6 +38,7 @@
 #include "utils/Archive.h"
 #include "utils/Crc32.h"
 #include "utils/FileExtensionProvider.h"
+#include "utils/FileExtensionSet.h"
 #include "utils/Mime.h"
 #include "utils/Random.h"
 #include "utils/RegExp.h"
@@ -170,6 +172,7 @@ CFileItem::CFileItem(const CURL& path, bool bIsFolder)
   m_bIsFolder = bIsFolder;
   if (m_bIsFolder && !m_strPath.empty() && !IsFileFolder())
     URIUtils::AddSlashAtEnd(m_strPath);
+  ResetExtensionCache();
   FillInMimeType(false);
 }
 
@@ -180,6 +183,7 @@ CFileItem::CFileItem(const std::string& strPath, bool bIsFolder)
   m_bIsFolder = bIsFolder;
   if (m_bIsFolder && !m_strPath.empty() && !IsFileFolder())
     URIUtils::AddSlashAtEnd(m_strPath);
+  ResetExtensionCache();
   FillInMimeType(false);
 }
 
@@ -191,6 +195,7 @@ CFileItem::CFileItem(const CMediaSource& share)
   m_strPath = share.strPath;
   if (!IsRSS()) // no slash at end for rss feeds
     URIUtils::AddSlashAtEnd(m_strPath);
+  ResetExtensionCache();
   std::string label = share.strName;
   if (!share.strStatus.empty())
     label = StringUtils::Format("{} ({})", share.strName, share.strStatus);
@@ -233,6 +238,8 @@ CFileItem& CFileItem::operator=(const CFileItem& item)
   FreeMemory();
   m_strPath = item.m_strPath;
   m_strDynPath = item.m_strDynPath;
+  for (int i = 0; i < EXTENSION_CLASS_COUNT; ++i)
+    m_extensionCache[i] = item.m_extensionCache[i].load(std::memory_order_relaxed);
   m_bIsParentFolder = item.m_bIsParentFolder;
   m_iDriveType = item.m_iDriveType;
   m_bIsShareOrDrive = item.m_bIsShareOrDrive;
@@ -322,6 +329,7 @@ void CFileItem::Initialize()
   m_bCanQueue = true;
   m_specialSort = SortSpecialNone;
   m_doContentLookup = true;
+  ResetExtensionCache();
 }
 
 void CFileItem::Reset()
@@ -412,6 +420,7 @@ void CFileItem::Archive(CArchive& ar)
     ar >> m_bIsParentFolder;
     ar >> m_bLabelPreformatted;
     ar >> m_strPath;
+    ResetExtensionCache();
     ar >> m_bIsShareOrDrive;
     ar >> m_iDriveType;
     ar >> m_dateTime;
@@ -639,7 +648,7 @@ bool CFileItem::IsVideo() const
   //! @todo If the file is a zip file, ask the game clients if any support this
   // file before assuming it is video.
 
-  return URIUtils::HasExtension(m_strPath, CServiceBroker::GetFileExtensionProvider().GetVideoExtensions());
+  return HasExtensionOfClass(EXTENSION_CLASS_VIDEO);
 }
 
 bool CFileItem::IsEPG() const
@@ -726,7 +735,7 @@ bool CFileItem::IsAudio() const
   //! @todo If the file is a zip file, ask the game clients if any support this
   // file before assuming it is audio
 
-  return URIUtils::HasExtension(m_strPath, CServiceBroker::GetFileExtensionProvider().GetMusicExtensions());
+  return HasExtensionOfClass(EXTENSION_CLASS_MUSIC);
 }
 
 bool CFileItem::IsDeleted() const
@@ -766,7 +775,7 @@ bool CFileItem::IsPicture() const
     return false;
 
   if (!m_strPath.empty())
-    return CUtil::IsPicture(m_strPath);
+    return HasExtensionOfClass(EXTENSION_CLASS_PICTURE) || URIUtils::HasExtension(m_strPath, ".tbn|.dds");
 
   return false;
 }
@@ -778,7 +787,54 @@ bool CFileItem::IsLyrics() const
 
 bool CFileItem::IsSubtitle() const
 {
-  return URIUtils::HasExtension(m_strPath, CServiceBroker::GetFileExtensionProvider().GetSubtitleExtensions());
+  return HasExtensionOfClass(EXTENSION_CLASS_SUBTITLE);
+}
+
+bool CFileItem::HasExtensionOfClass(ExtensionClass extensionClass) const
+{
+  CFileExtensionProvider::ExtensionSet set = CFileExtensionProvider::ExtensionSet::SUBTITLE;
+  switch (extensionClass)
+  {
+    case EXTENSION_CLASS_PICTURE:
+      set = CFileExtensionProvider::ExtensionSet::PICTURE;
+      break;
+    case EXTENSION_CLASS_MUSIC:
+      set = CFileExtensionProvider::ExtensionSet::MUSIC;
+      break;
+    case EXTENSION_CLASS_VIDEO:
+      set = CFileExtensionProvider::ExtensionSet::VIDEO;
+      break;
+    default:
+      break;
+  }
+
+  const CFileExtensionProvider& provider = CServiceBroker::GetFileExtensionProvider();
+  std::atomic<uint32_t>& cache = m_extensionCache[extensionClass];
+
+  // a cached result is only valid for the generation of the list it was checked against
+  const uint32_t cached = cache.load(std::memory_order_relaxed);
+  const uint32_t tag = static_cast<uint32_t>(provider.GetExtensionSetGeneration(set)) << 1;
+  if (tag != 0 && (cached & ~1u) == tag)
+    return (cached & 1u) != 0;
+
+  // fetching the set may rebuild it, so tag the result with the generation of the set used
+  unsigned int generation = 0;
+  const std::shared_ptr<const CFileExtensionSet> extensions =
+      provider.GetExtensionSet(set, &generation);
+  const bool matched = extensions && URIUtils::HasExtension(m_strPath, *extensions);
+
+  // a concurrent check of the same list stores the same result, a whole word is never torn
+  if (static_cast<uint32_t>(generation << 1) != 0)
+    cache.store(static_cast<uint32_t>(generation << 1) | (matched ? 1u : 0u),
+                std::memory_order_relaxed);
+
+  return matched;
+}
+
+void CFileItem::ResetExtensionCache()
+{
+  for (std::atomic<uint32_t>& cache : m_extensionCache)
+    cache.store(0, std::memory_order_relaxed);
 }
 
 bool CFileItem::IsCUESheet() const
@@ -1500,6 +1556,7 @@ void CFileItem::SetFromVideoInfoTag(const CVideoInfoTag &video)
     m_strPath = video.m_strFileNameAndPath;
     m_bIsFolder = false;
   }
+  ResetExtensionCache();
 
   if (m_videoInfoTag)
     *m_videoInfoTag = video;
@@ -1609,6 +1666,7 @@ void CFileItem::SetFromSong(const CSong &song)
   }
   else if (!song.strFileName.empty())
     m_strPath = song.strFileName;
+  ResetExtensionCache();
   GetMusicInfoTag()->SetSong(song);
   m_lStartOffset = song.iStartOffset;
   m_lStartPartNumber = 1;
@@ -1660,6 +1718,7 @@ std::string CFileItem::GetOpticalMediaPath() const
 void CFileItem::SetURL(const CURL& url)
 {
   m_strPath = url.Get();
+  ResetExtensionCache();
 }
 
 const CURL CFileItem::GetURL() const
@@ -2192,31 +2251,7 @@ void CFileItemList::Archive(CArchive& ar)
 
     ar << (int)(m_items.size() - i);
 
-    ar << m_ignoreURLOptions;
-
-    ar << m_fastLookup;
-
-    ar << (int)m_sortDescription.sortBy;
-    ar << (int)m_sortDescription.sortOrder;
-    ar << (int)m_sortDescription.sortAttributes;
-    ar << m_sortIgnoreFolders;
-    ar << (int)m_cacheToDisc;
-
-    ar << (int)m_sortDetails.size();
-    for (unsigned int j = 0; j < m_sortDetails.size(); ++j)
-    {
-      const GUIViewSortDetails &details = m_sortDetails[j];
-      ar << (int)details.m_sortDescription.sortBy;
-      ar << (int)details.m_sortDescription.sortOrder;
-      ar << (int)details.m_sortDescription.sortAttributes;
-      ar << details.m_buttonLabel;
-      ar << details.m_labelMasks.m_strLabelFile;
-      ar << details.m_labelMasks.m_strLabelFolder;
-      ar << details.m_labelMasks.m_strLabel2File;
-      ar << details.m_labelMasks.m_strLabel2Folder;
-    }
-
-    ar << m_content;
+    StoreProperties(ar);
 
     for (; i < (int)m_items.size(); ++i)
     {
@@ -2254,42 +2289,8 @@ void CFileItemList::Archive(CArchive& ar)
       m_items.reserve(iSize);
 
     bool ignoreURLOptions = false;
-    ar >> ignoreURLOptions;
-
     bool fastLookup = false;
-    ar >> fastLookup;
-
-    int tempint;
-    ar >> tempint;
-    m_sortDescription.sortBy = (SortBy)tempint;
-    ar >> tempint;
-    m_sortDescription.sortOrder = (SortOrder)tempint;
-    ar >> tempint;
-    m_sortDescription.sortAttributes = (SortAttribute)tempint;
-    ar >> m_sortIgnoreFolders;
-    ar >> tempint;
-    m_cacheToDisc = CACHE_TYPE(tempint);
-
-    unsigned int detailSize = 0;
-    ar >> detailSize;
-    for (unsigned int j = 0; j < detailSize; ++j)
-    {
-      GUIViewSortDetails details;
-      ar >> tempint;
-      details.m_sortDescription.sortBy = (SortBy)tempint;
-      ar >> tempint;
-      details.m_sortDescription.sortOrder = (SortOrder)tempint;
-      ar >> tempint;
-      details.m_sortDescription.sortAttributes = (SortAttribute)tempint;
-      ar >> details.m_buttonLabel;
-      ar >> details.m_labelMasks.m_strLabelFile;
-      ar >> details.m_labelMasks.m_strLabelFolder;
-      ar >> details.m_labelMasks.m_strLabel2File;
-      ar >> details.m_labelMasks.m_strLabel2Folder;
-      m_sortDetails.push_back(details);
-    }
-
-    ar >> m_content;
+    LoadProperties(ar, ignoreURLOptions, fastLookup);
 
     for (int i = 0; i < iSize; ++i)
     {
@@ -2303,6 +2304,74 @@ void CFileItemList::Archive(CArchive& ar)
   }
 }
 
+void CFileItemList::StoreProperties(CArchive& ar)
+{
+  ar << m_ignoreURLOptions;
+
+  ar << m_fastLookup;
+
+  ar << (int)m_sortDescription.sortBy;
+  ar << (int)m_sortDescription.sortOrder;
+  ar << (int)m_sortDescription.sortAttributes;
+  ar << m_sortIgnoreFolders;
+  ar << (int)m_cacheToDisc;
+
+  ar << (int)m_sortDetails.size();
+  for (unsigned int j = 0; j < m_sortDetails.size(); ++j)
+  {
+    const GUIViewSortDetails &details = m_sortDetails[j];
+    ar << (int)details.m_sortDescription.sortBy;
+    ar << (int)details.m_sortDescription.sortOrder;
+    ar << (int)details.m_sortDescription.sortAttributes;
+    ar << details.m_buttonLabel;
+    ar << details.m_labelMasks.m_strLabelFile;
+    ar << details.m_labelMasks.m_strLabelFolder;
+    ar << details.m_labelMasks.m_strLabel2File;
+    ar << details.m_labelMasks.m_strLabel2Folder;
+  }
+
+  ar << m_content;
+}
+
+void CFileItemList::LoadProperties(CArchive& ar, bool& ignoreURLOptions, bool& fastLookup)
+{
+  ar >> ignoreURLOptions;
+
+  ar >> fastLookup;
+
+  int tempint;
+  ar >> tempint;
+  m_sortDescription.sortBy = (SortBy)tempint;
+  ar >> tempint;
+  m_sortDescription.sortOrder = (SortOrder)tempint;
+  ar >> tempint;
+  m_sortDescription.sortAttributes = (SortAttribute)tempint;
+  ar >> m_sortIgnoreFolders;
+  ar >> tempint;
+  m_cacheToDisc = CACHE_TYPE(tempint);
+
+  unsigned int detailSize = 0;
+  ar >> detailSize;
+  for (unsigned int j = 0; j < detailSize; ++j)
+  {
+    GUIViewSortDetails details;
+    ar >> tempint;
+    details.m_sortDescription.sortBy = (SortBy)tempint;
+    ar >> tempint;
+    details.m_sortDescription.sortOrder = (SortOrder)tempint;
+    ar >> tempint;
+    details.m_sortDescription.sortAttributes = (SortAttribute)tempint;
+    ar >> details.m_buttonLabel;
+    ar >> details.m_labelMasks.m_strLabelFile;
+    ar >> details.m_labelMasks.m_strLabelFolder;
+    ar >> details.m_labelMasks.m_strLabel2File;
+    ar >> details.m_labelMasks.m_strLabel2Folder;
+    m_sortDetails.push_back(details);
+  }
+
+  ar >> m_content;
+}
+
 void CFileItemList::FillInDefaultIcons()
 {
   std::unique_lock<CCriticalSection> lock(m_lock);
@@ -2770,28 +2839,14 @@ void CFileItemList::StackFiles()
 
 bool CFileItemList::Load(int windowID)
 {
-  CFile file;
-  auto path = GetDiscFileCache(windowID);
-  try
-  {
-    if (file.Open(path))
-    {
-      CArchive ar(&file, CArchive::load);
-      ar >> *this;
-      CLog::Log(LOGDEBUG, "Loading items: {}, directory: {} sort method: {}, ascending: {}", Size(),
-                CURL::GetRedacted(GetPath()), static_cast<int>(m_sortDescription.sortBy),
-                m_sortDescription.sortOrder == SortOrderAscending ? "true" : "false");
-      ar.Close();
-      file.Close();
-      return true;
-    }
-  }
-  catch(const std::out_of_range&)
-  {
-    CLog::Log(LOGERROR, "Corrupt archive: {}", CURL::GetRedacted(path));
-  }
+  CFileItemListDiscCache cache;
+  if (!cache.Open(GetDiscFileCache(windowID)) || !cache.LoadList(*this))
+    return false;
 
-  return false;
+  CLog::Log(LOGDEBUG, "Loading items: {}, directory: {} sort method: {}, ascending: {}", Size(),
+            CURL::GetRedacted(GetPath()), static_cast<int>(m_sortDescription.sortBy),
+            m_sortDescription.sortOrder == SortOrderAscending ? "true" : "false");
+  return true;
 }
 
 bool CFileItemList::Save(int windowID)
@@ -2802,29 +2857,24 @@ bool CFileItemList::Save(int windowID)
 
   CLog::Log(LOGDEBUG, "Saving fileitems [{}]", CURL::GetRedacted(GetPath()));
 
-  CFile file;
-  std::string cachefile = GetDiscFileCache(windowID);
-  if (file.OpenForWrite(cachefile, true)) // overwrite always
-  {
-    // Before caching save simplified cache file name in every item so the cache file can be
-    // identifed and removed if the item is updated. List path and options (used for file
-    // name when list cached) can not be accurately derived from item path.
-    StringUtils::Replace(cachefile, "special://temp/archive_cache/", "");
-    StringUtils::Replace(cachefile, ".fi", "");
-    for (const auto& item : m_items)
-      item->SetProperty("cachefilename", cachefile);
-
-    CArchive ar(&file, CArchive::store);
-    ar << *this;
-    CLog::Log(LOGDEBUG, "  -- items: {}, sort method: {}, ascending: {}", iSize,
-              static_cast<int>(m_sortDescription.sortBy),
-              m_sortDescription.sortOrder == SortOrderAscending ? "true" : "false");
-    ar.Close();
-    file.Close();
-    return true;
-  }
+  const std::string cachefile = GetDiscFileCache(windowID);
 
-  return false;
+  // Before caching save simplified cache file name in every item so the cache file can be
+  // identifed and removed if the item is updated. List path and options (used for file
+  // name when list cached) can not be accurately derived from item path.
+  std::string cachename = cachefile;
+  StringUtils::Replace(cachename, "special://temp/archive_cache/", "");
+  StringUtils::Replace(cachename, ".fi", "");
+  for (const auto& item : m_items)
+    item->SetProperty("cachefilename", cachename);
+
+  if (!CFileItemListDiscCache::Save(*this, cachefile))
+    return false;
+
+  CLog::Log(LOGDEBUG, "  -- items: {}, sort method: {}, ascending: {}", iSize,
+            static_cast<int>(m_sortDescription.sortBy),
+            m_sortDescription.sortOrder == SortOrderAscending ? "true" : "false");
+  return true;
 }
 
 void CFileItemList::RemoveDiscCache(int windowID) const
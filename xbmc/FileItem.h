@@ -22,6 +22,7 @@
 #include "utils/ISortable.h"
 #include "utils/SortUtils.h"
 
+#include <atomic>
 #include <map>
 #include <memory>
 #include <string>
@@ -107,7 +108,11 @@ public:
   void SetURL(const CURL& url);
   bool IsURL(const CURL& url) const;
   const std::string& GetPath() const { return m_strPath; }
-  void SetPath(const std::string& path) { m_strPath = path; }
+  void SetPath(const std::string& path)
+  {
+    m_strPath = path;
+    ResetExtensionCache();
+  }
   bool IsPath(const std::string& path, bool ignoreURLOptions = false) const;
 
   const CURL GetDynURL() const;
@@ -574,6 +579,24 @@ private:
    */
   void Initialize();
 
+  enum ExtensionClass
+  {
+    EXTENSION_CLASS_PICTURE,
+    EXTENSION_CLASS_MUSIC,
+    EXTENSION_CLASS_VIDEO,
+    EXTENSION_CLASS_SUBTITLE,
+    EXTENSION_CLASS_COUNT
+  };
+
+  /*! \brief check m_strPath against the extension list of the given class.
+   The result is cached until the path changes or CFileExtensionProvider rebuilds the list of the
+   class, as the IsVideo/IsAudio/IsPicture predicates are called repeatedly for every item of a
+   listing. Items are shared between threads, so the cache of each class is a single atomic word
+   holding the generation of the list and the result.
+   */
+  bool HasExtensionOfClass(ExtensionClass extensionClass) const;
+  void ResetExtensionCache();
+
   /*!
    \brief Return the current resume point for this item.
    \return The resume point.
@@ -599,6 +622,9 @@ private:
   int64_t m_lEndOffset;
 
   CCueDocumentPtr m_cueDocument;
+
+  ///< per ExtensionClass the list generation shifted left by one, the lowest bit set on a match
+  mutable std::atomic<uint32_t> m_extensionCache[EXTENSION_CLASS_COUNT] = {};
 };
 
 /*!
@@ -738,6 +764,11 @@ public:
    */
   void RemoveDiscCache(int windowID = 0) const;
   void RemoveDiscCache(const std::string& cachefile) const;
+  /*! \brief path of the disc cache file of this list
+   \param windowID id of the window the list is cached for (defaults to 0)
+   \sa Save,Load,CFileItemListDiscCache
+   */
+  std::string GetDiscFileCache(int windowID = 0) const;
   void RemoveDiscCacheCRC(const std::string& crc) const;
   bool AlwaysCache() const;
 
@@ -780,9 +811,16 @@ public:
   std::reverse_iterator<VECFILEITEMS::const_iterator> rend() const { return m_items.rend(); }
 
 private:
+  friend class CFileItemListDiscCache;
+
+  /*! \brief archive the list properties (sort state, content, ...) but not the items
+   \sa Archive, CFileItemListDiscCache
+   */
+  void StoreProperties(CArchive& ar);
+  void LoadProperties(CArchive& ar, bool& ignoreURLOptions, bool& fastLookup);
+
   void Sort(FILEITEMLISTCOMPARISONFUNC func);
   void FillSortFields(FILEITEMFILLFUNC func);
-  std::string GetDiscFileCache(int windowID) const;
 
   /*!
    \brief stack files in a CFileItemList
@@ -0,0 +1,264 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FileItemListDiscCache.h"
+
+#include "FileItem.h"
+#include "URL.h"
+#include "filesystem/File.h"
+#include "utils/Archive.h"
+#include "utils/log.h"
+
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+
+using namespace XFILE;
+
+namespace
+{
+constexpr uint32_t DISC_CACHE_MAGIC = 0x4349464B; // "KFIC"
+constexpr uint32_t DISC_CACHE_VERSION = 1;
+
+struct DiscCacheHeader
+{
+  uint32_t magic;
+  uint32_t version;
+  uint32_t itemCount;
+  uint32_t propertiesSize;
+  uint32_t pathPoolSize;
+  uint32_t itemsSize;
+};
+} // namespace
+
+bool CFileItemListDiscCache::Save(CFileItemList& items, const std::string& cacheFile)
+{
+  std::vector<uint8_t> properties;
+  std::vector<IndexEntry> index;
+  std::string pathPool;
+  std::vector<uint8_t> data;
+
+  {
+    std::unique_lock<CCriticalSection> lock(items.m_lock);
+
+    CArchive propertiesArchive(properties, CArchive::store);
+    items.CFileItem::Archive(propertiesArchive);
+    items.StoreProperties(propertiesArchive);
+    propertiesArchive.Close();
+
+    size_t i = 0;
+    if (!items.m_items.empty() && items.m_items[0]->IsParentFolder())
+      i = 1;
+
+    index.reserve(items.m_items.size() - i);
+    CArchive itemsArchive(data, CArchive::store);
+    for (; i < items.m_items.size(); ++i)
+    {
+      CFileItem& item = *items.m_items[i];
+
+      IndexEntry entry;
+      entry.offset = static_cast<uint32_t>(data.size());
+      itemsArchive << item;
+      itemsArchive.Close(); // flush, so the size of data is the end of this item
+      entry.size = static_cast<uint32_t>(data.size() - entry.offset);
+      entry.pathOffset = static_cast<uint32_t>(pathPool.size());
+      entry.pathLength = static_cast<uint32_t>(item.GetPath().size());
+      pathPool += item.GetPath();
+      index.push_back(entry);
+    }
+  }
+
+  DiscCacheHeader header;
+  header.magic = DISC_CACHE_MAGIC;
+  header.version = DISC_CACHE_VERSION;
+  header.itemCount = static_cast<uint32_t>(index.size());
+  header.propertiesSize = static_cast<uint32_t>(properties.size());
+  header.pathPoolSize = static_cast<uint32_t>(pathPool.size());
+  header.itemsSize = static_cast<uint32_t>(data.size());
+
+  CFile file;
+  if (!file.OpenForWrite(cacheFile, true)) // overwrite always
+    return false;
+
+  const auto write = [&file](const void* data, size_t size) {
+    return size == 0 || file.Write(data, size) == static_cast<ssize_t>(size);
+  };
+  bool success = write(&header, sizeof(header));
+  success = success && write(properties.data(), properties.size());
+  success = success && write(index.data(), index.size() * sizeof(IndexEntry));
+  success = success && write(pathPool.data(), pathPool.size());
+  success = success && write(data.data(), data.size());
+  file.Close();
+
+  if (!success)
+  {
+    CLog::Log(LOGERROR, "{}: Error writing {}", __FUNCTION__, CURL::GetRedacted(cacheFile));
+    CFile::Delete(cacheFile);
+  }
+  return success;
+}
+
+bool CFileItemListDiscCache::Open(const std::string& cacheFile)
+{
+  Close();
+
+  CFile file;
+  if (file.LoadFile(cacheFile, m_data) <= 0)
+  {
+    m_data.clear();
+    return false;
+  }
+  m_cacheFile = cacheFile;
+
+  DiscCacheHeader header;
+  if (m_data.size() < sizeof(header))
+  {
+    CLog::Log(LOGERROR, "Corrupt archive: {}", CURL::GetRedacted(cacheFile));
+    Close();
+    return false;
+  }
+  memcpy(&header, m_data.data(), sizeof(header));
+
+  if (header.magic != DISC_CACHE_MAGIC || header.version != DISC_CACHE_VERSION)
+  {
+    // written by an older version, will be replaced on the next save
+    CLog::Log(LOGDEBUG, "Ignoring outdated archive: {}", CURL::GetRedacted(cacheFile));
+    Close();
+    return false;
+  }
+
+  const uint64_t indexSize = static_cast<uint64_t>(header.itemCount) * sizeof(IndexEntry);
+  const uint64_t expectedSize = sizeof(header) + static_cast<uint64_t>(header.propertiesSize) +
+                                indexSize + header.pathPoolSize + header.itemsSize;
+  if (expectedSize != m_data.size())
+  {
+    CLog::Log(LOGERROR, "Corrupt archive: {}", CURL::GetRedacted(cacheFile));
+    Close();
+    return false;
+  }
+
+  const uint8_t* pos = m_data.data() + sizeof(header);
+  m_properties = pos;
+  m_propertiesSize = header.propertiesSize;
+  pos += header.propertiesSize;
+
+  // copy the index out of the file data as it isn't necessarily aligned
+  m_index.resize(header.itemCount);
+  memcpy(m_index.data(), pos, indexSize);
+  pos += indexSize;
+
+  m_pathPool = reinterpret_cast<const char*>(pos);
+  pos += header.pathPoolSize;
+  m_items = pos;
+
+  m_pathIndex.reserve(m_index.size());
+  for (size_t i = 0; i < m_index.size(); ++i)
+  {
+    const IndexEntry& entry = m_index[i];
+    if (static_cast<uint64_t>(entry.offset) + entry.size > header.itemsSize ||
+        static_cast<uint64_t>(entry.pathOffset) + entry.pathLength > header.pathPoolSize)
+    {
+      CLog::Log(LOGERROR, "Corrupt archive: {}", CURL::GetRedacted(cacheFile));
+      Close();
+      return false;
+    }
+    m_pathIndex.emplace(std::string_view(m_pathPool + entry.pathOffset, entry.pathLength),
+                        static_cast<int>(i));
+  }
+
+  return true;
+}
+
+void CFileItemListDiscCache::Close()
+{
+  m_pathIndex.clear();
+  m_index.clear();
+  m_data.clear();
+  m_properties = nullptr;
+  m_propertiesSize = 0;
+  m_pathPool = nullptr;
+  m_items = nullptr;
+  m_cacheFile.clear();
+}
+
+CFileItemPtr CFileItemListDiscCache::Get(int index) const
+{
+  if (index < 0 || index >= Size())
+    return CFileItemPtr();
+
+  const IndexEntry& entry = m_index[index];
+  CFileItemPtr item(new CFileItem);
+  try
+  {
+    CArchive ar(m_items + entry.offset, entry.size);
+    ar >> *item;
+  }
+  catch (const std::out_of_range&)
+  {
+    CLog::Log(LOGERROR, "Corrupt archive: {}", CURL::GetRedacted(m_cacheFile));
+    return CFileItemPtr();
+  }
+
+  return item;
+}
+
+CFileItemPtr CFileItemListDiscCache::Get(const std::string& path) const
+{
+  const auto it = m_pathIndex.find(path);
+  if (it == m_pathIndex.end())
+    return CFileItemPtr();
+
+  return Get(it->second);
+}
+
+bool CFileItemListDiscCache::LoadList(CFileItemList& items) const
+{
+  if (!IsOpen())
+    return false;
+
+  try
+  {
+    CFileItemPtr pParent;
+    if (!items.IsEmpty() && items.Get(0)->IsParentFolder())
+      pParent.reset(new CFileItem(*items.Get(0)));
+
+    items.SetIgnoreURLOptions(false);
+    items.SetFastLookup(false);
+    items.Clear();
+
+    CArchive ar(m_properties, m_propertiesSize);
+    items.CFileItem::Archive(ar);
+
+    bool ignoreURLOptions = false;
+    bool fastLookup = false;
+    items.LoadProperties(ar, ignoreURLOptions, fastLookup);
+
+    items.Reserve(m_index.size() + (pParent ? 1 : 0));
+    if (pParent)
+      items.Add(pParent);
+
+    for (int i = 0; i < Size(); ++i)
+    {
+      CFileItemPtr pItem(new CFileItem);
+      CArchive itemArchive(m_items + m_index[i].offset, m_index[i].size);
+      itemArchive >> *pItem;
+      items.Add(pItem);
+    }
+
+    items.SetIgnoreURLOptions(ignoreURLOptions);
+    items.SetFastLookup(fastLookup);
+  }
+  catch (const std::out_of_range&)
+  {
+    CLog::Log(LOGERROR, "Corrupt archive: {}", CURL::GetRedacted(m_cacheFile));
+    items.Clear();
+    return false;
+  }
+
+  return true;
+}
@@ -0,0 +1,76 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+class CFileItem; typedef std::shared_ptr<CFileItem> CFileItemPtr;
+class CFileItemList;
+
+/*!
+ \brief Disc cache of a CFileItemList, as written by CFileItemList::Save.
+
+ The cache file is read with a single read. It starts with a versioned header followed by
+ the archived list properties, an index holding offset, size and path of every item, a pool
+ with the item paths and the archived items. Items are only deserialized when requested, so
+ callers that look up a few items by path (like the info loaders) don't pay for the whole list.
+ */
+class CFileItemListDiscCache
+{
+public:
+  /*! \brief write the list and its items to the given cache file
+   \return true if successful, false otherwise.
+   */
+  static bool Save(CFileItemList& items, const std::string& cacheFile);
+
+  /*! \brief read the given cache file and validate its header and index
+   \return false if the file doesn't exist, is of an older version or is corrupt.
+   */
+  bool Open(const std::string& cacheFile);
+  void Close();
+  bool IsOpen() const { return !m_data.empty(); }
+
+  /*! \brief number of cached items, not counting a parent folder item
+   */
+  int Size() const { return static_cast<int>(m_index.size()); }
+
+  /*! \brief deserialize a single item
+   \return the item, or an empty pointer if out of range or corrupt.
+   */
+  CFileItemPtr Get(int index) const;
+  CFileItemPtr Get(const std::string& path) const;
+
+  /*! \brief deserialize the list properties and all items into items
+   Like CFileItemList::Archive a parent folder item already in items is kept.
+   */
+  bool LoadList(CFileItemList& items) const;
+
+private:
+  struct IndexEntry
+  {
+    uint32_t offset;
+    uint32_t size;
+    uint32_t pathOffset;
+    uint32_t pathLength;
+  };
+
+  std::string m_cacheFile;
+  std::vector<uint8_t> m_data;
+  const uint8_t* m_properties = nullptr;
+  size_t m_propertiesSize = 0;
+  const char* m_pathPool = nullptr;
+  const uint8_t* m_items = nullptr;
+  std::vector<IndexEntry> m_index;
+  std::unordered_map<std::string_view, int> m_pathIndex; ///< views into m_pathPool
+};
@@ -45,6 +45,8 @@ CPartyModeManager::CPartyModeManager(void)
   ClearState();
 }
 
+CPartyModeManager::~CPartyModeManager() = default;
+
 bool CPartyModeManager::Enable(PartyModeContext context /*= PARTYMODECONTEXT_MUSIC*/, const std::string& strXspPath /*= ""*/)
 {
   // Filter using our PartyMode xml file
@@ -91,28 +93,28 @@ bool CPartyModeManager::Enable(PartyModeContext context /*= PARTYMODECONTEXT_MUS
   pDialog->Open();
 
   ClearState();
-  std::string strCurrentFilterMusic;
-  std::string strCurrentFilterVideo;
-  unsigned int songcount = 0;
-  unsigned int videocount = 0;
   auto start = std::chrono::steady_clock::now();
 
   if (StringUtils::EqualsNoCase(m_type, "songs") ||
       StringUtils::EqualsNoCase(m_type, "mixed"))
   {
-    CMusicDatabase db;
+    // kept open while party mode is enabled, it remembers the songs picked
+    m_musicDatabase = std::make_unique<CMusicDatabase>();
+    CMusicDatabase& db = *m_musicDatabase;
     if (db.Open())
     {
       std::set<std::string> playlists;
       if (playlistLoaded)
       {
         playlist.SetType("songs");
-        strCurrentFilterMusic = playlist.GetWhereClause(db, playlists);
+        m_strCurrentFilterMusic = playlist.GetWhereClause(db, playlists);
       }
 
-      CLog::Log(LOGINFO, "PARTY MODE MANAGER: Registering filter:[{}]", strCurrentFilterMusic);
-      songcount = db.GetRandomSongIDs(CDatabase::Filter(strCurrentFilterMusic), m_songIDCache);
-      m_iMatchingSongs = static_cast<int>(songcount);
+      CLog::Log(LOGINFO, "PARTY MODE MANAGER: Registering filter:[{}]", m_strCurrentFilterMusic);
+      // only counted, songs are picked as the queue needs them
+      std::vector<std::pair<int, int>> songIDs;
+      m_iMatchingSongs = static_cast<int>(
+          db.GetRandomSongIDs(CDatabase::Filter(m_strCurrentFilterMusic), 0, songIDs));
       if (m_iMatchingSongs < 1 && StringUtils::EqualsNoCase(m_type, "songs"))
       {
         pDialog->Close();
@@ -127,26 +129,26 @@ bool CPartyModeManager::Enable(PartyModeContext context /*= PARTYMODECONTEXT_MUS
       OnError(16033, "Party mode could not open database. Aborting.");
       return false;
     }
-    db.Close();
   }
 
   if (StringUtils::EqualsNoCase(m_type, "musicvideos") ||
       StringUtils::EqualsNoCase(m_type, "mixed"))
   {
-    std::vector< std::pair<int,int> > songIDs2;
-    CVideoDatabase db;
+    m_videoDatabase = std::make_unique<CVideoDatabase>();
+    CVideoDatabase& db = *m_videoDatabase;
     if (db.Open())
     {
       std::set<std::string> playlists;
       if (playlistLoaded)
       {
         playlist.SetType("musicvideos");
-        strCurrentFilterVideo = playlist.GetWhereClause(db, playlists);
+        m_strCurrentFilterVideo = playlist.GetWhereClause(db, playlists);
       }
 
-      CLog::Log(LOGINFO, "PARTY MODE MANAGER: Registering filter:[{}]", strCurrentFilterVideo);
-      videocount = db.GetRandomMusicVideoIDs(strCurrentFilterVideo, songIDs2);
-      m_iMatchingSongs += static_cast<int>(videocount);
+      CLog::Log(LOGINFO, "PARTY MODE MANAGER: Registering filter:[{}]", m_strCurrentFilterVideo);
+      std::vector<std::pair<int, int>> songIDs;
+      m_iMatchingSongs += static_cast<int>(
+          db.GetRandomMusicVideoIDs(m_strCurrentFilterVideo, 0, songIDs));
       if (m_iMatchingSongs < 1)
       {
         pDialog->Close();
@@ -161,14 +163,8 @@ bool CPartyModeManager::Enable(PartyModeContext context /*= PARTYMODECONTEXT_MUS
       OnError(16033, "Party mode could not open database. Aborting.");
       return false;
     }
-    db.Close();
-    m_songIDCache.insert(m_songIDCache.end(), songIDs2.begin(), songIDs2.end());
   }
 
-  // Songs and music videos are random from query, but need mixing together when have both
-  if (songcount > 0 && videocount > 0 )
-    KODI::UTILS::RandomShuffle(m_songIDCache.begin(), m_songIDCache.end());
-
   CLog::Log(LOGINFO,"PARTY MODE MANAGER: Matching songs = {0}", m_iMatchingSongs);
   CLog::Log(LOGINFO,"PARTY MODE MANAGER: Party mode enabled!");
 
@@ -184,6 +180,8 @@ bool CPartyModeManager::Enable(PartyModeContext context /*= PARTYMODECONTEXT_MUS
   if (!AddRandomSongs())
   {
     pDialog->Close();
+    m_musicDatabase.reset();
+    m_videoDatabase.reset();
     return false;
   }
 
@@ -214,6 +212,8 @@ void CPartyModeManager::Disable()
   if (!IsEnabled())
     return;
   m_bEnabled = false;
+  m_musicDatabase.reset();
+  m_videoDatabase.reset();
   Announce();
   CLog::Log(LOGINFO,"PARTY MODE MANAGER: Party mode disabled.");
 }
@@ -293,7 +293,7 @@ void CPartyModeManager::Process()
 bool CPartyModeManager::AddRandomSongs()
 {
   // All songs have been picked, no more to add
-  if (static_cast<int>(m_songIDCache.size()) == m_iMatchingSongsPicked)
+  if (m_iMatchingSongsPicked >= m_iMatchingSongs)
     return false;
 
   PLAYLIST::CPlayList& playlist = CServiceBroker::GetPlaylistPlayer().GetPlaylist(GetPlaylistId());
@@ -301,24 +301,28 @@ bool CPartyModeManager::AddRandomSongs()
 
   if (iMissingSongs > 0)
   {
-    // Limit songs fetched to remainder of songID cache
-    iMissingSongs = std::min(iMissingSongs, static_cast<int>(m_songIDCache.size()) - m_iMatchingSongsPicked);
+    // Limit songs fetched to the songs not picked yet
+    iMissingSongs = std::min(iMissingSongs, m_iMatchingSongs - m_iMatchingSongsPicked);
+
+    // Pick iMissingSongs from the songs not picked yet
+    std::vector<std::pair<int, int>> songIDs;
+    if (!PickRandomSongs(iMissingSongs, songIDs))
+      return false;
 
-    // Pick iMissingSongs from remaining songID cache
     std::string sqlWhereMusic = "songview.idSong IN (";
     std::string sqlWhereVideo = "idMVideo IN (";
 
     bool bSongs = false;
     bool bMusicVideos = false;
-    for (int i = m_iMatchingSongsPicked; i < m_iMatchingSongsPicked + iMissingSongs; i++)
+    for (const auto& songID : songIDs)
     {
-      std::string song = StringUtils::Format("{},", m_songIDCache[i].second);
-      if (m_songIDCache[i].first == 1)
+      std::string song = StringUtils::Format("{},", songID.second);
+      if (songID.first == 1)
       {
         sqlWhereMusic += song;
         bSongs = true;
       }
-      else if (m_songIDCache[i].first == 2)
+      else if (songID.first == 2)
       {
         sqlWhereVideo += song;
         bMusicVideos = true;
@@ -333,38 +337,18 @@ bool CPartyModeManager::AddRandomSongs()
       SortDescription SortDescription;
       SortDescription.sortBy = SortByRandom;
       SortDescription.limitEnd = QUEUE_DEPTH;
-      CMusicDatabase database;
-      if (database.Open())
-      {
-        database.GetSongsFullByWhere("musicdb://songs/", CDatabase::Filter(sqlWhereMusic),
-          items, SortDescription, true);
+      m_musicDatabase->GetSongsFullByWhere("musicdb://songs/", CDatabase::Filter(sqlWhereMusic),
+                                           items, SortDescription, true);
 
-        // Get artist and album properties for songs
-        for (auto& item : items)
-          database.SetPropertiesForFileItem(*item);
-        database.Close();
-      }
-      else
-      {
-        OnError(16033, "Party mode could not open database. Aborting.");
-        return false;
-      }
+      // Get artist and album properties for songs
+      for (auto& item : items)
+        m_musicDatabase->SetPropertiesForFileItem(*item);
     }
     if (bMusicVideos)
     {
       sqlWhereVideo.back() = ')'; // replace the last comma with closing bracket
-      CVideoDatabase database;
-      if (database.Open())
-      {
-        database.GetMusicVideosByWhere("videodb://musicvideos/titles/",
-          CDatabase::Filter(sqlWhereVideo), items);
-        database.Close();
-      }
-      else
-      {
-        OnError(16033, "Party mode could not open database. Aborting.");
-        return false;
-      }
+      m_videoDatabase->GetMusicVideosByWhere("videodb://musicvideos/titles/",
+                                             CDatabase::Filter(sqlWhereVideo), items);
     }
 
     // Randomize if the list has music videos or they will be in db order
@@ -373,17 +357,6 @@ bool CPartyModeManager::AddRandomSongs()
       items.Randomize();
     for (const auto& item : items)
     {
-      // Update songID cache with order items in playlist
-      if (item->HasMusicInfoTag())
-      {
-        m_songIDCache[m_iMatchingSongsPicked].first = 1;
-        m_songIDCache[m_iMatchingSongsPicked].second = item->GetMusicInfoTag()->GetDatabaseId();
-      }
-      else if (item->HasVideoInfoTag())
-      {
-        m_songIDCache[m_iMatchingSongsPicked].first = 2;
-        m_songIDCache[m_iMatchingSongsPicked].second = item->GetVideoInfoTag()->m_iDbId;
-      }
       CFileItemPtr pItem(item);
       Add(pItem); // inc m_iMatchingSongsPicked
     }
@@ -391,6 +364,43 @@ bool CPartyModeManager::AddRandomSongs()
   return true;
 }
 
+bool CPartyModeManager::PickRandomSongs(int count, std::vector<std::pair<int, int>>& songIDs)
+{
+  const bool bSongs =
+      StringUtils::EqualsNoCase(m_type, "songs") || StringUtils::EqualsNoCase(m_type, "mixed");
+  const bool bMusicVideos = StringUtils::EqualsNoCase(m_type, "musicvideos") ||
+                            StringUtils::EqualsNoCase(m_type, "mixed");
+
+  // the databases remember the songs and music videos picked, they aren't picked again
+  if ((bSongs && !m_musicDatabase) || (bMusicVideos && !m_videoDatabase))
+    return false;
+
+  const CDatabase::Filter filterMusic(m_strCurrentFilterMusic);
+  unsigned int songCount = bSongs ? count : 0;
+  if (bSongs && bMusicVideos)
+  {
+    // split the picks in proportion to the songs and music videos left, as if picking from all
+    // of them mixed together
+    std::vector<std::pair<int, int>> none;
+    const unsigned int songsLeft = m_musicDatabase->GetRandomSongIDs(filterMusic, 0, none);
+    const unsigned int musicVideosLeft =
+        m_videoDatabase->GetRandomMusicVideoIDs(m_strCurrentFilterVideo, 0, none);
+
+    songCount = 0;
+    for (unsigned int pick : KODI::UTILS::RandomSample(songsLeft + musicVideosLeft, count))
+    {
+      if (pick < songsLeft)
+        songCount++;
+    }
+  }
+
+  if (songCount > 0)
+    m_musicDatabase->GetRandomSongIDs(filterMusic, songCount, songIDs);
+  if (bMusicVideos && static_cast<unsigned int>(count) > songCount)
+    m_videoDatabase->GetRandomMusicVideoIDs(m_strCurrentFilterVideo, count - songCount, songIDs);
+  return true;
+}
+
 void CPartyModeManager::Add(CFileItemPtr &pItem)
 {
   PLAYLIST::CPlayList& playlist = CServiceBroker::GetPlaylistPlayer().GetPlaylist(GetPlaylistId());
@@ -534,7 +544,10 @@ void CPartyModeManager::ClearState()
   m_iRelaxedSongs = 0;
   m_iRandomSongs = 0;
 
-  m_songIDCache.clear();
+  m_strCurrentFilterMusic.clear();
+  m_strCurrentFilterVideo.clear();
+  m_musicDatabase.reset();
+  m_videoDatabase.reset();
 }
 
 void CPartyModeManager::UpdateStats()
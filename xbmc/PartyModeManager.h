@@ -15,6 +15,8 @@
 
 class CFileItem; typedef std::shared_ptr<CFileItem> CFileItemPtr;
 class CFileItemList;
+class CMusicDatabase;
+class CVideoDatabase;
 namespace PLAYLIST
 {
 using Id = int;
@@ -32,6 +34,7 @@ class CPartyModeManager final
 {
 public:
   CPartyModeManager(void);
+  ~CPartyModeManager();
 
   bool Enable(PartyModeContext context=PARTYMODECONTEXT_MUSIC, const std::string& strXspPath = "");
   void Disable();
@@ -51,6 +54,7 @@ public:
 private:
   void Process();
   bool AddRandomSongs();
+  bool PickRandomSongs(int count, std::vector<std::pair<int, int>>& songIDs);
   void Add(CFileItemPtr &pItem);
   bool ReapSongs();
   bool MovePlaying();
@@ -66,6 +70,8 @@ private:
   bool m_bIsVideo;
   int m_iLastUserSong;
   std::string m_type;
+  std::string m_strCurrentFilterMusic;
+  std::string m_strCurrentFilterVideo;
 
   // statistics
   int m_iSongsPlayed;
@@ -75,8 +81,9 @@ private:
   int m_iRelaxedSongs;
   int m_iRandomSongs;
 
-  // history
-  std::vector<std::pair<int, int>> m_songIDCache;
+  // open while enabled, songs and music videos picked through them aren't picked again
+  std::unique_ptr<CMusicDatabase> m_musicDatabase;
+  std::unique_ptr<CVideoDatabase> m_videoDatabase;
 };
 
 extern CPartyModeManager g_partyModeManager;
@@ -26,6 +26,7 @@
 #include "settings/SettingsComponent.h"
 #include "utils/Digest.h"
 #include "utils/FileExtensionProvider.h"
+#include "utils/FileExtensionSet.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 #include "utils/log.h"
@@ -239,8 +240,9 @@ void CUtil::GetQualifiedFilename(const std::string &strBasePath, std::string &st
 
 bool CUtil::IsPicture(const std::string& strFile)
 {
-  return URIUtils::HasExtension(strFile,
-                  CServiceBroker::GetFileExtensionProvider().GetPictureExtensions()+ "|.tbn|.dds");
+  return URIUtils::HasExtension(
+             strFile, *CServiceBroker::GetFileExtensionProvider().GetPictureExtensionSet()) ||
+         URIUtils::HasExtension(strFile, ".tbn|.dds");
 }
 
 std::string CUtil::GetSplashPath()
@@ -15,6 +15,7 @@
 #include "addons/addoninfo/AddonType.h"
 #include "dbwrappers/dataset.h"
 #include "filesystem/SpecialProtocol.h"
+#include "utils/Digest.h"
 #include "utils/JSONVariantParser.h"
 #include "utils/JSONVariantWriter.h"
 #include "utils/StringUtils.h"
@@ -22,10 +23,37 @@
 #include "utils/log.h"
 
 #include <algorithm>
+#include <functional>
+#include <inttypes.h>
 #include <iterator>
+#include <unordered_map>
 #include <utility>
 
 using namespace ADDON;
+using KODI::UTILITY::CDigest;
+
+// add-on rows written or deleted by one statement when updating a repository
+#define REPOSITORY_ROWS_PER_STATEMENT 100
+// size at which a statement inserting add-on rows is executed early
+#define REPOSITORY_STATEMENT_SIZE (256 * 1024)
+
+namespace
+{
+CVariant SerializeTranslations(const std::unordered_map<std::string, std::string>& texts)
+{
+  CVariant variant(CVariant::VariantTypeObject);
+  for (const auto& text : texts)
+    variant[text.first] = text.second;
+  return variant;
+}
+
+void DeserializeTranslations(const CVariant& variant,
+                             std::unordered_map<std::string, std::string>& texts)
+{
+  for (auto it = variant.begin_map(); it != variant.end_map(); ++it)
+    texts.emplace(it->first, it->second.asString());
+}
+} // namespace
 
 std::string CAddonDatabaseSerializer::SerializeMetadata(const CAddonInfo& addon)
 {
@@ -188,6 +216,149 @@ void CAddonDatabaseSerializer::DeserializeExtensions(const CVariant& variant,
   return;
 }
 
+std::string CAddonDatabaseSerializer::SerializeManifest(const CAddonInfo& addon)
+{
+  CVariant variant;
+  variant["id"] = addon.m_id;
+  variant["name"] = addon.m_name;
+  variant["version"] = addon.m_version.asString();
+  variant["minversion"] = addon.m_minversion.asString();
+  variant["binary"] = addon.m_isBinary;
+  variant["author"] = addon.m_author;
+  variant["license"] = addon.m_license;
+  variant["source"] = addon.m_source;
+  variant["website"] = addon.m_website;
+  variant["forum"] = addon.m_forum;
+  variant["email"] = addon.m_email;
+  variant["path"] = addon.m_path;
+  variant["icon"] = addon.m_icon;
+  variant["size"] = addon.m_packageSize;
+
+  variant["summary"] = SerializeTranslations(addon.m_summary);
+  variant["description"] = SerializeTranslations(addon.m_description);
+  variant["disclaimer"] = SerializeTranslations(addon.m_disclaimer);
+  variant["news"] = SerializeTranslations(addon.m_changelog);
+  variant["lifecycletype"] = static_cast<unsigned int>(addon.m_lifecycleState);
+  variant["lifecycledesc"] = SerializeTranslations(addon.m_lifecycleStateDescription);
+
+  variant["art"] = CVariant(CVariant::VariantTypeObject);
+  for (const auto& item : addon.m_art)
+    variant["art"][item.first] = item.second;
+
+  variant["screenshots"] = CVariant(CVariant::VariantTypeArray);
+  for (const auto& item : addon.m_screenshots)
+    variant["screenshots"].push_back(item);
+
+  variant["platforms"] = CVariant(CVariant::VariantTypeArray);
+  for (const auto& item : addon.m_platforms)
+    variant["platforms"].push_back(item);
+
+  variant["types"] = CVariant(CVariant::VariantTypeArray);
+  for (const auto& type : addon.m_types)
+  {
+    CVariant info = SerializeExtensions(type);
+    info["path"] = type.m_path;
+    info["libname"] = type.m_libname;
+    variant["types"].push_back(std::move(info));
+  }
+
+  variant["dependencies"] = CVariant(CVariant::VariantTypeArray);
+  for (const auto& dep : addon.m_dependencies)
+  {
+    CVariant info(CVariant::VariantTypeObject);
+    info["addonId"] = dep.id;
+    info["version"] = dep.version.asString();
+    info["minversion"] = dep.versionMin.asString();
+    info["optional"] = dep.optional;
+    variant["dependencies"].push_back(std::move(info));
+  }
+
+  variant["extrainfo"] = CVariant(CVariant::VariantTypeObject);
+  for (const auto& kv : addon.m_extrainfo)
+    variant["extrainfo"][kv.first] = kv.second;
+
+  variant["addonsettings"] = addon.m_supportsAddonSettings;
+  variant["instancesettings"] = addon.m_supportsInstanceSettings;
+
+  std::string json;
+  CJSONVariantWriter::Write(variant, json, true);
+  return json;
+}
+
+AddonInfoPtr CAddonDatabaseSerializer::DeserializeManifest(const std::string& document)
+{
+  CVariant variant;
+  if (!CJSONVariantParser::Parse(document, variant) || !variant.isObject() ||
+      variant["types"].empty())
+    return nullptr;
+
+  AddonInfoPtr addon = std::make_shared<CAddonInfo>();
+  addon->m_id = variant["id"].asString();
+  addon->m_name = variant["name"].asString();
+  addon->m_version = CAddonVersion(variant["version"].asString());
+  addon->m_minversion = CAddonVersion(variant["minversion"].asString());
+  addon->m_isBinary = variant["binary"].asBoolean();
+  addon->m_author = variant["author"].asString();
+  addon->m_license = variant["license"].asString();
+  addon->m_source = variant["source"].asString();
+  addon->m_website = variant["website"].asString();
+  addon->m_forum = variant["forum"].asString();
+  addon->m_email = variant["email"].asString();
+  addon->m_path = variant["path"].asString();
+  addon->m_profilePath = StringUtils::Format("special://profile/addon_data/{}/", addon->m_id);
+  addon->m_icon = variant["icon"].asString();
+  addon->m_packageSize = variant["size"].asUnsignedInteger();
+
+  DeserializeTranslations(variant["summary"], addon->m_summary);
+  DeserializeTranslations(variant["description"], addon->m_description);
+  DeserializeTranslations(variant["disclaimer"], addon->m_disclaimer);
+  DeserializeTranslations(variant["news"], addon->m_changelog);
+  addon->m_lifecycleState =
+      static_cast<AddonLifecycleState>(variant["lifecycletype"].asUnsignedInteger());
+  DeserializeTranslations(variant["lifecycledesc"], addon->m_lifecycleStateDescription);
+
+  for (auto it = variant["art"].begin_map(); it != variant["art"].end_map(); ++it)
+    addon->m_art.emplace(it->first, it->second.asString());
+
+  for (auto it = variant["screenshots"].begin_array(); it != variant["screenshots"].end_array(); ++it)
+    addon->m_screenshots.push_back(it->asString());
+
+  for (auto it = variant["platforms"].begin_array(); it != variant["platforms"].end_array(); ++it)
+    addon->m_platforms.push_back(it->asString());
+
+  for (auto it = variant["types"].begin_array(); it != variant["types"].end_array(); ++it)
+  {
+    CAddonType addonType;
+    DeserializeExtensions(*it, addonType);
+    addonType.m_type = CAddonInfo::TranslateType(addonType.m_point);
+    addonType.m_path = (*it)["path"].asString();
+    addonType.m_libname = (*it)["libname"].asString();
+    if (!addonType.GetValue("provides").empty())
+      addonType.SetProvides(addonType.GetValue("provides").asString());
+    addon->m_types.push_back(std::move(addonType));
+  }
+
+  for (auto it = variant["dependencies"].begin_array(); it != variant["dependencies"].end_array(); ++it)
+  {
+    addon->m_dependencies.emplace_back(
+        (*it)["addonId"].asString(), CAddonVersion((*it)["minversion"].asString()),
+        CAddonVersion((*it)["version"].asString()), (*it)["optional"].asBoolean());
+  }
+
+  for (auto it = variant["extrainfo"].begin_map(); it != variant["extrainfo"].end_map(); ++it)
+    addon->m_extrainfo.emplace(it->first, it->second.asString());
+
+  addon->m_supportsAddonSettings = variant["addonsettings"].asBoolean();
+  addon->m_supportsInstanceSettings = variant["instancesettings"].asBoolean();
+
+  // derived the same way as when addon.xml is parsed
+  addon->m_mainType = addon->m_types[0].Type();
+  addon->m_libname = addon->m_types[0].m_libname;
+  addon->m_addonInstanceSupportType = CAddonInfo::InstanceSupportType(addon->m_mainType);
+
+  return addon;
+}
+
 CAddonDatabase::CAddonDatabase() = default;
 
 CAddonDatabase::~CAddonDatabase() = default;
@@ -204,7 +375,7 @@ int CAddonDatabase::GetMinSchemaVersion() const
 
 int CAddonDatabase::GetSchemaVersion() const
 {
-  return 33;
+  return 35;
 }
 
 void CAddonDatabase::CreateTables()
@@ -218,7 +389,8 @@ void CAddonDatabase::CreateTables()
       "name TEXT NOT NULL,"
       "summary TEXT NOT NULL,"
       "news TEXT NOT NULL,"
-      "description TEXT NOT NULL)");
+      "description TEXT NOT NULL,"
+      "hash TEXT)");
 
   CLog::Log(LOGINFO, "create repo table");
   m_pDS->exec("CREATE TABLE repo (id integer primary key, addonID text,"
@@ -238,6 +410,10 @@ void CAddonDatabase::CreateTables()
   m_pDS->exec("CREATE TABLE installed (id INTEGER PRIMARY KEY, addonID TEXT UNIQUE, "
               "enabled BOOLEAN, installDate TEXT, lastUpdated TEXT, lastUsed TEXT, "
               "origin TEXT NOT NULL DEFAULT '', disabledReason INTEGER NOT NULL DEFAULT 0) \n");
+
+  CLog::Log(LOGINFO, "create manifest table");
+  m_pDS->exec("CREATE TABLE manifest (id INTEGER PRIMARY KEY, path TEXT UNIQUE, "
+              "mtime INTEGER, size INTEGER, metadata BLOB)\n");
 }
 
 void CAddonDatabase::CreateAnalytics()
@@ -380,6 +556,16 @@ void CAddonDatabase::UpdateTables(int version)
     }
     m_pDS->close();
   }
+  if (version < 34)
+  {
+    m_pDS->exec("CREATE TABLE manifest (id INTEGER PRIMARY KEY, path TEXT UNIQUE, "
+                "mtime INTEGER, size INTEGER, metadata BLOB)");
+  }
+  if (version < 35)
+  {
+    // rows without a hash are replaced by the next update of their repository
+    m_pDS->exec("ALTER TABLE addons ADD hash TEXT");
+  }
 }
 
 void CAddonDatabase::SyncInstalled(const std::set<std::string>& ids,
@@ -778,28 +964,6 @@ void CAddonDatabase::DeleteRepository(const std::string& id)
   }
 }
 
-void CAddonDatabase::DeleteRepositoryContents(const std::string& id)
-{
-  try
-  {
-    if (!m_pDB)
-      return;
-    if (!m_pDS)
-      return;
-
-    int idRepo = GetRepositoryId(id);
-    if (idRepo < 0)
-      return;
-
-    m_pDS->exec(PrepareSQL("DELETE FROM addons WHERE id IN (SELECT idAddon FROM addonlinkrepo WHERE idRepo=%i)", idRepo));
-    m_pDS->exec(PrepareSQL("DELETE FROM addonlinkrepo WHERE idRepo=%i", idRepo));
-  }
-  catch (...)
-  {
-    CLog::Log(LOGERROR, "{} failed on repo '{}'", __FUNCTION__, id);
-  }
-}
-
 int CAddonDatabase::GetRepositoryId(const std::string& addonId)
 {
   if (!m_pDB)
@@ -817,7 +981,8 @@ int CAddonDatabase::GetRepositoryId(const std::string& addonId)
 bool CAddonDatabase::UpdateRepositoryContent(const std::string& repository,
                                              const CAddonVersion& version,
                                              const std::string& checksum,
-                                             const std::vector<AddonInfoPtr>& addons)
+                                             const std::vector<AddonInfoPtr>& addons,
+                                             bool replaceAll)
 {
   try
   {
@@ -826,37 +991,130 @@ bool CAddonDatabase::UpdateRepositoryContent(const std::string& repository,
     if (!m_pDS)
       return false;
 
-    DeleteRepositoryContents(repository);
     int idRepo = GetRepositoryId(repository);
     if (idRepo < 0)
       return false;
 
     assert(idRepo > 0);
 
-    m_pDB->start_transaction();
+    BeginTransaction();
     m_pDS->exec(
         PrepareSQL("UPDATE repo SET checksum='%s' WHERE id='%i'", checksum.c_str(), idRepo));
+    if (replaceAll)
+    {
+      m_pDS->exec(PrepareSQL("DELETE FROM addons WHERE id IN (SELECT idAddon FROM addonlinkrepo WHERE idRepo=%i)", idRepo));
+      m_pDS->exec(PrepareSQL("DELETE FROM addonlinkrepo WHERE idRepo=%i", idRepo));
+    }
+
+    // rows of the repository by add-on id and version, an index may list a version twice
+    std::map<std::pair<std::string, std::string>, std::vector<std::pair<int, std::string>>>
+        existing;
+    m_pDS->query(PrepareSQL("SELECT addons.id, addons.addonID, addons.version, addons.hash "
+                            "FROM addons "
+                            "JOIN addonlinkrepo ON addonlinkrepo.idAddon=addons.id "
+                            "WHERE addonlinkrepo.idRepo=%i",
+                            idRepo));
+    while (!m_pDS->eof())
+    {
+      existing[{m_pDS->fv("addonID").get_asString(), m_pDS->fv("version").get_asString()}]
+          .emplace_back(m_pDS->fv("id").get_asInt(), m_pDS->fv("hash").get_asString());
+      m_pDS->next();
+    }
+    m_pDS->close();
+
+    // a row is only kept while everything stored for the add-on is unchanged, a repository may
+    // e.g. mark a version broken or correct its description without bumping the version
+    struct AddedAddon
+    {
+      const CAddonInfo* addon;
+      std::string metadata;
+      std::string hash;
+    };
+    std::vector<AddedAddon> added;
     for (const auto& addon : addons)
     {
-      m_pDS->exec(PrepareSQL(
-          "INSERT INTO addons (id, metadata, addonID, version, name, summary, description, news) "
-          "VALUES (NULL, '%s', '%s', '%s', '%s','%s', '%s','%s')",
-          CAddonDatabaseSerializer::SerializeMetadata(*addon).c_str(), addon->ID().c_str(),
-          addon->Version().asString().c_str(), addon->Name().c_str(), addon->Summary().c_str(),
-          addon->Description().c_str(), addon->ChangeLog().c_str()));
-
-      int idAddon = static_cast<int>(m_pDS->lastinsertid());
-      if (idAddon <= 0)
+      std::string metadata = CAddonDatabaseSerializer::SerializeMetadata(*addon);
+      CDigest digest(CDigest::Type::MD5);
+      for (const std::string& text : {std::cref(metadata), std::cref(addon->Name()),
+                                      std::cref(addon->Summary()), std::cref(addon->Description()),
+                                      std::cref(addon->ChangeLog())})
       {
-        CLog::Log(LOGERROR, "{} insert failed on addon '{}'", __FUNCTION__, addon->ID());
-        RollbackTransaction();
-        return false;
+        digest.Update(text);
+        digest.Update("", 1);
       }
+      std::string hash = digest.Finalize();
 
-      m_pDS->exec(PrepareSQL("INSERT INTO addonlinkrepo (idRepo, idAddon) VALUES (%i, %i)", idRepo, idAddon));
+      auto it = existing.find({addon->ID(), addon->Version().asString()});
+      if (it != existing.end())
+      {
+        auto row = std::find_if(it->second.begin(), it->second.end(),
+                                [&hash](const auto& row) { return row.second == hash; });
+        if (row != it->second.end())
+        {
+          it->second.erase(row);
+          continue;
+        }
+      }
+      added.push_back({addon.get(), std::move(metadata), std::move(hash)});
     }
 
-    m_pDB->commit_transaction();
+    std::vector<std::string> removed;
+    for (const auto& it : existing)
+    {
+      for (const auto& row : it.second)
+        removed.push_back(std::to_string(row.first));
+    }
+    for (size_t i = 0; i < removed.size(); i += REPOSITORY_ROWS_PER_STATEMENT)
+    {
+      const std::string ids = StringUtils::Join(
+          std::vector<std::string>(
+              removed.begin() + i,
+              removed.begin() + std::min(i + REPOSITORY_ROWS_PER_STATEMENT, removed.size())),
+          ",");
+      m_pDS->exec("DELETE FROM addons WHERE id IN (" + ids + ")");
+      m_pDS->exec(PrepareSQL("DELETE FROM addonlinkrepo WHERE idRepo=%i AND idAddon IN (", idRepo) +
+                  ids + ")");
+    }
+
+    if (!added.empty())
+    {
+      // new rows get ids above the current maximum, the transaction keeps other writers out
+      m_pDS->query("SELECT MAX(id) AS maxId FROM addons");
+      const int maxId = m_pDS->eof() ? 0 : m_pDS->fv("maxId").get_asInt();
+      m_pDS->close();
+
+      // many rows per statement, so SQL is compiled once per batch rather than once per add-on
+      std::string sql;
+      size_t rows = 0;
+      for (const AddedAddon& row : added)
+      {
+        const CAddonInfo* addon = row.addon;
+        sql += rows == 0 ? "INSERT INTO addons (id, metadata, addonID, version, name, summary, "
+                           "description, news, hash) VALUES "
+                         : ",";
+        sql += PrepareSQL("(NULL, '%s', '%s', '%s', '%s', '%s', '%s', '%s', '%s')",
+                          row.metadata.c_str(), addon->ID().c_str(),
+                          addon->Version().asString().c_str(), addon->Name().c_str(),
+                          addon->Summary().c_str(), addon->Description().c_str(),
+                          addon->ChangeLog().c_str(), row.hash.c_str());
+        if (++rows == REPOSITORY_ROWS_PER_STATEMENT || sql.size() >= REPOSITORY_STATEMENT_SIZE)
+        {
+          m_pDS->exec(sql);
+          sql.clear();
+          rows = 0;
+        }
+      }
+      if (rows > 0)
+        m_pDS->exec(sql);
+
+      m_pDS->exec(PrepareSQL(
+          "INSERT INTO addonlinkrepo (idRepo, idAddon) SELECT %i, id FROM addons WHERE id > %i",
+          idRepo, maxId));
+    }
+
+    CommitTransaction();
+    CLog::Log(LOGDEBUG, "CAddonDatabase::{}: {} add-ons of '{}': {} added, {} removed", __FUNCTION__,
+              addons.size(), repository, added.size(), removed.size());
     return true;
   }
   catch (...)
@@ -1252,3 +1510,62 @@ bool CAddonDatabase::AddInstalledAddon(const std::shared_ptr<CAddonInfo>& addon,
 
   return true;
 }
+
+bool CAddonDatabase::GetManifests(AddonManifests& manifests)
+{
+  try
+  {
+    if (!m_pDB)
+      return false;
+    if (!m_pDS)
+      return false;
+
+    m_pDS->query(PrepareSQL("SELECT path, mtime, size, metadata FROM manifest"));
+    while (!m_pDS->eof())
+    {
+      AddonManifest& manifest = manifests[m_pDS->fv("path").get_asString()];
+      manifest.mtime = m_pDS->fv("mtime").get_asInt64();
+      manifest.size = m_pDS->fv("size").get_asInt64();
+      manifest.metadata = m_pDS->fv("metadata").get_asString();
+      m_pDS->next();
+    }
+    m_pDS->close();
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "CAddonDatabase::{}: failed", __FUNCTION__);
+  }
+  return false;
+}
+
+bool CAddonDatabase::UpdateManifests(const AddonManifests& manifests,
+                                     const std::vector<std::string>& removed)
+{
+  try
+  {
+    if (!m_pDB)
+      return false;
+    if (!m_pDS)
+      return false;
+
+    BeginTransaction();
+    for (const auto& path : removed)
+      m_pDS->exec(PrepareSQL("DELETE FROM manifest WHERE path='%s'", path.c_str()));
+    for (const auto& manifest : manifests)
+    {
+      m_pDS->exec(PrepareSQL("INSERT OR REPLACE INTO manifest (path, mtime, size, metadata) "
+                             "VALUES ('%s', %" PRIi64 ", %" PRIi64 ", '%s')",
+                             manifest.first.c_str(), manifest.second.mtime, manifest.second.size,
+                             manifest.second.metadata.c_str()));
+    }
+    CommitTransaction();
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "CAddonDatabase::{}: failed", __FUNCTION__);
+    RollbackTransaction();
+  }
+  return false;
+}
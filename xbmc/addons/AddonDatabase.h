@@ -12,6 +12,7 @@
 #include "addons/AddonVersion.h"
 #include "dbwrappers/Database.h"
 
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <set>
@@ -53,11 +54,37 @@ public:
   static std::string SerializeMetadata(const CAddonInfo& addon);
   static void DeserializeMetadata(const std::string& document, CAddonInfoBuilderFromDB& builder);
 
+  /*!
+   * @brief Serialize everything read from the addon.xml of an installed add-on.
+   *
+   * Unlike the metadata of repository add-ons this keeps all types and all
+   * translations, the add-on can be rebuilt exactly as if addon.xml was parsed.
+   * Install data like dates and origin is not included.
+   */
+  static std::string SerializeManifest(const CAddonInfo& addon);
+  static AddonInfoPtr DeserializeManifest(const std::string& document);
+
 private:
   static CVariant SerializeExtensions(const CAddonExtensions& addonType);
   static void DeserializeExtensions(const CVariant& document, CAddonExtensions& addonType);
 };
 
+/*!
+ * @brief Entry of the manifest cache, the parsed addon.xml of an installed add-on.
+ *
+ * An entry stays valid as long as addon.xml keeps its modification time and size.
+ * Empty metadata records an addon.xml that can't be used on this platform.
+ */
+struct AddonManifest
+{
+  int64_t mtime = 0;
+  int64_t size = 0;
+  std::string metadata;
+};
+
+/*! Manifest cache entries by add-on path */
+using AddonManifests = std::map<std::string, AddonManifest>;
+
 class CAddonDatabase : public CDatabase
 {
 public:
@@ -77,10 +104,21 @@ public:
   /*! Returns all addons in the repositories with id `addonId`. */
   bool FindByAddonId(const std::string& addonId, ADDON::VECADDONS& addons) const;
 
+  /*!
+   \brief Store the add-ons of a repository index in one transaction
+   \param repositoryId id of the repository
+   \param version version of the repository add-on
+   \param checksum checksum of the index
+   \param addons the add-ons of the index
+   \param replaceAll replace all rows, otherwise rows of add-ons whose descriptor is unchanged are
+   kept
+   \returns true on success, false on error
+   */
   bool UpdateRepositoryContent(const std::string& repositoryId,
                                const ADDON::CAddonVersion& version,
                                const std::string& checksum,
-                               const std::vector<AddonInfoPtr>& addons);
+                               const std::vector<AddonInfoPtr>& addons,
+                               bool replaceAll);
 
   int GetRepoChecksum(const std::string& id, std::string& checksum);
 
@@ -230,6 +268,19 @@ public:
    */
   bool AddInstalledAddon(const std::shared_ptr<CAddonInfo>& addon, const std::string& origin);
 
+  /*! \brief Get all entries of the manifest cache
+   *  \param manifests [out] the cached manifests by add-on path
+   *  \return true on success, false otherwise
+   */
+  bool GetManifests(AddonManifests& manifests);
+
+  /*! \brief Store and remove entries of the manifest cache in one transaction
+   *  \param manifests the manifests to add or replace, by add-on path
+   *  \param removed paths of add-ons that are gone
+   *  \return true on success, false otherwise
+   */
+  bool UpdateManifests(const AddonManifests& manifests, const std::vector<std::string>& removed);
+
 protected:
   void CreateTables() override;
   void CreateAnalytics() override;
@@ -240,7 +291,6 @@ protected:
 
   bool GetAddon(int id, ADDON::AddonPtr& addon);
   void DeleteRepository(const std::string& id);
-  void DeleteRepositoryContents(const std::string& id);
   int GetRepositoryId(const std::string& addonId);
 };
 
@@ -19,13 +19,14 @@
 #include "addons/AddonRepos.h"
 #include "addons/AddonSystemSettings.h"
 #include "addons/AddonUpdateRules.h"
+#include "addons/RepositoryIndexReader.h"
 #include "addons/IAddon.h"
 #include "addons/addoninfo/AddonInfo.h"
 #include "addons/addoninfo/AddonInfoBuilder.h"
 #include "addons/addoninfo/AddonType.h"
 #include "filesystem/Directory.h"
+#include "filesystem/File.h"
 #include "filesystem/SpecialProtocol.h"
-#include "utils/FileUtils.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 #include "utils/XMLUtils.h"
@@ -33,6 +34,7 @@
 
 #include <algorithm>
 #include <array>
+#include <iterator>
 #include <mutex>
 #include <set>
 #include <utility>
@@ -80,6 +82,21 @@ static bool LoadManifest(std::set<std::string>& system, std::set<std::string>& o
   return true;
 }
 
+// Parse the addon.xml with the given stat data into an entry of the manifest cache
+static AddonManifest ParseAddonXml(const std::string& path,
+                                   const struct __stat64& buffer,
+                                   AddonInfoPtr& addonInfo)
+{
+  AddonManifest manifest;
+  manifest.mtime = buffer.st_mtime;
+  manifest.size = buffer.st_size;
+
+  addonInfo = CAddonInfoBuilder::Generate(path);
+  if (addonInfo)
+    manifest.metadata = CAddonDatabaseSerializer::SerializeManifest(*addonInfo);
+  return manifest;
+}
+
 CAddonMgr::CAddonMgr()
   : m_database(std::make_unique<CAddonDatabase>()),
     m_updateRules(std::make_unique<CAddonUpdateRules>())
@@ -668,12 +685,7 @@ bool CAddonMgr::FindAddon(const std::string& addonId,
                           const CAddonVersion& addonVersion)
 {
   std::map<std::string, std::shared_ptr<CAddonInfo>> installedAddons;
-
-  FindAddons(installedAddons, "special://xbmcbin/addons");
-  // Confirm special://xbmcbin/addons and special://xbmc/addons are not the same
-  if (!CSpecialProtocol::ComparePath("special://xbmcbin/addons", "special://xbmc/addons"))
-    FindAddons(installedAddons, "special://xbmc/addons");
-  FindAddons(installedAddons, "special://home/addons");
+  ScanAddons(installedAddons);
 
   const auto it = installedAddons.find(addonId);
   if (it == installedAddons.cend() || it->second->Version() != addonVersion)
@@ -700,12 +712,7 @@ bool CAddonMgr::FindAddon(const std::string& addonId,
 bool CAddonMgr::FindAddons()
 {
   ADDON_INFO_LIST installedAddons;
-
-  FindAddons(installedAddons, "special://xbmcbin/addons");
-  // Confirm special://xbmcbin/addons and special://xbmc/addons are not the same
-  if (!CSpecialProtocol::ComparePath("special://xbmcbin/addons", "special://xbmc/addons"))
-    FindAddons(installedAddons, "special://xbmc/addons");
-  FindAddons(installedAddons, "special://home/addons");
+  ScanAddons(installedAddons);
 
   std::set<std::string> installed;
   for (const auto& addon : installedAddons)
@@ -1271,7 +1278,87 @@ const AddonInfoPtr CAddonMgr::GetAddonInfo(const std::string& id, AddonType type
   return nullptr;
 }
 
-void CAddonMgr::FindAddons(ADDON_INFO_LIST& addonmap, const std::string& path)
+void CAddonMgr::ValidateManifestCache()
+{
+  std::set<std::string> paths;
+  {
+    std::unique_lock<CCriticalSection> lock(m_critSection);
+    paths.swap(m_unvalidatedManifests);
+  }
+  if (paths.empty())
+    return;
+
+  CServiceBroker::GetJobManager()->Submit(
+      [this, paths]() {
+        CAddonDatabase database;
+        AddonManifests cached;
+        if (!database.Open() || !database.GetManifests(cached))
+          return;
+
+        AddonManifests changed;
+        for (const auto& path : paths)
+        {
+          const auto it = cached.find(path);
+          struct __stat64 buffer;
+          if (it == cached.end() || CFile::Stat(path + "addon.xml", &buffer) != 0)
+            continue;
+
+          AddonInfoPtr addonInfo;
+          AddonManifest manifest = ParseAddonXml(path, buffer, addonInfo);
+          if (manifest.metadata != it->second.metadata)
+            changed.emplace(path, std::move(manifest));
+        }
+        if (changed.empty())
+          return;
+
+        CLog::Log(LOGINFO, "CAddonMgr::ValidateManifestCache: {} cached add-on(s) changed, reloading",
+                  changed.size());
+        database.UpdateManifests(changed, {});
+        database.Close();
+        FindAddons();
+      },
+      CJob::PRIORITY_LOW_PAUSABLE);
+}
+
+void CAddonMgr::ScanAddons(ADDON_INFO_LIST& addonmap)
+{
+  AddonManifests cached;
+  {
+    std::unique_lock<CCriticalSection> lock(m_critSection);
+    m_database->GetManifests(cached);
+  }
+
+  AddonManifests changed;
+  std::set<std::string> unchanged;
+  FindAddons(addonmap, "special://xbmcbin/addons", cached, changed, unchanged);
+  // Confirm special://xbmcbin/addons and special://xbmc/addons are not the same
+  if (!CSpecialProtocol::ComparePath("special://xbmcbin/addons", "special://xbmc/addons"))
+    FindAddons(addonmap, "special://xbmc/addons", cached, changed, unchanged);
+  FindAddons(addonmap, "special://home/addons", cached, changed, unchanged);
+
+  // add-ons that weren't found anymore
+  std::vector<std::string> removed;
+  for (const auto& manifest : cached)
+  {
+    if (unchanged.find(manifest.first) == unchanged.end() &&
+        changed.find(manifest.first) == changed.end())
+      removed.push_back(manifest.first);
+  }
+
+  CLog::Log(LOGDEBUG, "CAddonMgr::{}: {} add-on(s) from cache, {} parsed, {} gone", __FUNCTION__,
+            unchanged.size(), changed.size(), removed.size());
+
+  std::unique_lock<CCriticalSection> lock(m_critSection);
+  if (!changed.empty() || !removed.empty())
+    m_database->UpdateManifests(changed, removed);
+  m_unvalidatedManifests.insert(unchanged.begin(), unchanged.end());
+}
+
+void CAddonMgr::FindAddons(ADDON_INFO_LIST& addonmap,
+                           const std::string& path,
+                           const AddonManifests& cached,
+                           AddonManifests& changed,
+                           std::set<std::string>& unchanged)
 {
   CFileItemList items;
   if (XFILE::CDirectory::GetDirectory(path, items, "", XFILE::DIR_FLAG_NO_FILE_DIRS))
@@ -1279,9 +1366,23 @@ void CAddonMgr::FindAddons(ADDON_INFO_LIST& addonmap, const std::string& path)
     for (int i = 0; i < items.Size(); ++i)
     {
       std::string path = items[i]->GetPath();
-      if (CFileUtils::Exists(path + "addon.xml"))
+      struct __stat64 buffer;
+      if (CFile::Stat(path + "addon.xml", &buffer) == 0)
       {
-        AddonInfoPtr addonInfo = CAddonInfoBuilder::Generate(path);
+        AddonInfoPtr addonInfo;
+        const auto manifest = cached.find(path);
+        if (manifest != cached.end() && manifest->second.mtime == buffer.st_mtime &&
+            manifest->second.size == buffer.st_size)
+        {
+          // addon.xml didn't change since it was cached, no need to parse it
+          if (!manifest->second.metadata.empty())
+            addonInfo = CAddonDatabaseSerializer::DeserializeManifest(manifest->second.metadata);
+          if (addonInfo || manifest->second.metadata.empty())
+            unchanged.insert(path);
+        }
+        if (!addonInfo && unchanged.find(path) == unchanged.end())
+          changed[path] = ParseAddonXml(path, buffer, addonInfo);
+
         if (addonInfo)
         {
           const auto& it = addonmap.find(addonInfo->ID());
@@ -1346,30 +1447,24 @@ bool CAddonMgr::AddonsFromRepoXML(const RepositoryDirInfo& repo,
                                   const std::string& xml,
                                   std::vector<AddonInfoPtr>& addons)
 {
-  CXBMCTinyXML doc;
-  if (!doc.Parse(xml))
+  // each add-on is parsed on its own, there's never a DOM of the whole index
+  CRepositoryIndexReader reader(xml);
+  std::vector<AddonInfoPtr> result;
+  while (const TiXmlElement* element = reader.Next())
   {
-    CLog::Log(LOGERROR, "CAddonMgr::{}: Failed to parse addons.xml", __func__);
-    return false;
+    auto addonInfo = CAddonInfoBuilder::Generate(element, repo);
+    if (addonInfo)
+      result.emplace_back(std::move(addonInfo));
   }
 
-  if (doc.RootElement() == nullptr || doc.RootElement()->ValueStr() != "addons")
+  if (reader.HasFailed())
   {
     CLog::Log(LOGERROR, "CAddonMgr::{}: Failed to parse addons.xml. Malformed", __func__);
     return false;
   }
 
-  // each addon XML should have a UTF-8 declaration
-  auto element = doc.RootElement()->FirstChildElement("addon");
-  while (element)
-  {
-    auto addonInfo = CAddonInfoBuilder::Generate(element, repo);
-    if (addonInfo)
-      addons.emplace_back(addonInfo);
-
-    element = element->NextSiblingElement("addon");
-  }
-
+  addons.insert(addons.end(), std::make_move_iterator(result.begin()),
+                std::make_move_iterator(result.end()));
   return true;
 }
 
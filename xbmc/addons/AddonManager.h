@@ -27,6 +27,7 @@ enum class AddonUpdateRule;
 enum class AllowCheckForUpdates : bool;
 
 class CAddonDatabase;
+struct AddonManifest;
 class CAddonUpdateRules;
 class CAddonVersion;
 class IAddonMgrCallback;
@@ -199,6 +200,13 @@ public:
                  const std::string& origin,
                  const CAddonVersion& addonVersion);
 
+  /*! \brief Checks the add-ons taken from the manifest cache against their addon.xml
+     *
+     * Runs in the background, meant to be called once the GUI is up. Catches changes the
+     * modification time of addon.xml didn't reveal, and reloads the add-ons if there were any.
+     */
+  void ValidateManifestCache();
+
   /*!
      * @brief Fills the the provided vector with the list of incompatible
      * enabled addons and returns if there's any.
@@ -628,7 +636,19 @@ private:
 
   bool EnableSingle(const std::string& id);
 
-  void FindAddons(ADDON_INFO_LIST& addonmap, const std::string& path);
+  /*!
+     * \brief Find the installed add-ons in all add-on folders.
+     *
+     * addon.xml is only parsed for add-ons that changed since they were added to the
+     * manifest cache, all others are rebuilt from the cache.
+     */
+  void ScanAddons(ADDON_INFO_LIST& addonmap);
+
+  void FindAddons(ADDON_INFO_LIST& addonmap,
+                  const std::string& path,
+                  const std::map<std::string, AddonManifest>& cached,
+                  std::map<std::string, AddonManifest>& changed,
+                  std::set<std::string>& unchanged);
 
   /*!
      * @brief Fills the the provided vector with the list of incompatible
@@ -682,6 +702,7 @@ private:
   std::set<std::string> m_systemAddons;
   std::set<std::string> m_optionalSystemAddons;
   ADDON_INFO_LIST m_installedAddons;
+  std::set<std::string> m_unvalidatedManifests; ///< paths of add-ons rebuilt from the manifest cache
 
   // Temporary path given to add-ons, whose content is deleted when Kodi is stopped
   const std::string m_tempAddonBasePath = "special://temp/addons";
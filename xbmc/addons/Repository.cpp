@@ -19,10 +19,12 @@
 #include "addons/addoninfo/AddonType.h"
 #include "filesystem/CurlFile.h"
 #include "filesystem/File.h"
+#include "filesystem/HttpCache.h"
 #include "filesystem/ZipFile.h"
 #include "messaging/helpers/DialogHelper.h"
 #include "utils/Base64.h"
 #include "utils/Digest.h"
+#include "utils/HttpHeader.h"
 #include "utils/Mime.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
@@ -153,20 +155,33 @@ bool CRepository::FetchChecksum(const std::string& url,
                                 std::string& checksum,
                                 int& recheckAfter) noexcept
 {
-  CFile file;
-  if (!file.Open(url))
-    return false;
+  CHttpHeader headers;
+  const CURL checksumUrl(url);
+  if (checksumUrl.IsProtocol("http") || checksumUrl.IsProtocol("https"))
+  {
+    // the checksum is usually unchanged, the server can say so without sending it again. It is
+    // always asked though, a cached checksum may be fresh by its headers and still be outdated.
+    CCurlFile http;
+    if (!CHttpCache::GetInstance().Get(http, url, checksum, headers, nullptr, true))
+      return false;
+  }
+  else
+  {
+    CFile file;
+    if (!file.Open(url))
+      return false;
 
-  // we intentionally avoid using file.GetLength() for
-  // Transfer-Encoding: chunked servers.
-  std::stringstream ss;
-  char temp[1024];
-  int read;
-  while ((read = file.Read(temp, sizeof(temp))) > 0)
-    ss.write(temp, read);
-  if (read <= -1)
-    return false;
-  checksum = ss.str();
+    // we intentionally avoid using file.GetLength() for
+    // Transfer-Encoding: chunked servers.
+    std::stringstream ss;
+    char temp[1024];
+    int read;
+    while ((read = file.Read(temp, sizeof(temp))) > 0)
+      ss.write(temp, read);
+    if (read <= -1)
+      return false;
+    checksum = ss.str();
+  }
   std::size_t pos = checksum.find_first_of(" \n");
   if (pos != std::string::npos)
   {
@@ -178,8 +193,7 @@ bool CRepository::FetchChecksum(const std::string& url,
   recheckAfter = 24 * 60 * 60;
   // This special header is set by the Kodi mirror redirector to control client update frequency
   // depending on the load on the mirrors
-  const std::string recheckAfterHeader{
-      file.GetProperty(FILE_PROPERTY_RESPONSE_HEADER, "X-Kodi-Recheck-After")};
+  const std::string recheckAfterHeader{headers.GetValue("X-Kodi-Recheck-After")};
   if (!recheckAfterHeader.empty())
   {
     try
@@ -204,8 +218,10 @@ bool CRepository::FetchIndex(const RepositoryDirInfo& repo,
 {
   XFILE::CCurlFile http;
 
+  // the checksum has changed, only serve the index from the cache if the server says it's current
   std::string response;
-  if (!http.Get(repo.info, response))
+  CHttpHeader headers;
+  if (!XFILE::CHttpCache::GetInstance().Get(http, repo.info, response, headers, nullptr, true))
   {
     CLog::Log(LOGERROR, "CRepository: failed to read {}", repo.info);
     return false;
@@ -222,7 +238,7 @@ bool CRepository::FetchIndex(const RepositoryDirInfo& repo,
   }
 
   if (URIUtils::HasExtension(repo.info, ".gz")
-      || CMime::GetFileTypeFromMime(http.GetProperty(XFILE::FILE_PROPERTY_MIME_TYPE)) == CMime::EFileType::FileTypeGZip)
+      || CMime::GetFileTypeFromMime(headers.GetMimeType()) == CMime::EFileType::FileTypeGZip)
   {
     CLog::Log(LOGDEBUG, "CRepository '{}' is gzip. decompressing", repo.info);
     std::string buffer;
@@ -0,0 +1,185 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "RepositoryIndexReader.h"
+
+#include "utils/CharsetDetection.h"
+#include "utils/StringUtils.h"
+#include "utils/Utf8Utils.h"
+
+#include <cstring>
+
+namespace ADDON
+{
+
+CRepositoryIndexReader::CRepositoryIndexReader(const std::string& xml) : m_xml(xml)
+{
+  // the charset is declared once for the whole index, not for each add-on
+  if (!CCharsetDetection::DetectXmlEncoding(xml, m_charset))
+    m_charset = CUtf8Utils::isValidUtf8(xml) ? "UTF-8" : "";
+}
+
+const TiXmlElement* CRepositoryIndexReader::Next()
+{
+  if (m_failed || m_pos == std::string::npos)
+    return nullptr;
+
+  if (!m_started)
+  {
+    m_started = true;
+    if (!ReadRoot())
+    {
+      m_failed = true;
+      return nullptr;
+    }
+    if (m_pos == std::string::npos)
+      return nullptr;
+  }
+
+  int depth = 0; // below the root element
+  size_t start = std::string::npos;
+  while ((m_pos = m_xml.find('<', m_pos)) != std::string::npos && m_pos + 1 < m_xml.size())
+  {
+    if (m_xml[m_pos + 1] == '!' || m_xml[m_pos + 1] == '?')
+    {
+      if (!SkipMarkup())
+        break;
+      continue;
+    }
+
+    const size_t tagStart = m_pos;
+    std::string name;
+    bool closing;
+    bool empty;
+    if (!ReadTag(name, closing, empty))
+      break;
+
+    if (closing)
+    {
+      if (depth == 0)
+      {
+        // end of the root element, nothing after it matters
+        m_pos = std::string::npos;
+        return nullptr;
+      }
+      if (--depth > 0 || start == std::string::npos)
+        continue;
+    }
+    else if (empty)
+    {
+      if (depth > 0 || name != "addon")
+        continue;
+      start = tagStart;
+    }
+    else
+    {
+      if (depth++ == 0)
+        start = name == "addon" ? tagStart : std::string::npos;
+      continue;
+    }
+
+    const std::string element = m_xml.substr(start, m_pos - start);
+    m_doc.Clear();
+    bool parsed;
+    if (m_charset.empty())
+      parsed = m_doc.Parse(element);
+    else if (StringUtils::EqualsNoCase(m_charset, "UTF-8"))
+      parsed = m_doc.Parse(element, TIXML_ENCODING_UTF8);
+    else
+      parsed = m_doc.Parse(element, m_charset);
+
+    if (!parsed || m_doc.RootElement() == nullptr)
+      break;
+    return m_doc.RootElement();
+  }
+
+  m_failed = true;
+  return nullptr;
+}
+
+bool CRepositoryIndexReader::ReadRoot()
+{
+  while ((m_pos = m_xml.find('<', m_pos)) != std::string::npos && m_pos + 1 < m_xml.size())
+  {
+    if (m_xml[m_pos + 1] == '!' || m_xml[m_pos + 1] == '?')
+    {
+      if (!SkipMarkup())
+        return false;
+      continue;
+    }
+
+    std::string name;
+    bool closing;
+    bool empty;
+    if (!ReadTag(name, closing, empty) || closing || name != "addons")
+      return false;
+    if (empty)
+      m_pos = std::string::npos; // an index without add-ons
+    return true;
+  }
+  return false;
+}
+
+bool CRepositoryIndexReader::SkipMarkup()
+{
+  static const struct
+  {
+    const char* open;
+    const char* close;
+  } markup[] = {{"<!--", "-->"}, {"<![CDATA[", "]]>"}, {"<?", "?>"}, {"<!", ">"}};
+
+  for (const auto& item : markup)
+  {
+    const size_t length = strlen(item.open);
+    if (m_xml.compare(m_pos, length, item.open) == 0)
+    {
+      const size_t end = m_xml.find(item.close, m_pos + length);
+      if (end == std::string::npos)
+        return false;
+      m_pos = end + strlen(item.close);
+      return true;
+    }
+  }
+  return false;
+}
+
+bool CRepositoryIndexReader::ReadTag(std::string& name, bool& closing, bool& empty)
+{
+  size_t pos = m_pos + 1;
+  closing = m_xml[pos] == '/';
+  if (closing)
+    pos++;
+
+  const size_t nameEnd = m_xml.find_first_of(" \t\r\n/>", pos);
+  if (nameEnd == std::string::npos || nameEnd == pos)
+    return false;
+  name.assign(m_xml, pos, nameEnd - pos);
+
+  // find the end of the tag, attribute values may contain '>'
+  char quote = 0;
+  for (pos = nameEnd; pos < m_xml.size(); pos++)
+  {
+    const char c = m_xml[pos];
+    if (quote)
+    {
+      if (c == quote)
+        quote = 0;
+    }
+    else if (c == '"' || c == '\'')
+      quote = c;
+    else if (c == '>')
+    {
+      empty = !closing && m_xml[pos - 1] == '/';
+      m_pos = pos + 1;
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace ADDON
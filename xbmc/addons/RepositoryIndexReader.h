@@ -0,0 +1,64 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "utils/XBMCTinyXML.h"
+
+#include <string>
+
+namespace ADDON
+{
+
+/*!
+ * @brief Reads the add-ons of a repository index (addons.xml) one at a time.
+ *
+ * The index is scanned for the <addon> elements below the root, and only the
+ * element being read is parsed into a DOM. Memory use stays at the size of one
+ * add-on descriptor instead of a DOM of the whole index.
+ *
+ * ~~~~~~~~~~~~~{.cpp}
+ * CRepositoryIndexReader reader(xml);
+ * while (const TiXmlElement* element = reader.Next())
+ *   ...
+ * if (reader.HasFailed())
+ *   ...
+ * ~~~~~~~~~~~~~
+ */
+class CRepositoryIndexReader
+{
+public:
+  explicit CRepositoryIndexReader(const std::string& xml);
+
+  /*!
+   * @brief Parse the next add-on of the index
+   * @return the <addon> element, valid until the next call, or nullptr at the end
+   * of the index or on error
+   */
+  const TiXmlElement* Next();
+
+  /*! @brief Whether the index turned out to be malformed */
+  bool HasFailed() const { return m_failed; }
+
+private:
+  CRepositoryIndexReader(const CRepositoryIndexReader&) = delete;
+  CRepositoryIndexReader& operator=(const CRepositoryIndexReader&) = delete;
+
+  bool ReadRoot();
+  bool SkipMarkup();
+  bool ReadTag(std::string& name, bool& closing, bool& empty);
+
+  const std::string& m_xml;
+  size_t m_pos = 0;
+  bool m_failed = false;
+  bool m_started = false;
+  std::string m_charset; ///< charset of the index, empty if unknown
+  CXBMCTinyXML m_doc;
+};
+
+} // namespace ADDON
@@ -116,7 +116,9 @@ bool CRepositoryUpdateJob::DoWork()
     textureDB.CommitMultipleExecute();
   }
 
-  database.UpdateRepositoryContent(m_repo->ID(), m_repo->Version(), newChecksum, addons);
+  // a new version of the repository may serve its add-ons from elsewhere, keep no rows then
+  database.UpdateRepositoryContent(m_repo->ID(), m_repo->Version(), newChecksum, addons,
+                                   updateData.lastCheckedVersion != m_repo->Version());
   return true;
 }
 
@@ -136,6 +136,7 @@ struct DependencyInfo
 typedef std::map<std::string, std::string> InfoMap;
 typedef std::map<std::string, std::string> ArtMap;
 
+class CAddonDatabaseSerializer;
 class CAddonInfoBuilder;
 
 class CAddonInfo
@@ -261,6 +262,7 @@ public:
   //@}
 
 private:
+  friend class CAddonDatabaseSerializer;
   friend class CAddonInfoBuilder;
   friend class CAddonInfoBuilderFromDB;
 
@@ -482,6 +482,7 @@ bool CApplication::Initialize()
   appListener->RegisterActionListener(&CPlayerController::GetInstance());
 
   CServiceBroker::GetRepositoryUpdater().Start();
+  CServiceBroker::GetAddonMgr().ValidateManifestCache();
   if (!profileManager->UsingLoginScreen())
     CServiceBroker::GetServiceAddons().Start();
 
@@ -546,6 +547,9 @@ void CApplication::Render()
     {
       hasRendered |= CServiceBroker::GetGUI()->GetWindowManager().Render();
     }
+    // draw the quads still batched before the video layer and the windows closing
+    g_graphicsContext.GetRenderBatch().Finish();
+
     // execute post rendering actions (finalize window closing)
     CServiceBroker::GetGUI()->GetWindowManager().AfterRender();
 
@@ -554,6 +558,7 @@ void CApplication::Render()
 
   // render video layer
   CServiceBroker::GetGUI()->GetWindowManager().RenderEx();
+  g_graphicsContext.GetRenderBatch().Finish();
 
 #ifdef NXDK
 #if 0
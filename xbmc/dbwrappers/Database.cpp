@@ -10,6 +10,7 @@
 
 #include "DatabaseManager.h"
 #include "DbUrl.h"
+#include "LangInfo.h"
 #include "ServiceBroker.h"
 #include "filesystem/SpecialProtocol.h"
 #include "profiles/ProfileManager.h"
@@ -836,6 +837,225 @@ bool CDatabase::BuildSQL(const std::string& strQuery, const Filter& filter, std:
   return true;
 }
 
+void CDatabase::CreateSearchTable(const std::string& searchTable,
+                                  const std::string& contentTable,
+                                  const std::string& idColumn,
+                                  const std::vector<std::string>& columns)
+{
+  if (!m_sqlite)
+    return;
+
+  // matches in the first column (usually the title) are worth more than the others
+  std::vector<std::string> weights(columns.size(), "1.0");
+  if (!weights.empty())
+    weights.front() = "10.0";
+
+  try
+  {
+    CLog::Log(LOGINFO, "create {} search table", contentTable);
+    m_pDS->exec(PrepareSQL("CREATE VIRTUAL TABLE %s USING fts5(%s, content='%s', "
+                           "content_rowid='%s', tokenize='unicode61 remove_diacritics 1', "
+                           "prefix='2 3')",
+                           searchTable.c_str(), StringUtils::Join(columns, ", ").c_str(),
+                           contentTable.c_str(), idColumn.c_str()));
+    m_pDS->exec(PrepareSQL("INSERT INTO %s(%s, rank) VALUES('rank', 'bm25(%s)')",
+                           searchTable.c_str(), searchTable.c_str(),
+                           StringUtils::Join(weights, ", ").c_str()));
+  }
+  catch (...)
+  {
+    // sqlite built without FTS5, searches fall back to LIKE
+    CLog::Log(LOGWARNING, "{} - unable to create search table {}", __FUNCTION__, searchTable);
+  }
+}
+
+void CDatabase::CreateSearchTriggers(const std::string& searchTable,
+                                     const std::string& contentTable,
+                                     const std::string& idColumn,
+                                     const std::vector<std::string>& columns)
+{
+  if (!m_sqlite || !HasSearchTable(searchTable))
+    return;
+
+  std::string fields = StringUtils::Join(columns, ", ");
+  std::string newValues = "new." + StringUtils::Join(columns, ", new.");
+  std::string oldValues = "old." + StringUtils::Join(columns, ", old.");
+
+  // external content tables are told which values to remove from the index
+  std::string insertSQL =
+      PrepareSQL("INSERT INTO %s(rowid, %s) VALUES (new.%s, %s);", searchTable.c_str(),
+                 fields.c_str(), idColumn.c_str(), newValues.c_str());
+  std::string deleteSQL =
+      PrepareSQL("INSERT INTO %s(%s, rowid, %s) VALUES ('delete', old.%s, %s);",
+                 searchTable.c_str(), searchTable.c_str(), fields.c_str(), idColumn.c_str(),
+                 oldValues.c_str());
+
+  CLog::Log(LOGINFO, "{} - creating {} search triggers", __FUNCTION__, contentTable);
+  m_pDS->exec(PrepareSQL("CREATE TRIGGER %s_insert AFTER INSERT ON %s FOR EACH ROW BEGIN ",
+                         searchTable.c_str(), contentTable.c_str()) +
+              insertSQL + " END");
+  m_pDS->exec(PrepareSQL("CREATE TRIGGER %s_delete AFTER DELETE ON %s FOR EACH ROW BEGIN ",
+                         searchTable.c_str(), contentTable.c_str()) +
+              deleteSQL + " END");
+  m_pDS->exec(PrepareSQL("CREATE TRIGGER %s_update AFTER UPDATE OF %s ON %s FOR EACH ROW BEGIN ",
+                         searchTable.c_str(), fields.c_str(), contentTable.c_str()) +
+              deleteSQL + " " + insertSQL + " END");
+}
+
+void CDatabase::RebuildSearchTable(const std::string& searchTable)
+{
+  if (!m_sqlite || !HasSearchTable(searchTable))
+    return;
+
+  CLog::Log(LOGINFO, "{} - rebuilding search table {}", __FUNCTION__, searchTable);
+  m_pDS->exec(PrepareSQL("INSERT INTO %s(%s) VALUES('rebuild')", searchTable.c_str(),
+                         searchTable.c_str()));
+}
+
+bool CDatabase::HasSearchTable(const std::string& searchTable)
+{
+  if (!m_sqlite)
+    return false;
+
+  return !GetSingleValue(PrepareSQL("SELECT name FROM sqlite_master WHERE type='table' AND "
+                                    "name='%s'",
+                                    searchTable.c_str()),
+                         m_pDS2)
+              .empty();
+}
+
+std::string CDatabase::PrepareSearchMatch(const std::string& search)
+{
+  // punctuation has a meaning in FTS5 queries, and is no part of the indexed words anyway
+  std::string words(search);
+  for (char& c : words)
+  {
+    unsigned char uc = static_cast<unsigned char>(c);
+    if (uc < 0x80 && !StringUtils::isasciialphanum(c))
+      c = ' ';
+  }
+
+  std::string match;
+  for (const auto& word : StringUtils::Split(words, ' '))
+  {
+    if (word.empty())
+      continue;
+    if (!match.empty())
+      match += ' ';
+    match += "\"" + word + "\"*";
+  }
+  return match;
+}
+
+std::string CDatabase::PrepareSearchJoin(const std::string& searchTable,
+                                         const std::string& idColumn,
+                                         const std::string& search)
+{
+  std::string match = PrepareSearchMatch(search);
+  if (match.empty() || !HasSearchTable(searchTable))
+    return "";
+
+  return PrepareSQL(" JOIN (SELECT rowid AS searchId, rank AS searchRank FROM %s WHERE %s MATCH "
+                    "'%s') AS %smatch ON %smatch.searchId = %s",
+                    searchTable.c_str(), searchTable.c_str(), match.c_str(), searchTable.c_str(),
+                    searchTable.c_str(), idColumn.c_str());
+}
+
+std::string CDatabase::PrepareSearchCondition(const std::string& searchTable,
+                                              const std::string& idColumn,
+                                              const std::string& search)
+{
+  std::string match = PrepareSearchMatch(search);
+  if (match.empty() || !HasSearchTable(searchTable))
+    return "";
+
+  return PrepareSQL("%s IN (SELECT rowid FROM %s WHERE %s MATCH '%s')", idColumn.c_str(),
+                    searchTable.c_str(), searchTable.c_str(), match.c_str());
+}
+
+void CDatabase::CreateSortKeyTable()
+{
+  if (!m_sqlite)
+    return;
+
+  CLog::Log(LOGINFO, "create sortkeytokens table");
+  m_pDS->exec("CREATE TABLE sortkeytokens (strTokens TEXT)");
+  m_pDS->exec(PrepareSQL("INSERT INTO sortkeytokens (strTokens) VALUES ('%s')",
+                         SortUtils::GetSortKeyTokens().c_str()));
+}
+
+void CDatabase::CreateSortKeyTriggers(const SortKeyColumn& sortKey)
+{
+  if (!m_sqlite)
+    return;
+
+  CLog::Log(LOGINFO, "{} - creating {}.{} sort key triggers", __FUNCTION__, sortKey.table,
+            sortKey.keyColumn);
+  m_pDS->exec(PrepareSQL("CREATE INDEX idx_%s_%s ON %s(%s)", sortKey.table, sortKey.keyColumn,
+                         sortKey.table, sortKey.keyColumn));
+
+  // only touch the row when the key changes, the key is not written by anything else
+  std::string updateSQL =
+      PrepareSQL("UPDATE %s SET %s = sortkey(NEW.%s) WHERE %s = NEW.%s; END", sortKey.table,
+                 sortKey.keyColumn, sortKey.column, sortKey.idColumn, sortKey.idColumn);
+  std::string whenSQL = PrepareSQL(" WHEN NEW.%s IS NOT sortkey(NEW.%s) BEGIN ",
+                                   sortKey.keyColumn, sortKey.column);
+  m_pDS->exec(PrepareSQL("CREATE TRIGGER tgr_%s_%s_insert AFTER INSERT ON %s FOR EACH ROW",
+                         sortKey.table, sortKey.keyColumn, sortKey.table) +
+              whenSQL + updateSQL);
+  m_pDS->exec(PrepareSQL("CREATE TRIGGER tgr_%s_%s_update AFTER UPDATE OF %s ON %s FOR EACH ROW",
+                         sortKey.table, sortKey.keyColumn, sortKey.column, sortKey.table) +
+              whenSQL + updateSQL);
+}
+
+bool CDatabase::UpdateSortKeys(const std::vector<SortKeyColumn>& sortKeys, bool force)
+{
+  if (!m_sqlite)
+    return true;
+
+  std::string tokens = SortUtils::GetSortKeyTokens();
+  if (!force && GetSingleValue("SELECT strTokens FROM sortkeytokens", m_pDS2) == tokens)
+    return true;
+
+  try
+  {
+    // until all keys are up to date sorting falls back to the collation
+    m_pDS->exec("DELETE FROM sortkeytokens");
+    m_sortKeyTokensLoaded = false;
+    for (const auto& sortKey : sortKeys)
+    {
+      CLog::Log(LOGINFO, "{} - updating {}.{}", __FUNCTION__, sortKey.table, sortKey.keyColumn);
+      m_pDS->exec(PrepareSQL("UPDATE %s SET %s = sortkey(%s) WHERE %s IS NOT sortkey(%s)",
+                             sortKey.table, sortKey.keyColumn, sortKey.column, sortKey.keyColumn,
+                             sortKey.column));
+    }
+    m_pDS->exec(PrepareSQL("INSERT INTO sortkeytokens (strTokens) VALUES ('%s')", tokens.c_str()));
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "{} - failed to update the sort keys", __FUNCTION__);
+    return false;
+  }
+
+  m_sortKeyTokens = tokens;
+  m_sortKeyTokensLoaded = true;
+  return true;
+}
+
+bool CDatabase::HasSortKeys()
+{
+  // the keys only reproduce the collation without locale specific ordering
+  if (!m_sqlite || g_langInfo.UseLocaleCollation())
+    return false;
+
+  if (!m_sortKeyTokensLoaded)
+  {
+    m_sortKeyTokens = GetSingleValue("SELECT strTokens FROM sortkeytokens", m_pDS2);
+    m_sortKeyTokensLoaded = true;
+  }
+  return m_sortKeyTokens == SortUtils::GetSortKeyTokens();
+}
+
 bool CDatabase::BuildSQL(const std::string& strBaseDir,
                          const std::string& strQuery,
                          Filter& filter,
@@ -95,6 +95,17 @@ public:
     std::string where;
   };
 
+  /*! \brief A text column along with the column holding its sort key
+   \sa SortUtils::GetSortKey
+   */
+  struct SortKeyColumn
+  {
+    const char* table;
+    const char* idColumn;
+    const char* column;
+    const char* keyColumn;
+  };
+
   CDatabase();
   virtual ~CDatabase(void);
   bool IsOpen();
@@ -296,6 +307,85 @@ protected:
 
   bool BuildSQL(const std::string& strQuery, const Filter& filter, std::string& strSQL);
 
+  /*! \brief Create a full text search index over some text columns of a table.
+   The index is an FTS5 external content table, so only the index itself is stored and its rowid
+   is the id of the indexed row. Only supported on sqlite, does nothing otherwise.
+   \param searchTable name of the index.
+   \param contentTable the indexed table.
+   \param idColumn integer primary key of the indexed table.
+   \param columns the indexed columns, matches in the first one rank highest.
+   \sa CreateSearchTriggers, RebuildSearchTable, PrepareSearchJoin
+   */
+  void CreateSearchTable(const std::string& searchTable,
+                         const std::string& contentTable,
+                         const std::string& idColumn,
+                         const std::vector<std::string>& columns);
+
+  /*! \brief Create the triggers keeping a search index in sync with its table.
+   To be called from CreateAnalytics() with the arguments given to CreateSearchTable().
+   */
+  void CreateSearchTriggers(const std::string& searchTable,
+                            const std::string& contentTable,
+                            const std::string& idColumn,
+                            const std::vector<std::string>& columns);
+
+  /*! \brief Rebuild a search index from its table.
+   Needed after UpdateTables() as the triggers don't exist while the tables are updated.
+   */
+  void RebuildSearchTable(const std::string& searchTable);
+
+  bool HasSearchTable(const std::string& searchTable);
+
+  /*! \brief Turn user input into a prefix query for a search index.
+   Every word of the input must match the start of a word of the indexed text, so "beat ab"
+   finds "Abbey Road" by "The Beatles".
+   \return the query, or an empty string if the input has no words.
+   */
+  static std::string PrepareSearchMatch(const std::string& search);
+
+  /*! \brief Get a JOIN restricting a query to the rows whose indexed text matches the user input
+   The join also provides a searchRank column, ordering by it sorts the best matches first.
+   \param searchTable name of the index.
+   \param idColumn the (qualified) id column of the table being searched.
+   \param search the user input.
+   \return the join, or an empty string if the index isn't available or the input has no words,
+   in which case callers are expected to fall back to a LIKE filter.
+   */
+  std::string PrepareSearchJoin(const std::string& searchTable,
+                                const std::string& idColumn,
+                                const std::string& search);
+
+  /*! \brief Get a WHERE condition matching the rows whose indexed text matches the user input
+   Same as PrepareSearchJoin() for queries that don't need the matches ranked.
+   */
+  std::string PrepareSearchCondition(const std::string& searchTable,
+                                     const std::string& idColumn,
+                                     const std::string& search);
+
+  /*! \brief Create the table recording which articles were ignored by the stored sort keys.
+   Only supported on sqlite, as the keys are made by a function registered with the connection.
+   The tables are expected to be empty, or their keys to be refreshed with UpdateSortKeys().
+   */
+  void CreateSortKeyTable();
+
+  /*! \brief Create the index of a sort key column and the triggers keeping it up to date.
+   To be called from CreateAnalytics().
+   */
+  void CreateSortKeyTriggers(const SortKeyColumn& sortKey);
+
+  /*! \brief Refresh the sort keys that are out of date.
+   Needed after UpdateTables() as the triggers don't exist while the tables are updated, and when
+   the articles to ignore have changed. To be called within a transaction.
+   \param force check every key even if the articles to ignore are unchanged.
+   \return false on error.
+   */
+  bool UpdateSortKeys(const std::vector<SortKeyColumn>& sortKeys, bool force = false);
+
+  /*! \brief Whether the stored sort keys match the current collation and articles to ignore.
+   Callers are expected to fall back to sorting with the ALPHANUM collation otherwise.
+   */
+  bool HasSortKeys();
+
   bool m_sqlite; ///< \brief whether we use sqlite (defaults to true)
 
   std::unique_ptr<dbiplus::Database> m_pDB;
@@ -318,4 +408,7 @@ private:
 
   bool m_multipleExecute;
   std::vector<std::string> m_multipleQueries;
+
+  std::string m_sortKeyTokens; ///< articles ignored by the stored sort keys
+  bool m_sortKeyTokensLoaded = false;
 };
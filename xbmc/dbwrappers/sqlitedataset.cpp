@@ -12,6 +12,8 @@
 
 #include "sqlitedataset.h"
 
+#include "utils/Profiler.h"
+#include "utils/SortUtils.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 #include "utils/XTimeUtils.h"
@@ -310,6 +312,19 @@ static int AlphaNumericCollation(
   return StringUtils::AlphaNumericCollation(nKey1, pKey1, nKey2, pKey2);
 }
 
+// sortkey(text), the key of SortUtils::GetSortKey() to maintain sort key columns
+static void SortKeyFunction(sqlite3_context* context, int argc, sqlite3_value** argv)
+{
+  if (sqlite3_value_type(argv[0]) == SQLITE_NULL)
+  {
+    sqlite3_result_null(context);
+    return;
+  }
+  const char* text = reinterpret_cast<const char*>(sqlite3_value_text(argv[0]));
+  std::string key = SortUtils::GetSortKey(text ? text : "");
+  sqlite3_result_text(context, key.c_str(), static_cast<int>(key.size()), SQLITE_TRANSIENT);
+}
+
 int SqliteDatabase::connect(bool create)
 {
   if (host.empty() || db.empty())
@@ -351,6 +366,14 @@ int SqliteDatabase::connect(bool create)
         CLog::Log(LOGFATAL, "SqliteDatabase: can not register collation");
         throw std::runtime_error("SqliteDatabase: can not register collation " + db_fullpath);
       }
+      // not deterministic, the ignored articles are a setting
+      errorCode = sqlite3_create_function(conn, "sortkey", 1, SQLITE_UTF8, nullptr,
+                                          SortKeyFunction, nullptr, nullptr);
+      if (errorCode != SQLITE_OK)
+      {
+        CLog::Log(LOGFATAL, "SqliteDatabase: can not register function sortkey");
+        throw std::runtime_error("SqliteDatabase: can not register function " + db_fullpath);
+      }
       active = true;
       return DB_CONNECTION_OK;
     }
@@ -802,6 +825,7 @@ bool SqliteDataset::dropIndex(const char* table, const char* index)
 
 int SqliteDataset::exec(const std::string& sql)
 {
+  PROFILE_ZONE("SqliteDataset::exec");
   if (!handle())
     throw DbErrors("No Database Connection");
   std::string qry = sql;
@@ -877,6 +901,7 @@ const void* SqliteDataset::getExecRes()
 
 bool SqliteDataset::query(const std::string& query)
 {
+  PROFILE_ZONE("SqliteDataset::query");
   if (!handle())
     throw DbErrors("No Database Connection");
   const std::string& qry = query;
@@ -52,6 +52,7 @@ enum CONTEXT_BUTTON { CONTEXT_BUTTON_CANCELLED = 0,
                       CONTEXT_BUTTON_REACTIVATE_LOCK,
                       CONTEXT_BUTTON_VIEW_SLIDESHOW,
                       CONTEXT_BUTTON_RECURSIVE_SLIDESHOW,
+                      CONTEXT_BUTTON_CAMERA_SLIDESHOW,
                       CONTEXT_BUTTON_REFRESH_THUMBS,
                       CONTEXT_BUTTON_SWITCH_MEDIA,
                       CONTEXT_BUTTON_MOVE_ITEM,
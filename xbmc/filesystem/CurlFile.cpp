@@ -1987,6 +1987,11 @@ void CCurlFile::SetRequestHeader(const std::string& header, long value)
   m_requestheaders[header] = std::to_string(value);
 }
 
+void CCurlFile::RemoveRequestHeader(const std::string& header)
+{
+  m_requestheaders.erase(header);
+}
+
 std::string CCurlFile::GetURL(void)
 {
   return m_url;
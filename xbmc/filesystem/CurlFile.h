@@ -75,11 +75,13 @@ namespace XFILE
       void SetMimeType(const std::string& mimetype) { SetRequestHeader("Content-Type", mimetype); }
       void SetRequestHeader(const std::string& header, const std::string& value);
       void SetRequestHeader(const std::string& header, long value);
+      void RemoveRequestHeader(const std::string& header);
 
       void ClearRequestHeaders();
       void SetBufferSize(unsigned int size);
 
       const CHttpHeader& GetHttpHeader() const { return m_state->m_httpheader; }
+      long GetResponseCode() const { return m_httpresponse; }
       std::string GetURL(void);
       std::string GetRedirectURL();
 
@@ -16,33 +16,72 @@
 #include "utils/log.h"
 
 #include <algorithm>
-#include <climits>
+#include <iterator>
 #include <mutex>
 
-// Maximum number of directories to keep in our cache
-#define MAX_CACHED_DIRS 50
+// Estimated memory the cached directories may use. Directories cached with DIR_CACHE_ALWAYS
+// aren't evicted, and don't count. The most recently used directory is kept even if it's
+// larger on its own.
+#define DIR_CACHE_SIZE (2 * 1024 * 1024)
 
 using namespace XFILE;
 
-CDirectoryCache::CDir::CDir(DIR_CACHE_TYPE cacheType)
+namespace
+{
+std::string GetStoredPath(const std::string& strPath)
+{
+  // Get rid of any URL options, else the compare may be wrong
+  std::string storedPath = CURL(strPath).GetWithoutOptions();
+  URIUtils::RemoveSlashAtEnd(storedPath);
+  return storedPath;
+}
+
+size_t GetItemSize(const CFileItem& item)
+{
+  // the strings of an item vary the most, its details and properties are left out
+  return sizeof(CFileItem) + item.GetPath().size() + item.GetLabel().size();
+}
+} // unnamed namespace
+
+CDirectoryCache::CDir::CDir(const CFileItemList& items, DIR_CACHE_TYPE cacheType)
 {
   m_cacheType = cacheType;
-  m_lastAccess = 0;
-  m_Items = std::make_unique<CFileItemList>();
-  m_Items->SetIgnoreURLOptions(true);
-  m_Items->SetFastLookup(true);
+
+  auto cached = std::make_shared<CFileItemList>();
+  cached->Copy(items);
+  m_files.reserve(cached->Size());
+  for (const auto& item : *cached)
+  {
+    m_files.insert(CURL(item->GetPath()).GetWithoutOptions());
+    m_size += GetItemSize(*item) + item->GetPath().size(); // and its path in m_files
+  }
+  m_Items = std::move(cached);
 }
 
 CDirectoryCache::CDir::~CDir() = default;
 
-void CDirectoryCache::CDir::SetLastAccess(unsigned int &accessCounter)
+void CDirectoryCache::CDir::AddFile(const std::string& strFile)
 {
-  m_lastAccess = accessCounter++;
+  // the list may be in use by readers, so it's replaced rather than changed
+  auto items = std::make_shared<CFileItemList>();
+  items->Copy(*m_Items, false);
+  items->Append(*m_Items);
+
+  CFileItemPtr item(new CFileItem(strFile, false));
+  items->Add(item);
+  if (m_files.insert(CURL(strFile).GetWithoutOptions()).second)
+    m_size += GetItemSize(*item) + strFile.size();
+  m_Items = std::move(items);
+}
+
+bool CDirectoryCache::CDir::Contains(const std::string& strFile) const
+{
+  return m_files.find(strFile) != m_files.end();
 }
 
 CDirectoryCache::CDirectoryCache(void)
 {
-  m_accessCounter = 0;
+  m_size = 0;
 #ifdef _DEBUG
   m_cacheHits = 0;
   m_cacheMisses = 0;
@@ -53,28 +92,31 @@ CDirectoryCache::~CDirectoryCache(void) = default;
 
 bool CDirectoryCache::GetDirectory(const std::string& strPath, CFileItemList &items, bool retrieveAll)
 {
-  std::unique_lock<CCriticalSection> lock(m_cs);
+  const std::string storedPath = GetStoredPath(strPath);
 
-  // Get rid of any URL options, else the compare may be wrong
-  std::string storedPath = CURL(strPath).GetWithoutOptions();
-  URIUtils::RemoveSlashAtEnd(storedPath);
-
-  auto i = m_cache.find(storedPath);
-  if (i != m_cache.end())
+  std::shared_ptr<const CFileItemList> cached;
   {
+    std::unique_lock<CCriticalSection> lock(m_cs);
+
+    auto i = m_cache.find(storedPath);
+    if (i == m_cache.end())
+      return false;
+
     CDir& dir = i->second;
-    if (dir.m_cacheType == XFILE::DIR_CACHE_ALWAYS ||
-        (dir.m_cacheType == XFILE::DIR_CACHE_ONCE && retrieveAll))
-    {
-      items.Copy(*dir.m_Items);
-      dir.SetLastAccess(m_accessCounter);
+    if (dir.m_cacheType != XFILE::DIR_CACHE_ALWAYS &&
+        (dir.m_cacheType != XFILE::DIR_CACHE_ONCE || !retrieveAll))
+      return false;
+
+    cached = dir.m_Items;
+    Touch(dir);
 #ifdef _DEBUG
-      m_cacheHits+=items.Size();
+    m_cacheHits += cached->Size();
 #endif
-      return true;
-    }
   }
-  return false;
+
+  // callers change the items they get, so they get a copy. It's made without holding up others.
+  items.Copy(*cached);
+  return true;
 }
 
 void CDirectoryCache::SetDirectory(const std::string& strPath, const CFileItemList &items, DIR_CACHE_TYPE cacheType)
@@ -93,54 +135,50 @@ void CDirectoryCache::SetDirectory(const std::string& strPath, const CFileItemLi
   // IDEALLY, any further processing on the item would actually create a new item
   // instead of altering it, but we can't really enforce that in an easy way, so
   // this is the best solution for now.
-  std::unique_lock<CCriticalSection> lock(m_cs);
+  const std::string storedPath = GetStoredPath(strPath);
+  CDir dir(items, cacheType);
 
-  // Get rid of any URL options, else the compare may be wrong
-  std::string storedPath = CURL(strPath).GetWithoutOptions();
-  URIUtils::RemoveSlashAtEnd(storedPath);
+  std::unique_lock<CCriticalSection> lock(m_cs);
 
   ClearDirectory(storedPath);
 
-  CheckIfFull();
+  m_recent.push_front(storedPath);
+  dir.m_recent = m_recent.begin();
+  if (cacheType != DIR_CACHE_ALWAYS)
+    m_size += dir.GetSize();
+  m_cache.emplace(storedPath, std::move(dir));
 
-  CDir dir(cacheType);
-  dir.m_Items->Copy(items);
-  dir.SetLastAccess(m_accessCounter);
-  m_cache.emplace(std::make_pair(storedPath, std::move(dir)));
+  CheckIfFull();
 }
 
 void CDirectoryCache::ClearFile(const std::string& strFile)
 {
-  // Get rid of any URL options, else the compare may be wrong
-  std::string strFile2 = CURL(strFile).GetWithoutOptions();
-  URIUtils::RemoveSlashAtEnd(strFile2);
-
-  ClearDirectory(URIUtils::GetDirectory(strFile2));
+  ClearDirectory(URIUtils::GetDirectory(GetStoredPath(strFile)));
 }
 
 void CDirectoryCache::ClearDirectory(const std::string& strPath)
 {
-  std::unique_lock<CCriticalSection> lock(m_cs);
+  const std::string storedPath = GetStoredPath(strPath);
 
-  // Get rid of any URL options, else the compare may be wrong
-  std::string storedPath = CURL(strPath).GetWithoutOptions();
-  URIUtils::RemoveSlashAtEnd(storedPath);
+  std::unique_lock<CCriticalSection> lock(m_cs);
 
-  m_cache.erase(storedPath);
+  auto i = m_cache.find(storedPath);
+  if (i != m_cache.end())
+    Erase(i);
 }
 
 void CDirectoryCache::ClearSubPaths(const std::string& strPath)
 {
-  std::unique_lock<CCriticalSection> lock(m_cs);
-
   // Get rid of any URL options, else the compare may be wrong
   std::string storedPath = CURL(strPath).GetWithoutOptions();
 
+  std::unique_lock<CCriticalSection> lock(m_cs);
+
   auto i = m_cache.begin();
   while (i != m_cache.end())
   {
     if (URIUtils::PathHasParent(i->first, storedPath))
-      m_cache.erase(i++);
+      Erase(i++);
     else
       i++;
   }
@@ -148,43 +186,49 @@ void CDirectoryCache::ClearSubPaths(const std::string& strPath)
 
 void CDirectoryCache::AddFile(const std::string& strFile)
 {
-  std::unique_lock<CCriticalSection> lock(m_cs);
-
   // Get rid of any URL options, else the compare may be wrong
   std::string strPath = URIUtils::GetDirectory(CURL(strFile).GetWithoutOptions());
   URIUtils::RemoveSlashAtEnd(strPath);
 
+  std::unique_lock<CCriticalSection> lock(m_cs);
+
   auto i = m_cache.find(strPath);
   if (i != m_cache.end())
   {
     CDir& dir = i->second;
-    CFileItemPtr item(new CFileItem(strFile, false));
-    dir.m_Items->Add(item);
-    dir.SetLastAccess(m_accessCounter);
+    if (dir.m_cacheType != DIR_CACHE_ALWAYS)
+      m_size -= dir.GetSize();
+    dir.AddFile(strFile);
+    if (dir.m_cacheType != DIR_CACHE_ALWAYS)
+      m_size += dir.GetSize();
+    Touch(dir);
+    CheckIfFull();
   }
 }
 
 bool CDirectoryCache::FileExists(const std::string& strFile, bool& bInCache)
 {
-  std::unique_lock<CCriticalSection> lock(m_cs);
   bInCache = false;
 
   // Get rid of any URL options, else the compare may be wrong
-  std::string strPath = CURL(strFile).GetWithoutOptions();
+  const std::string file = CURL(strFile).GetWithoutOptions();
+  std::string strPath = file;
   URIUtils::RemoveSlashAtEnd(strPath);
   std::string storedPath = URIUtils::GetDirectory(strPath);
   URIUtils::RemoveSlashAtEnd(storedPath);
 
+  std::unique_lock<CCriticalSection> lock(m_cs);
+
   auto i = m_cache.find(storedPath);
   if (i != m_cache.end())
   {
     bInCache = true;
     CDir& dir = i->second;
-    dir.SetLastAccess(m_accessCounter);
+    Touch(dir);
 #ifdef _DEBUG
     m_cacheHits++;
 #endif
-    return (URIUtils::PathEquals(strPath, storedPath) || dir.m_Items->Contains(strFile));
+    return (URIUtils::PathEquals(strPath, storedPath) || dir.Contains(file));
   }
 #ifdef _DEBUG
   m_cacheMisses++;
@@ -197,6 +241,8 @@ void CDirectoryCache::Clear()
   // this routine clears everything
   std::unique_lock<CCriticalSection> lock(m_cs);
   m_cache.clear();
+  m_recent.clear();
+  m_size = 0;
 }
 
 void CDirectoryCache::InitCache(const std::set<std::string>& dirs)
@@ -211,11 +257,13 @@ void CDirectoryCache::InitCache(const std::set<std::string>& dirs)
 
 void CDirectoryCache::ClearCache(std::set<std::string>& dirs)
 {
+  std::unique_lock<CCriticalSection> lock(m_cs);
+
   auto i = m_cache.begin();
   while (i != m_cache.end())
   {
     if (dirs.find(i->first) != dirs.end())
-      m_cache.erase(i++);
+      Erase(i++);
     else
       i++;
   }
@@ -225,22 +273,37 @@ void CDirectoryCache::CheckIfFull()
 {
   std::unique_lock<CCriticalSection> lock(m_cs);
 
-  // find the last accessed folder, and remove if the number of cached folders is too many
-  auto lastAccessed = m_cache.end();
-  unsigned int numCached = 0;
-  for (auto i = m_cache.begin(); i != m_cache.end(); i++)
+  if (m_recent.empty())
+    return;
+
+  // remove the least recently used folders until the rest fits. The folder just cached or used
+  // stays, a large folder pushes out all others instead of never being cached.
+  auto recent = m_recent.end();
+  while (m_size > DIR_CACHE_SIZE && recent != std::next(m_recent.begin()))
   {
+    --recent;
+    auto i = m_cache.find(*recent);
     // ensure dirs that are always cached aren't cleared
-    if (i->second.m_cacheType != DIR_CACHE_ALWAYS)
-    {
-      if (lastAccessed == m_cache.end() ||
-          i->second.GetLastAccess() < lastAccessed->second.GetLastAccess())
-        lastAccessed = i;
-      numCached++;
-    }
+    if (i->second.m_cacheType == DIR_CACHE_ALWAYS)
+      continue;
+
+    // step past the folder first, its position goes away with it
+    recent = std::next(recent);
+    Erase(i);
   }
-  if (lastAccessed != m_cache.end() && numCached >= MAX_CACHED_DIRS)
-    m_cache.erase(lastAccessed);
+}
+
+void CDirectoryCache::Touch(CDir& dir)
+{
+  m_recent.splice(m_recent.begin(), m_recent, dir.m_recent);
+}
+
+void CDirectoryCache::Erase(std::unordered_map<std::string, CDir>::iterator i)
+{
+  if (i->second.m_cacheType != DIR_CACHE_ALWAYS)
+    m_size -= i->second.GetSize();
+  m_recent.erase(i->second.m_recent);
+  m_cache.erase(i);
 }
 
 #ifdef _DEBUG
@@ -249,18 +312,11 @@ void CDirectoryCache::PrintStats() const
   std::unique_lock<CCriticalSection> lock(m_cs);
   CLog::Log(LOGDEBUG, "{} - total of {} cache hits, and {} cache misses", __FUNCTION__, m_cacheHits,
             m_cacheMisses);
-  // run through and find the oldest and the number of items cached
-  unsigned int oldest = UINT_MAX;
+  // run through and find the number of items cached
   unsigned int numItems = 0;
-  unsigned int numDirs = 0;
-  for (auto i = m_cache.begin(); i != m_cache.end(); i++)
-  {
-    const CDir& dir = i->second;
-    oldest = std::min(oldest, dir.GetLastAccess());
-    numItems += dir.m_Items->Size();
-    numDirs++;
-  }
-  CLog::Log(LOGDEBUG, "{} - {} folders cached, with {} items total.  Oldest is {}, current is {}",
-            __FUNCTION__, numDirs, numItems, oldest, m_accessCounter);
+  for (const auto& i : m_cache)
+    numItems += i.second.m_Items->Size();
+  CLog::Log(LOGDEBUG, "{} - {} folders cached, with {} items total, about {} bytes",
+            __FUNCTION__, m_cache.size(), numItems, m_size);
 }
 #endif
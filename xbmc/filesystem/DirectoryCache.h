@@ -11,9 +11,12 @@
 #include "IDirectory.h"
 #include "threads/CriticalSection.h"
 
-#include <map>
+#include <list>
 #include <memory>
 #include <set>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
 
 class CFileItem;
 
@@ -24,20 +27,25 @@ namespace XFILE
     class CDir
     {
     public:
-      explicit CDir(DIR_CACHE_TYPE cacheType);
+      CDir(const CFileItemList& items, DIR_CACHE_TYPE cacheType);
       CDir(CDir&& dir) = default;
       CDir& operator=(CDir&& dir) = default;
       virtual ~CDir();
 
-      void SetLastAccess(unsigned int &accessCounter);
-      unsigned int GetLastAccess() const { return m_lastAccess; }
+      void AddFile(const std::string& strFile);
+      bool Contains(const std::string& strFile) const;
+      size_t GetSize() const { return m_size; }
 
-      std::unique_ptr<CFileItemList> m_Items;
+      /*! the cached items, never changed once cached. Readers copy them outside of the cache
+       lock, a file added to the directory replaces the list. */
+      std::shared_ptr<const CFileItemList> m_Items;
       DIR_CACHE_TYPE m_cacheType;
+      std::list<std::string>::iterator m_recent; //!< position in the recency list of the cache
     private:
       CDir(const CDir&) = delete;
       CDir& operator=(const CDir&) = delete;
-      unsigned int m_lastAccess;
+      std::unordered_set<std::string> m_files; //!< paths of the items, without URL options
+      size_t m_size = 0; //!< estimated memory use in bytes
     };
   public:
     CDirectoryCache(void);
@@ -57,13 +65,15 @@ namespace XFILE
     void InitCache(const std::set<std::string>& dirs);
     void ClearCache(std::set<std::string>& dirs);
     void CheckIfFull();
+    void Touch(CDir& dir);
+    void Erase(std::unordered_map<std::string, CDir>::iterator i);
 
-    std::map<std::string, CDir> m_cache;
+    std::unordered_map<std::string, CDir> m_cache;
+    std::list<std::string> m_recent; //!< paths of the cached directories, most recently used first
+    size_t m_size; //!< estimated memory use of the directories that may be evicted
 
     mutable CCriticalSection m_cs;
 
-    unsigned int m_accessCounter;
-
 #ifdef _DEBUG
     unsigned int m_cacheHits;
     unsigned int m_cacheMisses;
@@ -0,0 +1,321 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FileExistenceChecker.h"
+
+#include "FileItem.h"
+#include "ServiceBroker.h"
+#include "URL.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "threads/SingleLock.h"
+#include "utils/JobManager.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+
+using namespace XFILE;
+using namespace std::chrono_literals;
+
+// number of folders listed at the same time, in total and per server
+#define MAX_LISTING_JOBS 4
+#define MAX_LISTING_JOBS_PER_HOST 2
+
+namespace
+{
+
+std::string NormalizePath(const std::string& path)
+{
+  std::string normalized = CURL(path).GetWithoutOptions();
+  URIUtils::RemoveSlashAtEnd(normalized);
+  return normalized;
+}
+
+// listings may differ in case from the stored paths (FATX, SMB), compare regardless of it
+std::string GetKey(const std::string& path)
+{
+  return StringUtils::ToLower(NormalizePath(path));
+}
+
+bool ListFolder(const std::string& folder, std::vector<std::string>& entries)
+{
+  CFileItemList items;
+  if (!CDirectory::GetDirectory(folder, items, "",
+                                DIR_FLAG_NO_FILE_DIRS | DIR_FLAG_NO_FILE_INFO |
+                                    DIR_FLAG_GET_HIDDEN | DIR_FLAG_BYPASS_CACHE))
+    return false;
+
+  entries.reserve(items.Size());
+  for (int i = 0; i < items.Size(); i++)
+    entries.emplace_back(GetKey(items[i]->GetPath()));
+  std::sort(entries.begin(), entries.end());
+  return true;
+}
+
+class CFolderListingJob : public CJob
+{
+public:
+  explicit CFolderListingJob(const std::string& folder) : m_folder(folder) {}
+
+  bool DoWork() override { return ListFolder(m_folder, m_entries); }
+  const char* GetType() const override { return "folderlisting"; }
+
+  std::string m_folder;
+  std::vector<std::string> m_entries;
+};
+
+} // unnamed namespace
+
+CFileExistenceChecker::~CFileExistenceChecker()
+{
+  std::unique_lock<CCriticalSection> lock(m_critSection);
+  CancelJobs();
+}
+
+size_t CFileExistenceChecker::Add(const std::string& path)
+{
+  File file;
+  file.path = NormalizePath(path);
+  file.key = file.path;
+  StringUtils::ToLower(file.key);
+  size_t index = m_files.size();
+
+  const std::string folder = URIUtils::GetDirectory(file.path);
+  if (!folder.empty())
+  {
+    auto it = m_folders.find(folder);
+    if (it == m_folders.end())
+    {
+      CURL url(folder);
+      it = m_folders.emplace(folder, Folder()).first;
+      it->second.host = url.GetProtocol() + "://" + url.GetHostName();
+      m_pending[it->second.host].push_back(folder);
+    }
+    it->second.files.push_back(index);
+  }
+
+  m_files.emplace_back(std::move(file));
+  return index;
+}
+
+bool CFileExistenceChecker::Check(const std::function<bool(unsigned int, unsigned int)>& progress)
+{
+  auto start = std::chrono::steady_clock::now();
+
+  std::unique_lock<CCriticalSection> lock(m_critSection);
+  Dispatch();
+  while (m_jobs > 0 || !m_pending.empty())
+  {
+    if (progress)
+    {
+      unsigned int listed = m_listed;
+      unsigned int total = static_cast<unsigned int>(m_folders.size());
+      bool cont;
+      {
+        CSingleExit exit(m_critSection);
+        cont = progress(listed, total);
+      }
+      if (!cont)
+      {
+        CancelJobs();
+        return false;
+      }
+    }
+
+    {
+      CSingleExit exit(m_critSection);
+      m_jobDone.Wait(100ms);
+    }
+    Dispatch();
+  }
+
+  // all jobs are done, find out why the folders that couldn't be listed failed. The folders are
+  // only added to by Add(), so they can be walked while the lock is released around the calls
+  // to the servers.
+  unsigned int failed = 0;
+  for (const auto& it : m_folders)
+  {
+    if (!it.second.failed)
+      continue;
+
+    failed++;
+    State state = ResolveFolder(it.first);
+    // a folder missing from its parent's listing might only be named differently in it
+    if (state == State::MISSING)
+    {
+      CSingleExit exit(m_critSection);
+      if (CDirectory::Exists(it.first))
+        state = State::UNKNOWN;
+    }
+    for (size_t index : it.second.files)
+      m_files[index].state = state;
+  }
+  m_resolved.clear();
+
+  // files are deleted from the library when missing, so ask about each one before saying so
+  for (const auto& it : m_folders)
+  {
+    if (it.second.failed)
+      continue;
+
+    for (size_t index : it.second.files)
+    {
+      File& file = m_files[index];
+      if (file.state != State::MISSING)
+        continue;
+
+      CSingleExit exit(m_critSection);
+      if (CFile::Exists(file.path))
+        file.state = State::EXISTS;
+    }
+  }
+  lock.unlock();
+  const auto missing = std::count_if(m_files.begin(), m_files.end(),
+                                     [](const File& file) { return file.state == State::MISSING; });
+
+  auto end = std::chrono::steady_clock::now();
+  CLog::Log(LOGDEBUG,
+            "CFileExistenceChecker: checked {} files in {} folders ({} failed, {} missing) in {} ms",
+            m_files.size(), m_folders.size(), failed, missing,
+            std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count());
+
+  if (progress)
+    progress(m_listed, static_cast<unsigned int>(m_folders.size()));
+  return true;
+}
+
+void CFileExistenceChecker::OnJobComplete(unsigned int jobID, bool success, CJob* job)
+{
+  std::unique_lock<CCriticalSection> lock(m_critSection);
+  CFolderListingJob* listingJob = static_cast<CFolderListingJob*>(job);
+  auto it = m_folders.find(listingJob->m_folder);
+  if (it == m_folders.end() || it->second.jobID != jobID)
+    return;
+
+  m_running[it->second.host]--;
+  m_jobs--;
+  Apply(it->first, success, listingJob->m_entries);
+  m_jobDone.Set();
+}
+
+void CFileExistenceChecker::Dispatch()
+{
+  std::vector<std::string> unqueued;
+  for (auto it = m_pending.begin(); it != m_pending.end();)
+  {
+    std::vector<std::string>& folders = it->second;
+    unsigned int& running = m_running[it->first];
+    while (!folders.empty() && running < MAX_LISTING_JOBS_PER_HOST && m_jobs < MAX_LISTING_JOBS)
+    {
+      const std::string folder = folders.back();
+      folders.pop_back();
+
+      unsigned int jobID = CServiceBroker::GetJobManager()->AddJob(new CFolderListingJob(folder),
+                                                                   this, CJob::PRIORITY_NORMAL);
+      if (!jobID)
+      {
+        unqueued.push_back(folder);
+        continue;
+      }
+
+      m_folders[folder].jobID = jobID;
+      running++;
+      m_jobs++;
+    }
+
+    if (folders.empty())
+      it = m_pending.erase(it);
+    else
+      ++it;
+  }
+
+  // no job manager, list the folders ourselves without holding up the others
+  for (const std::string& folder : unqueued)
+  {
+    std::vector<std::string> entries;
+    bool success;
+    {
+      CSingleExit exit(m_critSection);
+      success = ListFolder(folder, entries);
+    }
+    Apply(folder, success, entries);
+  }
+}
+
+void CFileExistenceChecker::Apply(const std::string& folder,
+                                  bool success,
+                                  const std::vector<std::string>& entries)
+{
+  Folder& listed = m_folders[folder];
+  listed.jobID = 0;
+  m_listed++;
+
+  if (!success)
+  {
+    listed.failed = true;
+    return;
+  }
+
+  for (size_t index : listed.files)
+  {
+    File& file = m_files[index];
+    file.state = std::binary_search(entries.begin(), entries.end(), file.key) ? State::EXISTS
+                                                                              : State::MISSING;
+  }
+}
+
+CFileExistenceChecker::State CFileExistenceChecker::ResolveFolder(const std::string& folder)
+{
+  auto it = m_resolved.find(folder);
+  if (it != m_resolved.end())
+    return it->second;
+
+  // never look beyond the root of a server, it's simply unreachable
+  State state = State::UNKNOWN;
+  std::string parent;
+  if (!CURL(folder).GetFileName().empty() && URIUtils::GetParentPath(folder, parent) &&
+      !parent.empty() && !URIUtils::PathEquals(parent, folder))
+  {
+    std::vector<std::string> entries;
+    bool listed;
+    {
+      CSingleExit exit(m_critSection);
+      listed = ListFolder(parent, entries);
+    }
+    if (listed)
+    {
+      // a folder that is there but can't be listed might be back later
+      if (!std::binary_search(entries.begin(), entries.end(), GetKey(folder)))
+        state = State::MISSING;
+    }
+    else if (ResolveFolder(parent) == State::MISSING)
+      state = State::MISSING;
+  }
+
+  m_resolved[folder] = state;
+  return state;
+}
+
+void CFileExistenceChecker::CancelJobs()
+{
+  for (auto& it : m_folders)
+  {
+    if (it.second.jobID)
+    {
+      CServiceBroker::GetJobManager()->CancelJob(it.second.jobID);
+      it.second.jobID = 0;
+    }
+  }
+  m_pending.clear();
+  m_running.clear();
+  m_jobs = 0;
+}
@@ -0,0 +1,102 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "utils/Job.h"
+
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace XFILE
+{
+/*!
+ \brief Checks whether many files exist by listing their folders once.
+
+ Asking every file with CFile::Exists() costs a round-trip to the server per file on network
+ shares. Here the files are grouped by folder, each folder is listed once, a few folders at a
+ time per server, and the answers come from the listings.
+
+ A folder that can't be listed is looked up in its parent folder, and so on up to the root of
+ the share. Files are only reported missing when some folder above them could be listed, so
+ nothing is reported missing while a share is offline.
+
+ Paths are compared regardless of case. A file or folder missing from a listing is still asked
+ for with CFile::Exists() or CDirectory::Exists() before it is reported missing.
+ */
+class CFileExistenceChecker : public IJobCallback
+{
+public:
+  enum class State
+  {
+    EXISTS,
+    MISSING,
+    UNKNOWN ///< the share couldn't be reached
+  };
+
+  CFileExistenceChecker() = default;
+  ~CFileExistenceChecker() override;
+
+  /*! \brief Add a file to check
+   \return the index of the file, to get its state with GetState() after Check().
+   */
+  size_t Add(const std::string& path);
+
+  /*! \brief List the folders of all the files added
+   \param progress called regularly with the number of folders listed and the total number of
+   folders, return false to cancel.
+   \return false if cancelled, true otherwise.
+   */
+  bool Check(const std::function<bool(unsigned int, unsigned int)>& progress = nullptr);
+
+  State GetState(size_t index) const { return m_files[index].state; }
+  size_t Size() const { return m_files.size(); }
+
+  void OnJobComplete(unsigned int jobID, bool success, CJob* job) override;
+
+private:
+  CFileExistenceChecker(const CFileExistenceChecker&) = delete;
+  CFileExistenceChecker& operator=(const CFileExistenceChecker&) = delete;
+
+  struct File
+  {
+    std::string path;
+    std::string key; ///< to look up in listings
+    State state = State::UNKNOWN;
+  };
+
+  struct Folder
+  {
+    std::vector<size_t> files;
+    std::string host;
+    unsigned int jobID = 0;
+    bool failed = false;
+  };
+
+  // called with m_critSection held, which is released around the calls to the servers
+  void Dispatch();
+  void Apply(const std::string& folder, bool success, const std::vector<std::string>& entries);
+  State ResolveFolder(const std::string& folder);
+  void CancelJobs();
+
+  std::vector<File> m_files;
+  std::map<std::string, Folder> m_folders;
+  std::map<std::string, std::vector<std::string>> m_pending; ///< folders to list, by host
+  std::map<std::string, unsigned int> m_running; ///< jobs listing folders, by host
+  std::map<std::string, State> m_resolved; ///< folders looked up in their parent
+  unsigned int m_jobs = 0;
+  unsigned int m_listed = 0;
+
+  CCriticalSection m_critSection;
+  CEvent m_jobDone;
+};
+} // namespace XFILE
@@ -0,0 +1,400 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "HttpCache.h"
+
+#include "CurlFile.h"
+#include "Directory.h"
+#include "File.h"
+#include "FileItem.h"
+#include "URL.h"
+#include "utils/Digest.h"
+#include "utils/HostRateLimiter.h"
+#include "utils/HttpHeader.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <mutex>
+#include <vector>
+
+#define HTTP_CACHE_PATH "special://temp/httpcache/"
+// size budget of the cache, and of a single response in it
+#define HTTP_CACHE_SIZE (32 * 1024 * 1024)
+#define HTTP_CACHE_MAX_ENTRY (4 * 1024 * 1024)
+// longest time a response without an explicit lifetime is assumed to stay fresh
+#define HTTP_CACHE_HEURISTIC_LIFETIME (24 * 60 * 60)
+// the use time in the files only needs to be good enough to evict, it's written at most hourly
+#define HTTP_CACHE_USED_INTERVAL 60
+
+using namespace XFILE;
+using KODI::UTILITY::CDigest;
+
+namespace
+{
+/*!
+ \brief Get how long a response stays fresh, in seconds
+ \return false if the response must not be cached at all
+ */
+bool GetLifetime(const CHttpHeader& headers, int& lifetime)
+{
+  lifetime = 0;
+
+  int maxAge = -1;
+  bool noCache = false;
+  for (std::string directive : StringUtils::Split(headers.GetValue("cache-control"), ','))
+  {
+    StringUtils::Trim(directive);
+    StringUtils::ToLower(directive);
+    if (directive == "no-store")
+      return false;
+    else if (directive == "no-cache")
+      noCache = true;
+    else if (StringUtils::StartsWith(directive, "max-age="))
+      maxAge = atoi(directive.c_str() + 8);
+  }
+
+  // no-cache responses may be stored, but are revalidated every time
+  if (noCache)
+    return true;
+
+  if (maxAge >= 0)
+  {
+    lifetime = maxAge - atoi(headers.GetValue("age").c_str());
+    return true;
+  }
+
+  // dates of the server are compared with each other, its clock may be off from ours
+  CDateTime date = CDateTime::FromRFC1123DateTime(headers.GetValue("date"));
+  if (!date.IsValid())
+    date = CDateTime::GetUTCDateTime();
+
+  const std::string expiresHeader = headers.GetValue("expires");
+  if (!expiresHeader.empty())
+  {
+    // an invalid date (like "0") means the response has expired already
+    const CDateTime expires = CDateTime::FromRFC1123DateTime(expiresHeader);
+    if (expires.IsValid())
+      lifetime = (expires - date).GetSecondsTotal();
+    return true;
+  }
+
+  // a tenth of the time since the last modification, as browsers do
+  const CDateTime lastModified =
+      CDateTime::FromRFC1123DateTime(headers.GetValue("last-modified"));
+  if (lastModified.IsValid() && lastModified < date)
+    lifetime = std::min((date - lastModified).GetSecondsTotal() / 10,
+                        HTTP_CACHE_HEURISTIC_LIFETIME);
+  return true;
+}
+} // namespace
+
+CHttpCache& CHttpCache::GetInstance()
+{
+  static CHttpCache cache;
+  return cache;
+}
+
+bool CHttpCache::Get(CCurlFile& http,
+                     const std::string& url,
+                     std::string& data,
+                     CHttpHeader& headers,
+                     CHostRateLimiter* limiter /* = nullptr */,
+                     bool revalidate /* = false */)
+{
+  const std::string key = CDigest::Calculate(CDigest::Type::MD5, url);
+
+  bool cached;
+  unsigned int write = 0;
+  {
+    std::unique_lock<CCriticalSection> lock(m_critSection);
+    Load();
+    auto it = m_entries.find(key);
+    cached = it != m_entries.end();
+    if (cached)
+      write = it->second.write;
+  }
+
+  // the lock only guards the index, responses are read and written without holding it
+  CDateTime expires;
+  CHttpHeader cachedHeaders;
+  std::string cachedData;
+  size_t usedOffset = 0;
+  cached = cached && ReadEntry(key, write, url, expires, cachedHeaders, cachedData, usedOffset);
+  if (cached && !revalidate && CDateTime::GetUTCDateTime() < expires)
+  {
+    std::unique_lock<CCriticalSection> lock(m_critSection);
+    m_stats.hits++;
+    UpdateUsed(key, usedOffset);
+    data = std::move(cachedData);
+    headers = cachedHeaders;
+    return true;
+  }
+
+  const std::string etag = cached ? cachedHeaders.GetValue("etag") : "";
+  const std::string lastModified = cached ? cachedHeaders.GetValue("last-modified") : "";
+  if (!etag.empty())
+    http.SetRequestHeader("If-None-Match", etag);
+  if (!lastModified.empty())
+    http.SetRequestHeader("If-Modified-Since", lastModified);
+
+  if (limiter)
+    limiter->Acquire(CURL(url).GetHostName());
+
+  std::string response;
+  const bool success = http.Get(url, response);
+  http.RemoveRequestHeader("If-None-Match");
+  http.RemoveRequestHeader("If-Modified-Since");
+  if (!success)
+    return false;
+
+  const CHttpHeader& responseHeaders = http.GetHttpHeader();
+  int lifetime;
+  if (cached && http.GetResponseCode() == 304)
+  {
+    // a 304 answer carries the current caching headers of the cached response
+    for (const char* name : {"cache-control", "date", "etag", "expires", "last-modified"})
+    {
+      const std::string value = responseHeaders.GetValue(name);
+      if (!value.empty())
+        cachedHeaders.AddParam(name, value, true);
+    }
+    cachedHeaders.AddParam("age", responseHeaders.GetValue("age"), true);
+
+    {
+      std::unique_lock<CCriticalSection> lock(m_critSection);
+      m_stats.revalidated++;
+    }
+    if (GetLifetime(cachedHeaders, lifetime))
+      WriteEntry(key, url,
+                 CDateTime::GetUTCDateTime() + CDateTimeSpan(0, 0, 0, std::max(lifetime, 0)),
+                 cachedHeaders, cachedData);
+    else
+    {
+      std::unique_lock<CCriticalSection> lock(m_critSection);
+      RemoveEntry(key);
+    }
+
+    CLog::Log(LOGDEBUG, "CHttpCache: {} not modified", CURL::GetRedacted(url));
+    data = std::move(cachedData);
+    headers = cachedHeaders;
+    return true;
+  }
+
+  data = std::move(response);
+  headers = responseHeaders;
+
+  // only worth keeping if it can be served as it is, or revalidated. Responses varying with
+  // request headers are not kept, the cache has a single response per url.
+  const bool store = http.GetResponseCode() == 200 && GetLifetime(headers, lifetime) &&
+                     (lifetime > 0 || !headers.GetValue("etag").empty() ||
+                      !headers.GetValue("last-modified").empty()) &&
+                     headers.GetValue("vary").empty() && data.size() <= HTTP_CACHE_MAX_ENTRY &&
+                     !headers.GetProtoLine().empty();
+
+  {
+    std::unique_lock<CCriticalSection> lock(m_critSection);
+    m_stats.misses++;
+    if (!store && cached)
+      RemoveEntry(key);
+  }
+  if (store)
+    WriteEntry(key, url,
+               CDateTime::GetUTCDateTime() + CDateTimeSpan(0, 0, 0, std::max(lifetime, 0)),
+               headers, data);
+
+  return true;
+}
+
+CHttpCache::Stats CHttpCache::GetStats() const
+{
+  std::unique_lock<CCriticalSection> lock(m_critSection);
+  return m_stats;
+}
+
+void CHttpCache::Load()
+{
+  if (m_loaded)
+    return;
+  m_loaded = true;
+
+  if (!CDirectory::Exists(HTTP_CACHE_PATH))
+  {
+    CDirectory::Create(HTTP_CACHE_PATH);
+    return;
+  }
+
+  // responses are only read when used, the listing is enough to know what's in the cache
+  CFileItemList items;
+  CDirectory::GetDirectory(HTTP_CACHE_PATH, items, "",
+                           DIR_FLAG_NO_FILE_DIRS | DIR_FLAG_BYPASS_CACHE);
+  for (const auto& item : items)
+  {
+    if (item->m_bIsFolder)
+      continue;
+
+    // left behind by an interrupted write
+    if (URIUtils::HasExtension(item->GetPath(), ".tmp"))
+    {
+      CFile::Delete(item->GetPath());
+      continue;
+    }
+
+    // the file is written when the response is used, its time is the time it was last used
+    m_entries[URIUtils::GetFileName(item->GetPath())] = {static_cast<uint64_t>(item->m_dwSize),
+                                                          item->m_dateTime, item->m_dateTime};
+    m_stats.size += item->m_dwSize;
+  }
+  Evict();
+}
+
+bool CHttpCache::ReadEntry(const std::string& key,
+                           unsigned int write,
+                           const std::string& url,
+                           CDateTime& expires,
+                           CHttpHeader& headers,
+                           std::string& data,
+                           size_t& usedOffset)
+{
+  // url, expiry date, last use date and headers of the response are followed by its body
+  CFile file;
+  std::vector<uint8_t> buffer;
+  if (file.LoadFile(HTTP_CACHE_PATH + key, buffer) > 0)
+  {
+    const std::string entry(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+    const size_t urlEnd = entry.find('\n');
+    const size_t expiresEnd =
+        urlEnd != std::string::npos ? entry.find('\n', urlEnd + 1) : std::string::npos;
+    const size_t usedEnd =
+        expiresEnd != std::string::npos ? entry.find('\n', expiresEnd + 1) : std::string::npos;
+    const size_t headersEnd =
+        usedEnd != std::string::npos ? entry.find("\r\n\r\n", usedEnd + 1) : std::string::npos;
+    if (headersEnd != std::string::npos && entry.compare(0, urlEnd, url) == 0 &&
+        expires.SetFromDBDateTime(entry.substr(urlEnd + 1, expiresEnd - urlEnd - 1)))
+    {
+      // only written over with a date of the same length
+      const size_t usedLength = CDateTime::GetCurrentDateTime().GetAsDBDateTime().size();
+      usedOffset = usedEnd - expiresEnd - 1 == usedLength ? expiresEnd + 1 : 0;
+      headers.Parse(entry.substr(usedEnd + 1, headersEnd + 4 - usedEnd - 1));
+      data = entry.substr(headersEnd + 4);
+      return true;
+    }
+  }
+
+  // the response may have been replaced while it was read, keep the new one
+  std::unique_lock<CCriticalSection> lock(m_critSection);
+  auto it = m_entries.find(key);
+  if (it == m_entries.end() || it->second.write != write)
+    return false;
+
+  CLog::Log(LOGWARNING, "CHttpCache: dropping unreadable response {}", key);
+  RemoveEntry(key);
+  return false;
+}
+
+void CHttpCache::WriteEntry(const std::string& key,
+                            const std::string& url,
+                            const CDateTime& expires,
+                            const CHttpHeader& headers,
+                            const std::string& data)
+{
+  // written to a file of its own, readers of the current response are not disturbed
+  unsigned int write;
+  {
+    std::unique_lock<CCriticalSection> lock(m_critSection);
+    write = ++m_writes;
+  }
+  const std::string tempPath = HTTP_CACHE_PATH + key + "." + std::to_string(write) + ".tmp";
+
+  const CDateTime now = CDateTime::GetCurrentDateTime();
+  const std::string entry = url + '\n' + expires.GetAsDBDateTime() + '\n' +
+                            now.GetAsDBDateTime() + '\n' + headers.GetHeader();
+  CFile file;
+  if (!file.OpenForWrite(tempPath, true) ||
+      file.Write(entry.data(), entry.size()) != static_cast<ssize_t>(entry.size()) ||
+      file.Write(data.data(), data.size()) != static_cast<ssize_t>(data.size()))
+  {
+    CLog::Log(LOGERROR, "CHttpCache: unable to store response of {}", CURL::GetRedacted(url));
+    file.Close();
+    CFile::Delete(tempPath);
+    return;
+  }
+  file.Close();
+
+  std::unique_lock<CCriticalSection> lock(m_critSection);
+  RemoveEntry(key);
+  if (!CFile::Rename(tempPath, HTTP_CACHE_PATH + key))
+  {
+    CLog::Log(LOGERROR, "CHttpCache: unable to store response of {}", CURL::GetRedacted(url));
+    CFile::Delete(tempPath);
+    return;
+  }
+
+  const uint64_t size = entry.size() + data.size();
+  m_entries[key] = {size, now, now, write};
+  m_stats.size += size;
+  Evict();
+}
+
+void CHttpCache::UpdateUsed(const std::string& key, size_t usedOffset)
+{
+  auto it = m_entries.find(key);
+  if (it == m_entries.end())
+    return;
+
+  Entry& entry = it->second;
+  entry.used = CDateTime::GetCurrentDateTime();
+  if (usedOffset == 0 ||
+      entry.used - entry.stored < CDateTimeSpan(0, 0, HTTP_CACHE_USED_INTERVAL, 0))
+    return;
+
+  // overwriting the date in place also updates the modification time Load() goes by. Done with
+  // the lock held, so that the file isn't replaced while it's written to.
+  const std::string used = entry.used.GetAsDBDateTime();
+  CFile file;
+  if (file.OpenForWrite(HTTP_CACHE_PATH + key, false) &&
+      file.Seek(usedOffset, SEEK_SET) == static_cast<int64_t>(usedOffset) &&
+      file.Write(used.data(), used.size()) == static_cast<ssize_t>(used.size()))
+    entry.stored = entry.used;
+}
+
+void CHttpCache::RemoveEntry(const std::string& key)
+{
+  auto it = m_entries.find(key);
+  if (it == m_entries.end())
+    return;
+
+  CFile::Delete(HTTP_CACHE_PATH + key);
+  m_stats.size -= it->second.size;
+  m_entries.erase(it);
+}
+
+void CHttpCache::Evict()
+{
+  if (m_stats.size <= HTTP_CACHE_SIZE)
+    return;
+
+  // make some room at once rather than evicting a response for every one stored
+  std::vector<std::pair<CDateTime, std::string>> entries;
+  entries.reserve(m_entries.size());
+  for (const auto& entry : m_entries)
+    entries.emplace_back(entry.second.used, entry.first);
+  std::sort(entries.begin(), entries.end());
+
+  for (const auto& entry : entries)
+  {
+    if (m_stats.size <= HTTP_CACHE_SIZE / 4 * 3)
+      break;
+    RemoveEntry(entry.second);
+    m_stats.evicted++;
+  }
+  CLog::Log(LOGDEBUG, "CHttpCache: {} hits, {} revalidated, {} misses, {} evicted, {} bytes",
+            m_stats.hits, m_stats.revalidated, m_stats.misses, m_stats.evicted, m_stats.size);
+}
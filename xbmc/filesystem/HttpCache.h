@@ -0,0 +1,105 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "XBDateTime.h"
+#include "threads/CriticalSection.h"
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+class CHostRateLimiter;
+class CHttpHeader;
+
+namespace XFILE
+{
+class CCurlFile;
+
+/*!
+ \brief Persistent cache of HTTP responses in front of CCurlFile.
+
+ Responses are kept in special://temp/httpcache/ together with their headers. A response still
+ fresh according to its Cache-Control or Expires headers is served without a request. A stale
+ one is revalidated with If-None-Match / If-Modified-Since, and served from the cache again if
+ the server answers 304 Not Modified. Responses with a Vary header are not kept. The least
+ recently used responses are dropped once the cache grows beyond its size budget. The time a
+ response was last used is written to its file, so that it survives restarts.
+ */
+class CHttpCache
+{
+public:
+  struct Stats
+  {
+    unsigned int hits = 0; ///< served from the cache without a request
+    unsigned int revalidated = 0; ///< served from the cache after a 304 answer
+    unsigned int misses = 0; ///< downloaded
+    unsigned int evicted = 0;
+    uint64_t size = 0; ///< of all cached responses, once the cache is in use
+  };
+
+  static CHttpCache& GetInstance();
+
+  /*!
+   \brief Get a http(s) url through the cache
+   \param http the curl file to download with, request headers set on it are sent along.
+   \param url the url to get.
+   \param data [out] the body of the response.
+   \param headers [out] the headers of the response, those cached if it wasn't downloaded.
+   \param limiter if set, requests made to the server wait for it first.
+   \param revalidate revalidate a cached response with the server even while it's fresh.
+   \return true on success, false if the download failed.
+   */
+  bool Get(CCurlFile& http,
+           const std::string& url,
+           std::string& data,
+           CHttpHeader& headers,
+           CHostRateLimiter* limiter = nullptr,
+           bool revalidate = false);
+
+  Stats GetStats() const;
+
+private:
+  CHttpCache() = default;
+  CHttpCache(const CHttpCache&) = delete;
+  CHttpCache& operator=(const CHttpCache&) = delete;
+
+  struct Entry
+  {
+    uint64_t size;
+    CDateTime used;
+    CDateTime stored; ///< use time last written to the file
+    unsigned int write = 0; ///< m_writes of the write that stored it, 0 if found by Load()
+  };
+
+  void Load();
+  // ReadEntry and WriteEntry are called without holding m_critSection, they lock it themselves
+  bool ReadEntry(const std::string& key,
+                 unsigned int write,
+                 const std::string& url,
+                 CDateTime& expires,
+                 CHttpHeader& headers,
+                 std::string& data,
+                 size_t& usedOffset);
+  void WriteEntry(const std::string& key,
+                  const std::string& url,
+                  const CDateTime& expires,
+                  const CHttpHeader& headers,
+                  const std::string& data);
+  void UpdateUsed(const std::string& key, size_t usedOffset);
+  void RemoveEntry(const std::string& key);
+  void Evict();
+
+  mutable CCriticalSection m_critSection;
+  bool m_loaded = false;
+  std::map<std::string, Entry> m_entries; ///< by MD5 of the url
+  Stats m_stats;
+  unsigned int m_writes = 0; ///< counts the writes, names their temporary files
+};
+} // namespace XFILE
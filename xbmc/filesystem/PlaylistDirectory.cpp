@@ -39,7 +39,7 @@ bool CPlaylistDirectory::GetDirectory(const CURL& url, CFileItemList &items)
     CFileItemPtr item = playlist[i];
     item->SetProperty("playlistposition", i);
     item->SetProperty("playlisttype", playlistId);
-    //item->m_iprogramCount = i; // the programCount is set as items are added!
+    item->m_iprogramCount = playlist.GetOrder(i); // the playlist keeps the orders, not its items
     items.Add(item);
   }
 
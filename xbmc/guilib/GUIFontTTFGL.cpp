@@ -56,6 +56,12 @@ void CGUIFontTTFGL::Begin()
 {
   if (m_nestedBeginCount == 0 && m_texture != NULL)
   {
+#ifdef HAS_GL
+    // uploading changes the bound texture, so draw the quads batched with the current state first
+    if (m_textureStatus != TEXTURE_READY)
+      g_graphicsContext.GetRenderBatch().Finish();
+#endif
+
     if (m_textureStatus == TEXTURE_REALLOCATED)
     {
       if (glIsTexture(m_nTexture))
@@ -96,49 +102,11 @@ void CGUIFontTTFGL::Begin()
       m_textureStatus = TEXTURE_READY;
     }
 
+#ifdef HAS_GLES
     // Turn Blending On
     // glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE_MINUS_DST_ALPHA, GL_ONE);
     glEnable(GL_BLEND);
-#ifdef HAS_GL
-    glEnable(GL_TEXTURE_2D);
-#endif
     glBindTexture(GL_TEXTURE_2D, m_nTexture);
-
-#ifdef HAS_GL
-    glTexEnvi(GL_TEXTURE_ENV,GL_TEXTURE_ENV_MODE,GL_COMBINE);
-    glTexEnvi(GL_TEXTURE_ENV,GL_COMBINE_RGB,GL_REPLACE);
-    glTexEnvi(GL_TEXTURE_ENV, GL_SOURCE0_RGB, GL_PRIMARY_COLOR);
-    glTexEnvi(GL_TEXTURE_ENV, GL_OPERAND0_RGB, GL_SRC_COLOR);
-    glTexEnvi(GL_TEXTURE_ENV, GL_COMBINE_ALPHA, GL_MODULATE);
-    glTexEnvi(GL_TEXTURE_ENV, GL_SOURCE0_ALPHA, GL_TEXTURE0);
-    glTexEnvi(GL_TEXTURE_ENV, GL_OPERAND0_ALPHA, GL_SRC_ALPHA);
-    glTexEnvi(GL_TEXTURE_ENV, GL_SOURCE1_ALPHA, GL_PRIMARY_COLOR);
-    glTexEnvi(GL_TEXTURE_ENV, GL_OPERAND1_ALPHA, GL_SRC_ALPHA);
-    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-    VerifyGLState();
-
-#ifndef _XBOX
-    if(g_Windowing.UseLimitedColor())
-#endif
-    {
-      glActiveTexture(GL_TEXTURE1);
-      glBindTexture(GL_TEXTURE_2D, m_nTexture); // dummy bind
-      glEnable(GL_TEXTURE_2D);
-
-      const GLfloat rgba[4] = {16.0f / 255.0f, 16.0f / 255.0f, 16.0f / 255.0f, 0.0f};
-      glTexEnvi (GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE , GL_COMBINE);
-      glTexEnvfv(GL_TEXTURE_ENV, GL_TEXTURE_ENV_COLOR, rgba);
-      glTexEnvi (GL_TEXTURE_ENV, GL_COMBINE_RGB      , GL_ADD);
-      glTexEnvi (GL_TEXTURE_ENV, GL_SOURCE0_RGB      , GL_PREVIOUS);
-      glTexEnvi (GL_TEXTURE_ENV, GL_SOURCE1_RGB      , GL_CONSTANT);
-      glTexEnvi (GL_TEXTURE_ENV, GL_OPERAND0_RGB     , GL_SRC_COLOR);
-      glTexEnvi (GL_TEXTURE_ENV, GL_OPERAND1_RGB     , GL_SRC_COLOR);
-      glTexEnvi (GL_TEXTURE_ENV, GL_COMBINE_ALPHA    , GL_REPLACE);
-      glTexEnvi (GL_TEXTURE_ENV, GL_SOURCE0_ALPHA    , GL_PREVIOUS);
-      VerifyGLState();
-    }
-
-#else
     g_Windowing.EnableGUIShader(SM_FONTS);
 #endif
 
@@ -157,23 +125,31 @@ void CGUIFontTTFGL::End()
     return;
 
 #ifdef HAS_GL
-  // glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
-
-  glColorPointer   (4, GL_UNSIGNED_BYTE, sizeof(SVertex), (char*)m_vertex + offsetof(SVertex, r));
-  glVertexPointer  (3, GL_FLOAT        , sizeof(SVertex), (char*)m_vertex + offsetof(SVertex, x));
-  glTexCoordPointer(2, GL_FLOAT        , sizeof(SVertex), (char*)m_vertex + offsetof(SVertex, u));
-  glEnableClientState(GL_COLOR_ARRAY);
-  glEnableClientState(GL_VERTEX_ARRAY);
-  glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-  glDrawArrays(GL_QUADS, 0, m_vertex_count);
-  // glPopClientAttrib();
-
-  glActiveTexture(GL_TEXTURE1);
-  glBindTexture(GL_TEXTURE_2D, 0);
-  glDisable(GL_TEXTURE_2D);
-  glActiveTexture(GL_TEXTURE0);
-  glBindTexture(GL_TEXTURE_2D, 0);
-  glDisable(GL_TEXTURE_2D);
+  // the glyphs are drawn by the render batch, merged with the text of the controls around using
+  // the same font
+  GUIRenderState state;
+  state.mode = GUIRenderState::MODE_FONT;
+  state.texture = m_nTexture;
+
+  CGUIRenderBatch& batch = g_graphicsContext.GetRenderBatch();
+  for (int i = 0; i < m_vertex_count; i += 4)
+  {
+    GUIRenderVertex* v = batch.AddQuads(state);
+    for (int j = 0; j < 4; j++)
+    {
+      const SVertex& vertex = m_vertex[i + j];
+      v[j].x = vertex.x;
+      v[j].y = vertex.y;
+      v[j].z = vertex.z;
+      v[j].r = vertex.r;
+      v[j].g = vertex.g;
+      v[j].b = vertex.b;
+      v[j].a = vertex.a;
+      v[j].u = vertex.u;
+      v[j].v = vertex.v;
+      v[j].u2 = v[j].v2 = 0.0f;
+    }
+  }
 #else
   // GLES 2.0 version. Cannot draw quads. Convert to triangles.
   GLint posLoc  = g_Windowing.GUIShaderGetPos();
@@ -0,0 +1,112 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "GUIRenderBatch.h"
+
+#include "system.h"
+
+// quads collected before they are drawn regardless of state changes, 128kB of vertices
+#define MAX_BATCH_QUADS 1024
+
+void CGUIRenderBackendRecorder::Draw(const GUIRenderState& state,
+                                     const GUIRenderVertex* vertices,
+                                     unsigned int count)
+{
+  if (!m_applied || state != m_state)
+  {
+    m_state = state;
+    m_applied = true;
+    m_counters.stateChanges++;
+  }
+  m_counters.draws++;
+  m_counters.quads += count / 4;
+
+  uint32_t checksum = m_counters.checksum * 31 + state.mode + state.texture * 7 + state.diffuse;
+  for (const GUIRenderVertex* vertex = vertices; vertex != vertices + count; ++vertex)
+  {
+    checksum = checksum * 31 + static_cast<int>(vertex->x + vertex->y * 2 + vertex->z);
+    checksum = checksum * 31 +
+               ((static_cast<uint32_t>(vertex->r) << 24) | (vertex->g << 16) | (vertex->b << 8) | vertex->a);
+    checksum = checksum * 31 + static_cast<int>((vertex->u + vertex->v * 2) * 65536);
+    checksum = checksum * 31 + static_cast<int>((vertex->u2 + vertex->v2 * 2) * 65536);
+  }
+  m_counters.checksum = checksum;
+}
+
+void CGUIRenderBackendRecorder::Reset()
+{
+  m_counters.flushes++;
+  m_applied = false;
+}
+
+void CGUIRenderBackendRecorder::Clear()
+{
+  m_counters = Counters();
+  m_applied = false;
+}
+
+CGUIRenderBatch::CGUIRenderBatch() : m_backend(CreateBackend())
+{
+}
+
+CGUIRenderBatch::~CGUIRenderBatch() = default;
+
+GUIRenderVertex* CGUIRenderBatch::AddQuads(const GUIRenderState& state, unsigned int quads)
+{
+  if (state != m_state || m_vertices.size() / 4 + quads > MAX_BATCH_QUADS)
+  {
+    Flush();
+    m_state = state;
+  }
+
+  if (m_vertices.capacity() == 0)
+    m_vertices.reserve(MAX_BATCH_QUADS * 4);
+
+  size_t first = m_vertices.size();
+  m_vertices.resize(first + quads * 4);
+  return &m_vertices[first];
+}
+
+void CGUIRenderBatch::Flush()
+{
+  if (m_vertices.empty())
+    return;
+
+  if (m_backend)
+  {
+    m_backend->Draw(m_state, m_vertices.data(), static_cast<unsigned int>(m_vertices.size()));
+    m_dirty = true;
+  }
+  m_vertices.clear();
+}
+
+void CGUIRenderBatch::Finish()
+{
+  Flush();
+  if (m_dirty)
+  {
+    m_backend->Reset();
+    m_dirty = false;
+  }
+}
+
+std::unique_ptr<IGUIRenderBackend> CGUIRenderBatch::SetBackend(
+    std::unique_ptr<IGUIRenderBackend> backend)
+{
+  Finish();
+  std::swap(m_backend, backend);
+  return backend;
+}
+
+#if !defined(HAS_GL)
+std::unique_ptr<IGUIRenderBackend> CGUIRenderBatch::CreateBackend()
+{
+  // no backend for this render system yet, quads are dropped
+  return nullptr;
+}
+#endif
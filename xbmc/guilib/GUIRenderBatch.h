@@ -0,0 +1,149 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/*!
+ \ingroup textures
+ \brief The render state shared by the quads of one draw call.
+ */
+struct GUIRenderState
+{
+  enum Mode
+  {
+    MODE_TEXTURE, ///< texture modulated by the vertex color, optionally by a diffuse texture
+    MODE_FONT     ///< vertex color with the alpha of a glyph texture
+  };
+
+  Mode mode = MODE_TEXTURE;
+  unsigned int texture = 0; ///< hardware texture object
+  unsigned int diffuse = 0; ///< hardware texture object of the diffuse texture, 0 if none
+
+  bool operator==(const GUIRenderState& right) const
+  {
+    return mode == right.mode && texture == right.texture && diffuse == right.diffuse;
+  }
+  bool operator!=(const GUIRenderState& right) const { return !(*this == right); }
+};
+
+/*!
+ \ingroup textures
+ \brief Vertex of a batched quad, quads are 4 vertices in clockwise order from the top left.
+ */
+struct GUIRenderVertex
+{
+  float x, y, z;
+  unsigned char r, g, b, a;
+  float u, v;   ///< texture coordinates
+  float u2, v2; ///< diffuse texture coordinates
+};
+
+/*!
+ \ingroup textures
+ \brief Draws batches of quads for CGUIRenderBatch.
+ */
+class IGUIRenderBackend
+{
+public:
+  virtual ~IGUIRenderBackend() = default;
+
+  /*! \brief Draw quads sharing a render state
+   \param state the render state, backends should only apply what changed since the last draw.
+   \param vertices the vertices, 4 per quad.
+   \param count the number of vertices.
+   */
+  virtual void Draw(const GUIRenderState& state, const GUIRenderVertex* vertices, unsigned int count) = 0;
+
+  /*! \brief Reset the render state applied by Draw()
+   Called before anything else draws without going through the batch.
+   */
+  virtual void Reset() {}
+};
+
+/*!
+ \ingroup textures
+ \brief Headless backend counting what it is given to draw instead of drawing it.
+ Used to find out how well the GUI batches, see CBenchmark.
+ */
+class CGUIRenderBackendRecorder : public IGUIRenderBackend
+{
+public:
+  struct Counters
+  {
+    unsigned int flushes = 0;      ///< finished batches, each ending with Reset()
+    unsigned int draws = 0;
+    unsigned int quads = 0;
+    unsigned int stateChanges = 0; ///< draws with another state than the one applied before
+    uint32_t checksum = 0;         ///< of the states and vertices drawn
+  };
+
+  void Draw(const GUIRenderState& state, const GUIRenderVertex* vertices, unsigned int count) override;
+  void Reset() override;
+
+  const Counters& GetCounters() const { return m_counters; }
+  void Clear();
+
+private:
+  Counters m_counters;
+  GUIRenderState m_state;
+  bool m_applied = false; ///< m_state was applied since the last Reset()
+};
+
+/*!
+ \ingroup textures
+ \brief Collects the quads rendered by textures and fonts and draws them in as few draw calls as
+ possible.
+
+ Consecutive quads with the same render state are merged into a single vertex array draw. The
+ quads are drawn in the order they were added, as GUI controls overlap and are blended, so a
+ poster wall using a handful of textures costs a handful of draws instead of a few per poster.
+
+ Anything drawing without going through the batch has to call Finish() first.
+ */
+class CGUIRenderBatch
+{
+public:
+  CGUIRenderBatch();
+  ~CGUIRenderBatch();
+
+  /*! \brief Add quads to the batch
+   \param state the render state of the quads.
+   \param quads the number of quads.
+   \return the vertices of the quads, to be filled in by the caller before anything else is added.
+   */
+  GUIRenderVertex* AddQuads(const GUIRenderState& state, unsigned int quads = 1);
+
+  /*! \brief Draw the quads collected so far */
+  void Flush();
+
+  /*! \brief Draw the quads collected so far and reset the render state
+   To be called at the end of a frame and before drawing without the batch.
+   */
+  void Finish();
+
+  /*! \brief Replace the backend drawing the batches, eg. by a CGUIRenderBackendRecorder
+   \return the previous backend.
+   */
+  std::unique_ptr<IGUIRenderBackend> SetBackend(std::unique_ptr<IGUIRenderBackend> backend);
+
+private:
+  CGUIRenderBatch(const CGUIRenderBatch&) = delete;
+  CGUIRenderBatch& operator=(const CGUIRenderBatch&) = delete;
+
+  /*! \brief Create the backend of the render system, implemented along with it */
+  static std::unique_ptr<IGUIRenderBackend> CreateBackend();
+
+  std::unique_ptr<IGUIRenderBackend> m_backend;
+  std::vector<GUIRenderVertex> m_vertices;
+  GUIRenderState m_state;
+  bool m_dirty = false; ///< the backend applied some render state since the last Finish()
+};
@@ -0,0 +1,33 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "GUIRenderBatch.h"
+#include "system.h"
+
+#if defined(HAS_GL)
+
+/*!
+ \ingroup textures
+ \brief Draws the batches of CGUIRenderBatch as vertex arrays with the fixed function pipeline.
+ */
+class CGUIRenderBackendGL : public IGUIRenderBackend
+{
+public:
+  void Draw(const GUIRenderState& state, const GUIRenderVertex* vertices, unsigned int count) override;
+  void Reset() override;
+
+private:
+  void ApplyState(const GUIRenderState& state);
+
+  GUIRenderState m_state;
+  bool m_valid = false; ///< m_state is the state applied
+};
+
+#endif
@@ -314,14 +314,16 @@ void CGUITextLayout::BidiTransform(std::vector<CGUIString> &lines, bool forceLTR
 
 std::wstring CGUITextLayout::BidiFlip(const std::wstring &text, bool forceLTRReadingOrder)
 {
-  std::string utf8text;
-  std::wstring visualText;
+  std::u32string logicalText;
+  std::u32string visualText;
+  std::wstring flippedText;
 
-  // convert to utf8, and back to utf16 with bidi flipping
-  g_charsetConverter.wToUTF8(text, utf8text);
-  g_charsetConverter.utf8ToW(utf8text, visualText, true, forceLTRReadingOrder);
+  // flip in utf32 directly rather than going through utf8
+  g_charsetConverter.wToUtf32(text, logicalText, false);
+  g_charsetConverter.utf32logicalToVisualBiDi(logicalText, visualText, forceLTRReadingOrder);
+  g_charsetConverter.utf32ToW(visualText, flippedText, false);
 
-  return visualText;
+  return flippedText;
 }
 
 void CGUITextLayout::Filter(std::string &text)
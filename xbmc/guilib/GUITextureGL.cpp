@@ -23,6 +23,8 @@
 #include "GUITextureGL.h"
 #endif
 #include "Texture.h"
+#include "TextureGL.h"
+#include "GraphicContext.h"
 #include "utils/log.h"
 #include "utils/GLUtils.h"
 #include "guilib/Geometry.h"
@@ -37,7 +39,7 @@ CGUITextureGL::CGUITextureGL(float posX, float posY, float width, float height,
 
 void CGUITextureGL::Begin(color_t color)
 {
-  int range, unit = 0;
+  int range;
 #ifdef _XBOX
   range = 235 - 16;
 #else
@@ -52,137 +54,88 @@ void CGUITextureGL::Begin(color_t color)
   m_col[2] = GET_B(color) * range / 255;
   m_col[3] = GET_A(color);
 
+  // the quads are drawn by the render batch, along with the quads of other textures using the
+  // same render state
   CTexture* texture = m_texture.m_textures[m_currentFrame].get();
   texture->LoadToGPU();
+  m_state.mode = GUIRenderState::MODE_TEXTURE;
+  m_state.texture = static_cast<CGLTexture*>(texture)->GetTextureObject();
+  m_state.diffuse = 0;
   if (m_diffuse.size())
-    m_diffuse.m_textures[0]->LoadToGPU();
-
-  texture->BindToUnit(unit++);
-
-  glBlendFunc(GL_SRC_ALPHA,GL_ONE_MINUS_SRC_ALPHA);
-  glEnable(GL_BLEND);          // Turn Blending On
-  glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-
-  // diffuse coloring
-  glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_COMBINE);
-  glTexEnvf(GL_TEXTURE_ENV, GL_COMBINE_RGB, GL_MODULATE);
-  glTexEnvf(GL_TEXTURE_ENV, GL_SOURCE0_RGB, GL_TEXTURE);
-  glTexEnvf(GL_TEXTURE_ENV, GL_OPERAND0_RGB, GL_SRC_COLOR);
-  glTexEnvf(GL_TEXTURE_ENV, GL_SOURCE1_RGB, GL_PRIMARY_COLOR);
-  glTexEnvf(GL_TEXTURE_ENV, GL_OPERAND1_RGB, GL_SRC_COLOR);
-
-  glTexEnvf(GL_TEXTURE_ENV, GL_COMBINE_ALPHA, GL_MODULATE);
-  glTexEnvf(GL_TEXTURE_ENV, GL_SOURCE0_ALPHA, GL_TEXTURE);
-  glTexEnvf(GL_TEXTURE_ENV, GL_SOURCE1_ALPHA, GL_PRIMARY_COLOR);
-  glTexEnvf(GL_TEXTURE_ENV, GL_OPERAND0_ALPHA, GL_SRC_ALPHA);
-  glTexEnvf(GL_TEXTURE_ENV, GL_OPERAND1_ALPHA, GL_SRC_ALPHA);
-  VerifyGLState();
-
-  if (m_diffuse.size())
-  {
-    m_diffuse.m_textures[0]->BindToUnit(unit++);
-    glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_COMBINE);
-    glTexEnvf(GL_TEXTURE_ENV, GL_COMBINE_RGB, GL_MODULATE);
-    glTexEnvf(GL_TEXTURE_ENV, GL_SOURCE0_RGB, GL_TEXTURE);
-    glTexEnvf(GL_TEXTURE_ENV, GL_OPERAND0_RGB, GL_SRC_COLOR);
-    glTexEnvf(GL_TEXTURE_ENV, GL_SOURCE1_RGB, GL_PREVIOUS);
-    glTexEnvf(GL_TEXTURE_ENV, GL_OPERAND1_RGB, GL_SRC_COLOR);
-
-    glTexEnvf(GL_TEXTURE_ENV, GL_COMBINE_ALPHA, GL_MODULATE);
-    glTexEnvf(GL_TEXTURE_ENV, GL_SOURCE0_ALPHA, GL_TEXTURE);
-    glTexEnvf(GL_TEXTURE_ENV, GL_SOURCE1_ALPHA, GL_PREVIOUS);
-    glTexEnvf(GL_TEXTURE_ENV, GL_OPERAND0_ALPHA, GL_SRC_ALPHA);
-    glTexEnvf(GL_TEXTURE_ENV, GL_OPERAND1_ALPHA, GL_SRC_ALPHA);
-    VerifyGLState();
-  }
-
-#ifndef _XBOX
-  if(g_Windowing.UseLimitedColor())
-#endif
   {
-    texture->BindToUnit(unit++); // dummy bind
-    const GLfloat rgba[4] = {16.0f / 255.0f, 16.0f / 255.0f, 16.0f / 255.0f, 0.0f};
-    glTexEnvi (GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE , GL_COMBINE);
-    glTexEnvfv(GL_TEXTURE_ENV, GL_TEXTURE_ENV_COLOR, rgba);
-    glTexEnvi (GL_TEXTURE_ENV, GL_COMBINE_RGB      , GL_ADD);
-    glTexEnvi (GL_TEXTURE_ENV, GL_SOURCE0_RGB      , GL_PREVIOUS);
-    glTexEnvi (GL_TEXTURE_ENV, GL_SOURCE1_RGB      , GL_CONSTANT);
-    glTexEnvi (GL_TEXTURE_ENV, GL_OPERAND0_RGB     , GL_SRC_COLOR);
-    glTexEnvi (GL_TEXTURE_ENV, GL_OPERAND1_RGB     , GL_SRC_COLOR);
-
-    glTexEnvi (GL_TEXTURE_ENV, GL_COMBINE_ALPHA    , GL_REPLACE);
-    glTexEnvi (GL_TEXTURE_ENV, GL_SOURCE0_ALPHA    , GL_PREVIOUS);
-    VerifyGLState();
+    m_diffuse.m_textures[0]->LoadToGPU();
+    m_state.diffuse = static_cast<CGLTexture*>(m_diffuse.m_textures[0].get())->GetTextureObject();
   }
-
-  //glDisable(GL_TEXTURE_2D); // uncomment these 2 lines to switch to wireframe rendering
-  //glBegin(GL_LINE_LOOP);
-  glBegin(GL_QUADS);
 }
 
 void CGUITextureGL::End()
 {
-  glEnd();
-  glActiveTexture(GL_TEXTURE2_ARB);
-  glBindTexture(GL_TEXTURE_2D, 0);
-  glDisable(GL_TEXTURE_2D);
-  glActiveTexture(GL_TEXTURE1_ARB);
-  glBindTexture(GL_TEXTURE_2D, 0);
-  glDisable(GL_TEXTURE_2D);
-  glActiveTexture(GL_TEXTURE0_ARB);
-  glBindTexture(GL_TEXTURE_2D, 0);
-  glDisable(GL_TEXTURE_2D);
 }
 
 void CGUITextureGL::Draw(float *x, float *y, float *z, const CRect &texture, const CRect &diffuse, int orientation)
 {
+  GUIRenderVertex* v = g_graphicsContext.GetRenderBatch().AddQuads(m_state);
+
+  for (int i = 0; i < 4; i++)
+  {
+    v[i].x = x[i];
+    v[i].y = y[i];
+    v[i].z = z[i];
+    v[i].r = m_col[0];
+    v[i].g = m_col[1];
+    v[i].b = m_col[2];
+    v[i].a = m_col[3];
+  }
+
   // Top-left vertex (corner)
-  glColor4ub(m_col[0], m_col[1], m_col[2], m_col[3]);
-  // glMultiTexCoord2fARB(GL_TEXTURE0_ARB, texture.x1, texture.y1);
-  // if (m_diffuse.size())
-  //   glMultiTexCoord2fARB(GL_TEXTURE1_ARB, diffuse.x1, diffuse.y1);
-  glVertex3f(x[0], y[0], z[0]);
+  v[0].u = texture.x1;  v[0].v = texture.y1;
+  v[0].u2 = diffuse.x1; v[0].v2 = diffuse.y1;
 
   // Top-right vertex (corner)
-  glColor4ub(m_col[0], m_col[1], m_col[2], m_col[3]);
-  // if (orientation & 4)
-  //   glMultiTexCoord2fARB(GL_TEXTURE0_ARB, texture.x1, texture.y2);
-  // else
-  //   glMultiTexCoord2fARB(GL_TEXTURE0_ARB, texture.x2, texture.y1);
-  if (m_diffuse.size())
+  if (orientation & 4)
   {
-    // if (m_info.orientation & 4)
-    //   glMultiTexCoord2fARB(GL_TEXTURE1_ARB, diffuse.x1, diffuse.y2);
-    // else
-    //   glMultiTexCoord2fARB(GL_TEXTURE1_ARB, diffuse.x2, diffuse.y1);
+    v[1].u = texture.x1; v[1].v = texture.y2;
+  }
+  else
+  {
+    v[1].u = texture.x2; v[1].v = texture.y1;
+  }
+  if (m_info.orientation & 4)
+  {
+    v[1].u2 = diffuse.x1; v[1].v2 = diffuse.y2;
+  }
+  else
+  {
+    v[1].u2 = diffuse.x2; v[1].v2 = diffuse.y1;
   }
-  glVertex3f(x[1], y[1], z[1]);
 
   // Bottom-right vertex (corner)
-  glColor4ub(m_col[0], m_col[1], m_col[2], m_col[3]);
-  // glMultiTexCoord2fARB(GL_TEXTURE0_ARB, texture.x2, texture.y2);
-  // if (m_diffuse.size())
-  //   glMultiTexCoord2fARB(GL_TEXTURE1_ARB, diffuse.x2, diffuse.y2);
-  glVertex3f(x[2], y[2], z[2]);
+  v[2].u = texture.x2;  v[2].v = texture.y2;
+  v[2].u2 = diffuse.x2; v[2].v2 = diffuse.y2;
 
   // Bottom-left vertex (corner)
-  glColor4ub(m_col[0], m_col[1], m_col[2], m_col[3]);
-  // if (orientation & 4)
-  //   glMultiTexCoord2fARB(GL_TEXTURE0_ARB, texture.x2, texture.y1);
-  // else
-  //   glMultiTexCoord2fARB(GL_TEXTURE0_ARB, texture.x1, texture.y2);
-  if (m_diffuse.size())
+  if (orientation & 4)
+  {
+    v[3].u = texture.x2; v[3].v = texture.y1;
+  }
+  else
+  {
+    v[3].u = texture.x1; v[3].v = texture.y2;
+  }
+  if (m_info.orientation & 4)
   {
-    // if (m_info.orientation & 4)
-    //   glMultiTexCoord2fARB(GL_TEXTURE1_ARB, diffuse.x2, diffuse.y1);
-    // else
-    //   glMultiTexCoord2fARB(GL_TEXTURE1_ARB, diffuse.x1, diffuse.y2);
+    v[3].u2 = diffuse.x2; v[3].v2 = diffuse.y1;
+  }
+  else
+  {
+    v[3].u2 = diffuse.x1; v[3].v2 = diffuse.y2;
   }
-  glVertex3f(x[3], y[3], z[3]);
 }
 
 void CGUITextureGL::DrawQuad(const CRect &rect, color_t color, CTexture *texture, const CRect *texCoords)
 {
+  g_graphicsContext.GetRenderBatch().Finish();
+
   if (texture)
   {
     texture->LoadToGPU();
@@ -29,6 +29,7 @@
  */
 
 #include "GUITexture.h"
+#include "GUIRenderBatch.h"
 
 #include "system_gl.h"
 
@@ -43,6 +44,7 @@ protected:
   void End();
 private:
   GLubyte m_col[4];
+  GUIRenderState m_state;
 };
 
 #endif
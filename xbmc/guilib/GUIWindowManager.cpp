@@ -31,6 +31,7 @@
 #include "GUIInfoManager.h"
 #include "threads/SingleLock.h"
 #include "utils/URIUtils.h"
+#include "utils/Profiler.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/SettingsComponent.h"
 #include "addons/Skin.h"
@@ -882,6 +883,7 @@ bool RenderOrderSortFunction(CGUIWindow *first, CGUIWindow *second)
 
 void CGUIWindowManager::Process(unsigned int currentTime)
 {
+  PROFILE_ZONE("CGUIWindowManager::Process");
   assert(g_application.IsCurrentThread());
   std::unique_lock<CCriticalSection> lock(g_graphicsContext);
 
@@ -953,6 +955,7 @@ void CGUIWindowManager::RenderEx() const
 
 bool CGUIWindowManager::Render()
 {
+  PROFILE_ZONE("CGUIWindowManager::Render");
   assert(g_application.IsCurrentThread());
   CSingleExit lock(g_graphicsContext);
 
@@ -1197,6 +1200,7 @@ void CGUIWindowManager::SendThreadMessage(CGUIMessage& message, int window /*= 0
 
 void CGUIWindowManager::DispatchThreadMessages()
 {
+  PROFILE_ZONE("CGUIWindowManager::DispatchThreadMessages");
   // This method only be called in the xbmc main thread.
 
   // XXX: for more info of this method
@@ -32,6 +32,7 @@
 #include "threads/CriticalSection.h"  // base class
 #include "TransformMatrix.h"        // for the members m_guiTransform etc.
 #include "Geometry.h"               // for CRect/CPoint
+#include "GUIRenderBatch.h"         // for the member m_renderBatch
 
 #include "utils/GlobalsHandling.h"
 
@@ -276,6 +277,9 @@ public:
   CRect generateAABB(const CRect &rect) const;
 
   unsigned int GetMaxTextureSize() const { return m_maxTextureSize; };
+
+  /*! \brief The batch collecting the quads of textures and fonts, only to be used from the render thread */
+  CGUIRenderBatch& GetRenderBatch() { return m_renderBatch; };
 protected:
   void SetFullScreenViewWindow(RESOLUTION &res);
 
@@ -315,6 +319,8 @@ private:
   CRect m_scissors;
 
   unsigned int m_maxTextureSize;
+
+  CGUIRenderBatch m_renderBatch;
 };
 
 /*!
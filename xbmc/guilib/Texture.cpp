@@ -21,6 +21,7 @@
 #include "Texture.h"
 #include "guilib/GraphicContext.h"
 #include "utils/log.h"
+#include "utils/Profiler.h"
 #include "utils/URIUtils.h"
 #include "filesystem/File.h"
 #include "filesystem/ResourceFile.h"
@@ -189,6 +190,7 @@ void CTexture::ClampToEdge()
 
 std::unique_ptr<CTexture> CTexture::LoadFromFile(const std::string& texturePath, unsigned int idealWidth, unsigned int idealHeight, bool requirePixels, const std::string& strMimeType)
 {
+  PROFILE_ZONE("CTexture::LoadFromFile");
 #if defined(TARGET_ANDROID)
   CURL url(texturePath);
   if (url.IsProtocol("androidapp"))
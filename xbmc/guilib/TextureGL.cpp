@@ -79,6 +79,9 @@ void CGLTexture::LoadToGPU()
     CreateTextureObject();
   }
 
+  // uploading changes the bound texture, so draw the quads batched with the current state first
+  g_graphicsContext.GetRenderBatch().Finish();
+
   // Bind the texture object
   glBindTexture(GL_TEXTURE_2D, m_texture);
 
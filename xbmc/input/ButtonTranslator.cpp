@@ -9,24 +9,55 @@
 #include "ButtonTranslator.h"
 
 #include "AppTranslator.h"
+#include "CompileInfo.h"
 #include "FileItem.h"
 #include "GamepadTranslator.h"
 #include "IButtonMapper.h"
 #include "Key.h"
 #include "WindowTranslator.h"
 #include "filesystem/Directory.h"
+#include "filesystem/File.h"
 #include "guilib/WindowIDs.h"
 #include "input/actions/ActionIDs.h"
 #include "input/actions/ActionTranslator.h"
+#include "utils/Archive.h"
 #include "utils/StringUtils.h"
 #include "utils/XBMCTinyXML.h"
 #include "utils/log.h"
 
 #include <algorithm>
+#include <stdexcept>
 #include <utility>
 
+#define KEYMAP_CACHE "special://temp/keymaps.bin"
+#define KEYMAP_CACHE_VERSION 1
+
 using namespace KODI;
 
+namespace
+{
+/*!
+ \brief Add the keymaps of a directory to those to load
+ \param signature [in/out] the keymaps with their sizes and modification times are appended.
+ */
+void GetKeymaps(const std::string& dir, std::vector<std::string>& keymaps, std::string& signature)
+{
+  CFileItemList files;
+  XFILE::CDirectory::GetDirectory(dir, files, ".xml", XFILE::DIR_FLAG_DEFAULTS);
+  // Sort the list for filesystem based priorities, e.g. 01-keymap.xml, 02-keymap-overrides.xml
+  files.Sort(SortByFile, SortOrderAscending);
+  for (const auto& file : files)
+  {
+    if (file->m_bIsFolder)
+      continue;
+
+    keymaps.push_back(file->GetPath());
+    signature += StringUtils::Format("{}|{}|{}\n", file->GetPath(), file->m_dwSize,
+                                     file->m_dateTime.GetAsDBDateTime());
+  }
+}
+} // namespace
+
 // Add the supplied device name to the list of connected devices
 bool CButtonTranslator::AddDevice(const std::string& strDevice)
 {
@@ -69,21 +100,15 @@ bool CButtonTranslator::Load()
                                                    "special://masterprofile/keymaps/",
                                                    "special://profile/keymaps/"};
 
-  bool success = false;
+  // action and window ids may change with the build, the compiled tables are only valid for it
+  std::vector<std::string> keymaps;
+  std::string signature = StringUtils::Format("{}\n", CCompileInfo::GetSCMID());
 
   for (const auto& dir : DIRS_TO_CHECK)
   {
     if (XFILE::CDirectory::Exists(dir))
     {
-      CFileItemList files;
-      XFILE::CDirectory::GetDirectory(dir, files, ".xml", XFILE::DIR_FLAG_DEFAULTS);
-      // Sort the list for filesystem based priorities, e.g. 01-keymap.xml, 02-keymap-overrides.xml
-      files.Sort(SortByFile, SortOrderAscending);
-      for (int fileIndex = 0; fileIndex < files.Size(); ++fileIndex)
-      {
-        if (!files[fileIndex]->m_bIsFolder)
-          success |= LoadKeymap(files[fileIndex]->GetPath());
-      }
+      GetKeymaps(dir, keymaps, signature);
 
       // Load mappings for any HID devices we have connected
       for (const auto& device : m_deviceList)
@@ -92,22 +117,19 @@ bool CButtonTranslator::Load()
         devicedir.append(device);
         devicedir.append("/");
         if (XFILE::CDirectory::Exists(devicedir))
-        {
-          CFileItemList files;
-          XFILE::CDirectory::GetDirectory(devicedir, files, ".xml", XFILE::DIR_FLAG_DEFAULTS);
-          // Sort the list for filesystem based priorities, e.g. 01-keymap.xml,
-          // 02-keymap-overrides.xml
-          files.Sort(SortByFile, SortOrderAscending);
-          for (int fileIndex = 0; fileIndex < files.Size(); ++fileIndex)
-          {
-            if (!files[fileIndex]->m_bIsFolder)
-              success |= LoadKeymap(files[fileIndex]->GetPath());
-          }
-        }
+          GetKeymaps(devicedir, keymaps, signature);
       }
     }
   }
 
+  // button mappers are fed from the XML, the compiled tables can't be used with them
+  if (!keymaps.empty() && m_buttonMappers.empty() && LoadCompiled(signature))
+    return true;
+
+  bool success = false;
+  for (const auto& keymap : keymaps)
+    success |= LoadKeymap(keymap);
+
   if (!success)
   {
     CLog::Log(LOGERROR, "Error loading keymaps from: {} or {} or {}", DIRS_TO_CHECK[0],
@@ -115,10 +137,149 @@ bool CButtonTranslator::Load()
     return false;
   }
 
+  Compile();
+  SaveCompiled(signature);
+
   // Done!
   return true;
 }
 
+void CButtonTranslator::Compile()
+{
+  // the index spans the mapped window ids, which are mostly WINDOW_HOME and above
+  int lastWindow = -1;
+  m_firstWindow = 0;
+  for (const auto& window : m_translatorMap)
+  {
+    if (window.first == -1)
+      continue;
+    if (lastWindow == -1)
+      m_firstWindow = window.first;
+    lastWindow = window.first;
+  }
+  if (lastWindow != -1)
+    m_windowIndex.assign(lastWindow - m_firstWindow + 1, 0);
+
+  // most mappings share a handful of action strings
+  std::map<std::string, unsigned int> strings;
+  m_windows.assign(1, {0, 0});
+  for (const auto& window : m_translatorMap)
+  {
+    const unsigned int begin = static_cast<unsigned int>(m_buttons.size());
+    const CWindowEntries entries = {begin,
+                                    begin + static_cast<unsigned int>(window.second.size())};
+    if (window.first == -1)
+      m_windows[0] = entries;
+    else
+    {
+      m_windowIndex[window.first - m_firstWindow] = static_cast<uint16_t>(m_windows.size());
+      m_windows.push_back(entries);
+    }
+
+    // the map is ordered by button code already
+    for (const auto& button : window.second)
+    {
+      auto string = strings.emplace(button.second.strID, m_actionStrings.size());
+      if (string.second)
+        m_actionStrings.push_back(button.second.strID);
+      m_buttons.push_back({button.first, button.second.id, string.first->second});
+    }
+  }
+  m_translatorMap.clear();
+
+  CLog::Log(LOGDEBUG, "CButtonTranslator: compiled {} mappings of {} windows", m_buttons.size(),
+            m_windows.size());
+}
+
+bool CButtonTranslator::LoadCompiled(const std::string& signature)
+{
+  XFILE::CFile file;
+  if (!file.Open(KEYMAP_CACHE))
+    return false;
+
+  try
+  {
+    CArchive ar(&file, CArchive::load);
+    int version;
+    std::string storedSignature;
+    ar >> version;
+    if (version != KEYMAP_CACHE_VERSION)
+      return false;
+    ar >> storedSignature;
+    if (storedSignature != signature)
+      return false;
+
+    unsigned int count;
+    ar >> count;
+    m_buttons.resize(count);
+    for (auto& button : m_buttons)
+      ar >> button.buttonCode >> button.actionID >> button.actionString;
+
+    ar >> count;
+    m_windows.resize(count);
+    for (auto& window : m_windows)
+      ar >> window.begin >> window.end;
+
+    ar >> m_firstWindow >> count;
+    m_windowIndex.resize(count);
+    for (auto& index : m_windowIndex)
+      ar >> index;
+
+    ar >> m_actionStrings;
+
+    // a truncated file reads as zeros, the version is repeated at its end
+    ar >> version;
+    bool valid = version == KEYMAP_CACHE_VERSION && !m_windows.empty();
+    for (const auto& button : m_buttons)
+      valid &= button.actionString < m_actionStrings.size();
+    for (const auto& window : m_windows)
+      valid &= window.begin <= window.end && window.end <= m_buttons.size();
+    for (const auto& index : m_windowIndex)
+      valid &= index < m_windows.size();
+
+    if (valid)
+    {
+      CLog::Log(LOGINFO, "Loaded compiled keymaps, {} mappings", m_buttons.size());
+      return true;
+    }
+  }
+  catch (const std::out_of_range&)
+  {
+  }
+
+  CLog::Log(LOGWARNING, "CButtonTranslator: ignoring invalid {}", KEYMAP_CACHE);
+  Clear();
+  return false;
+}
+
+void CButtonTranslator::SaveCompiled(const std::string& signature) const
+{
+  XFILE::CFile file;
+  if (!file.OpenForWrite(KEYMAP_CACHE, true))
+  {
+    CLog::Log(LOGWARNING, "CButtonTranslator: unable to write {}", KEYMAP_CACHE);
+    return;
+  }
+
+  CArchive ar(&file, CArchive::store);
+  ar << KEYMAP_CACHE_VERSION << signature;
+
+  ar << static_cast<unsigned int>(m_buttons.size());
+  for (const auto& button : m_buttons)
+    ar << button.buttonCode << button.actionID << button.actionString;
+
+  ar << static_cast<unsigned int>(m_windows.size());
+  for (const auto& window : m_windows)
+    ar << window.begin << window.end;
+
+  ar << m_firstWindow << static_cast<unsigned int>(m_windowIndex.size());
+  for (const auto& index : m_windowIndex)
+    ar << index;
+
+  ar << m_actionStrings << KEYMAP_CACHE_VERSION;
+  ar.Close();
+}
+
 bool CButtonTranslator::LoadKeymap(const std::string& keymapPath)
 {
   CXBMCTinyXML xmlDoc;
@@ -200,27 +361,21 @@ bool CButtonTranslator::HasLongpressMapping(int window, const CKey& key)
 
 bool CButtonTranslator::HasLongpressMapping_Internal(int window, const CKey& key)
 {
-  std::map<int, buttonMap>::const_iterator it = m_translatorMap.find(window);
-  if (it != m_translatorMap.end())
-  {
-    uint32_t code = key.GetButtonCode();
-    code |= CKey::MODIFIER_LONG;
-    buttonMap::const_iterator it2 = (*it).second.find(code);
-
-    if (it2 != (*it).second.end())
-      return it2->second.id != ACTION_NOOP;
+  uint32_t code = key.GetButtonCode();
+  code |= CKey::MODIFIER_LONG;
+  const CButtonEntry* button = FindButton(window, code);
+  if (button != nullptr)
+    return button->actionID != ACTION_NOOP;
 
 #ifdef TARGET_POSIX
-    // Some buttoncodes changed in Hardy
-    if ((code & KEY_VKEY) == KEY_VKEY && (code & 0x0F00))
-    {
-      code &= ~0x0F00;
-      it2 = (*it).second.find(code);
-      if (it2 != (*it).second.end())
-        return true;
-    }
-#endif
+  // Some buttoncodes changed in Hardy
+  if ((code & KEY_VKEY) == KEY_VKEY && (code & 0x0F00))
+  {
+    code &= ~0x0F00;
+    if (FindButton(window, code) != nullptr)
+      return true;
   }
+#endif
 
   // no key mapping found for the current window do the fallback handling
   if (window > -1)
@@ -243,41 +398,53 @@ unsigned int CButtonTranslator::GetActionCode(int window,
 {
   uint32_t code = key.GetButtonCode();
 
-  std::map<int, buttonMap>::const_iterator it = m_translatorMap.find(window);
-  if (it == m_translatorMap.end())
-    return ACTION_NONE;
-
-  buttonMap::const_iterator it2 = (*it).second.find(code);
-  unsigned int action = ACTION_NONE;
-  if (it2 == (*it).second.end() &&
-      code & CKey::MODIFIER_LONG) // If long action not found, try short one
+  const CButtonEntry* button = FindButton(window, code);
+  if (button == nullptr && code & CKey::MODIFIER_LONG) // If long action not found, try short one
   {
     code &= ~CKey::MODIFIER_LONG;
-    it2 = (*it).second.find(code);
-  }
-
-  if (it2 != (*it).second.end())
-  {
-    action = (*it2).second.id;
-    strAction = (*it2).second.strID;
+    button = FindButton(window, code);
   }
 
 #ifdef TARGET_POSIX
   // Some buttoncodes changed in Hardy
-  if (action == ACTION_NONE && (code & KEY_VKEY) == KEY_VKEY && (code & 0x0F00))
+  if (button == nullptr && (code & KEY_VKEY) == KEY_VKEY && (code & 0x0F00))
   {
     CLog::Log(LOGDEBUG, "{}: Trying Hardy keycode for {:#04x}", __FUNCTION__, code);
     code &= ~0x0F00;
-    it2 = (*it).second.find(code);
-    if (it2 != (*it).second.end())
-    {
-      action = (*it2).second.id;
-      strAction = (*it2).second.strID;
-    }
+    button = FindButton(window, code);
   }
 #endif
 
-  return action;
+  if (button == nullptr)
+    return ACTION_NONE;
+
+  strAction = m_actionStrings[button->actionString];
+  return button->actionID;
+}
+
+const CButtonTranslator::CButtonEntry* CButtonTranslator::FindButton(int window,
+                                                                     uint32_t code) const
+{
+  size_t index = 0;
+  if (window != -1)
+  {
+    if (window < m_firstWindow || window - m_firstWindow >= static_cast<int>(m_windowIndex.size()))
+      return nullptr;
+    index = m_windowIndex[window - m_firstWindow];
+    if (index == 0)
+      return nullptr;
+  }
+  if (index >= m_windows.size())
+    return nullptr;
+
+  const auto begin = m_buttons.begin() + m_windows[index].begin;
+  const auto end = m_buttons.begin() + m_windows[index].end;
+  const auto it = std::lower_bound(begin, end, code, [](const CButtonEntry& button, uint32_t code) {
+    return button.buttonCode < code;
+  });
+  if (it == end || it->buttonCode != code)
+    return nullptr;
+  return &*it;
 }
 
 void CButtonTranslator::MapAction(uint32_t buttonCode, const std::string& szAction, buttonMap& map)
@@ -377,6 +544,11 @@ void CButtonTranslator::MapWindowActions(const TiXmlNode* pWindow, int windowID)
 void CButtonTranslator::Clear()
 {
   m_translatorMap.clear();
+  m_buttons.clear();
+  m_windows.clear();
+  m_windowIndex.clear();
+  m_firstWindow = 0;
+  m_actionStrings.clear();
 
   for (auto it : m_buttonMappers)
     it.second->Clear();
@@ -10,9 +10,11 @@
 
 #include "input/actions/Action.h"
 
+#include <cstdint>
 #include <map>
 #include <set>
 #include <string>
+#include <vector>
 
 class CKey;
 class TiXmlNode;
@@ -71,9 +73,32 @@ private:
 
   typedef std::multimap<uint32_t, CButtonAction> buttonMap; // our button map to fill in
 
-  // m_translatorMap contains all mappings i.e. m_BaseMap + HID device mappings
+  // m_translatorMap contains all mappings i.e. m_BaseMap + HID device mappings, while the
+  // keymaps are loaded. They're compiled into the tables below afterwards.
   std::map<int, buttonMap> m_translatorMap;
 
+  struct CButtonEntry
+  {
+    uint32_t buttonCode;
+    unsigned int actionID;
+    unsigned int actionString; // index into m_actionStrings
+  };
+
+  // range of a window's mappings in m_buttons
+  struct CWindowEntries
+  {
+    unsigned int begin;
+    unsigned int end;
+  };
+
+  // the compiled keymaps. Mappings of each window are sorted by button code, m_windows[0] holds
+  // the global ones and m_windowIndex the others, by window id - m_firstWindow.
+  std::vector<CButtonEntry> m_buttons;
+  std::vector<CWindowEntries> m_windows;
+  std::vector<uint16_t> m_windowIndex; // 0 for windows without mappings
+  int m_firstWindow = 0;
+  std::vector<std::string> m_actionStrings;
+
   // m_deviceList contains the list of connected HID devices
   std::set<std::string> m_deviceList;
 
@@ -84,6 +109,18 @@ private:
 
   bool LoadKeymap(const std::string& keymapPath);
 
+  /*! \brief Turn m_translatorMap into the compiled tables */
+  void Compile();
+
+  /*! \brief Load the tables compiled when the keymaps were last loaded
+   \param signature the keymap files, with their sizes and modification times
+   \return false if there are none, or the keymaps changed since
+   */
+  bool LoadCompiled(const std::string& signature);
+  void SaveCompiled(const std::string& signature) const;
+
+  const CButtonEntry* FindButton(int window, uint32_t code) const;
+
   bool HasLongpressMapping_Internal(int window, const CKey& key);
 
   std::map<std::string, IButtonMapper*> m_buttonMappers;
@@ -18,6 +18,8 @@
 #include "utils/log.h"
 #include "video/VideoDatabase.h"
 
+#include <algorithm>
+#include <iterator>
 #include <mutex>
 #include <stdio.h>
 
@@ -25,6 +27,19 @@
 
 using namespace ANNOUNCEMENT;
 
+namespace
+{
+// how long announcements about a library item are held back to merge repeated ones into
+constexpr auto COALESCE_WINDOW = std::chrono::milliseconds(200);
+// most announcements passed to the listeners at once
+constexpr size_t MAX_BATCH = 64;
+
+bool IsTransaction(const CVariant& data)
+{
+  return data.isMember("transaction") && data["transaction"].asBoolean();
+}
+} // unnamed namespace
+
 const std::string CAnnouncementManager::ANNOUNCEMENT_SENDER = "xbmc";
 
 CAnnouncementManager::CAnnouncementManager() : CThread("Announce")
@@ -50,13 +65,13 @@ void CAnnouncementManager::Deinitialize()
   m_announcers.clear();
 }
 
-void CAnnouncementManager::AddAnnouncer(IAnnouncer *listener)
+void CAnnouncementManager::AddAnnouncer(IAnnouncer *listener, int flags /* = ANNOUNCE_ALL | Info */)
 {
   if (!listener)
     return;
 
   std::unique_lock<CCriticalSection> lock(m_announcersCritSection);
-  m_announcers.push_back(listener);
+  m_announcers.push_back({listener, flags});
 }
 
 void CAnnouncementManager::RemoveAnnouncer(IAnnouncer *listener)
@@ -67,7 +82,7 @@ void CAnnouncementManager::RemoveAnnouncer(IAnnouncer *listener)
   std::unique_lock<CCriticalSection> lock(m_announcersCritSection);
   for (unsigned int i = 0; i < m_announcers.size(); i++)
   {
-    if (m_announcers[i] == listener)
+    if (m_announcers[i].listener == listener)
     {
       m_announcers.erase(m_announcers.begin() + i);
       return;
@@ -136,40 +151,93 @@ void CAnnouncementManager::Announce(AnnouncementFlag flag,
   if (item != nullptr)
     announcement.item = CFileItemPtr(new CFileItem(*item));
 
+  announcement.queued = std::chrono::steady_clock::now();
+  announcement.due = announcement.queued;
+
+  // the libraries announce every item they update or remove, during a scan or clean these are
+  // held back for a moment so that repeated announcements about an item are delivered once
+  if (item == nullptr && data.isObject() && data.isMember("type") && data.isMember("id"))
+  {
+    announcement.key = StringUtils::Format("{}/{}/{}", static_cast<int>(flag),
+                                           data["type"].asString(), data["id"].asInteger());
+    announcement.due += COALESCE_WINDOW;
+  }
+
   {
     std::unique_lock<CCriticalSection> lock(m_queueCritSection);
-    m_announcementQueue.push_back(announcement);
+    m_stats.announced++;
+
+    if (!announcement.key.empty())
+    {
+      // only the latest announcement about the item is merged into, to keep them in order
+      auto pending = m_pending.find(announcement.key);
+      if (pending != m_pending.end())
+      {
+        CAnnounceData& latest = *pending->second;
+        if (latest.message == message && latest.sender == sender &&
+            IsTransaction(latest.data) == IsTransaction(data))
+        {
+          for (auto it = data.begin_map(); it != data.end_map(); ++it)
+            latest.data[it->first] = it->second;
+          m_stats.coalesced++;
+          return;
+        }
+      }
+    }
+
+    m_announcementQueue.push_back(std::move(announcement));
+    const auto queued = std::prev(m_announcementQueue.end());
+    if (!queued->key.empty())
+      m_pending[queued->key] = queued;
+
+    m_stats.queueLength = m_announcementQueue.size();
+    m_stats.maxQueueLength = std::max(m_stats.maxQueueLength, m_stats.queueLength);
   }
   m_queueEvent.Set();
 }
 
-void CAnnouncementManager::DoAnnounce(AnnouncementFlag flag,
-                                      const std::string& sender,
-                                      const std::string& message,
-                                      const CVariant& data)
+CAnnouncementManager::Stats CAnnouncementManager::GetStats() const
+{
+  std::unique_lock<CCriticalSection> lock(m_queueCritSection);
+  return m_stats;
+}
+
+void CAnnouncementManager::DoAnnounce(const std::vector<Announcement>& announcements)
 {
-  CLog::Log(LOGDEBUG, LOGANNOUNCE, "CAnnouncementManager - Announcement: {} from {}", message, sender);
+  for (const auto& announcement : announcements)
+    CLog::Log(LOGDEBUG, LOGANNOUNCE, "CAnnouncementManager - Announcement: {} from {}",
+              announcement.message, announcement.sender);
 
   std::unique_lock<CCriticalSection> lock(m_announcersCritSection);
 
   // Make a copy of announcers. They may be removed or even remove themselves during execution of IAnnouncer::Announce()!
 
-  std::vector<IAnnouncer *> announcers(m_announcers);
-  for (unsigned int i = 0; i < announcers.size(); i++)
-    announcers[i]->Announce(flag, sender, message, data);
+  std::vector<Announcer> announcers(m_announcers);
+  std::vector<Announcement> subscribed;
+  for (const auto& announcer : announcers)
+  {
+    const auto isSubscribed = [&announcer](const Announcement& announcement)
+    { return (announcement.flag & announcer.flags) != 0; };
+
+    if (std::all_of(announcements.begin(), announcements.end(), isSubscribed))
+    {
+      announcer.listener->AnnounceBatch(announcements);
+      continue;
+    }
+
+    subscribed.clear();
+    std::copy_if(announcements.begin(), announcements.end(), std::back_inserter(subscribed),
+                 isSubscribed);
+    if (!subscribed.empty())
+      announcer.listener->AnnounceBatch(subscribed);
+  }
 }
 
-void CAnnouncementManager::DoAnnounce(AnnouncementFlag flag,
-                                      const std::string& sender,
-                                      const std::string& message,
-                                      const std::shared_ptr<CFileItem>& item,
-                                      const CVariant& data)
+CVariant CAnnouncementManager::GetItemData(const std::shared_ptr<CFileItem>& item,
+                                           const CVariant& data)
 {
   if (item == nullptr)
-  {
-    DoAnnounce(flag, sender, message, data);
-    return;
-  }
+    return data;
 
   // Extract db id of item
   CVariant object = data.isNull() || data.isObject() ? data : CVariant::VariantTypeObject;
@@ -301,30 +369,70 @@ void CAnnouncementManager::DoAnnounce(AnnouncementFlag flag,
   if (id > 0)
     object["item"]["id"] = id;
 
-  DoAnnounce(flag, sender, message, object);
+  return object;
 }
 
 void CAnnouncementManager::Process()
 {
   SetPriority(ThreadPriority::LOWEST);
 
+  std::vector<CAnnounceData> due;
+  std::vector<Announcement> announcements;
   while (!m_bStop)
   {
-    std::unique_lock<CCriticalSection> lock(m_queueCritSection);
-    if (!m_announcementQueue.empty())
     {
-      auto announcement = m_announcementQueue.front();
-      m_announcementQueue.pop_front();
+      std::unique_lock<CCriticalSection> lock(m_queueCritSection);
+
+      // taken in order, an announcement still waiting for repeats holds back those after it
+      const auto now = std::chrono::steady_clock::now();
+      while (!m_announcementQueue.empty() && m_announcementQueue.front().due <= now &&
+             due.size() < MAX_BATCH)
+      {
+        CAnnounceData& announcement = m_announcementQueue.front();
+        if (!announcement.key.empty())
+        {
+          auto pending = m_pending.find(announcement.key);
+          if (pending != m_pending.end() && pending->second == m_announcementQueue.begin())
+            m_pending.erase(pending);
+        }
+        due.push_back(std::move(announcement));
+        m_announcementQueue.pop_front();
+      }
+      m_stats.queueLength = m_announcementQueue.size();
+
+      if (due.empty())
       {
-        CSingleExit ex(m_queueCritSection);
-        DoAnnounce(announcement.flag, announcement.sender, announcement.message, announcement.item,
-                   announcement.data);
+        const bool empty = m_announcementQueue.empty();
+        const auto wait = empty ? std::chrono::steady_clock::duration::zero()
+                                : m_announcementQueue.front().due - now;
+        lock.unlock();
+        if (empty)
+          m_queueEvent.Wait();
+        else
+          m_queueEvent.Wait(wait);
+        continue;
       }
     }
-    else
+
+    announcements.clear();
+    for (auto& announcement : due)
+      announcements.push_back({announcement.flag, std::move(announcement.sender),
+                               std::move(announcement.message),
+                               GetItemData(announcement.item, announcement.data)});
+    DoAnnounce(announcements);
+
+    const auto now = std::chrono::steady_clock::now();
+    std::unique_lock<CCriticalSection> lock(m_queueCritSection);
+    m_stats.delivered += due.size();
+    m_stats.batches++;
+    for (const auto& announcement : due)
     {
-      CSingleExit ex(m_queueCritSection);
-      m_queueEvent.Wait();
+      const unsigned int latency = static_cast<unsigned int>(
+          std::chrono::duration_cast<std::chrono::milliseconds>(now - announcement.queued)
+              .count());
+      m_stats.totalLatency += latency;
+      m_stats.maxLatency = std::max(m_stats.maxLatency, latency);
     }
+    due.clear();
   }
 }
@@ -14,8 +14,12 @@
 #include "threads/Thread.h"
 #include "utils/Variant.h"
 
+#include <chrono>
+#include <cstdint>
 #include <list>
+#include <map>
 #include <memory>
+#include <string>
 #include <vector>
 
 class CFileItem;
@@ -32,7 +36,13 @@ namespace ANNOUNCEMENT
     void Start();
     void Deinitialize();
 
-    void AddAnnouncer(IAnnouncer *listener);
+    /*!
+      \brief Register a listener for announcements
+      \param listener the listener
+      \param flags mask of the AnnouncementFlags the listener is interested in, it is not called
+      for any other announcement
+      */
+    void AddAnnouncer(IAnnouncer *listener, int flags = ANNOUNCE_ALL | Info);
     void RemoveAnnouncer(IAnnouncer *listener);
 
     void Announce(AnnouncementFlag flag, const std::string& message);
@@ -61,17 +71,24 @@ namespace ANNOUNCEMENT
     // a big number of python addons and third party json consumers.
     static const std::string ANNOUNCEMENT_SENDER;
 
+    struct Stats
+    {
+      unsigned int announced = 0;
+      unsigned int coalesced = 0; //!< merged into an announcement still queued
+      unsigned int delivered = 0;
+      unsigned int batches = 0;
+      size_t queueLength = 0;
+      size_t maxQueueLength = 0;
+      uint64_t totalLatency = 0; //!< milliseconds from Announce() until delivered, of all
+      unsigned int maxLatency = 0; //!< milliseconds
+    };
+
+    Stats GetStats() const;
+
   protected:
     void Process() override;
-    void DoAnnounce(AnnouncementFlag flag,
-                    const std::string& sender,
-                    const std::string& message,
-                    const std::shared_ptr<CFileItem>& item,
-                    const CVariant& data);
-    void DoAnnounce(AnnouncementFlag flag,
-                    const std::string& sender,
-                    const std::string& message,
-                    const CVariant& data);
+    CVariant GetItemData(const std::shared_ptr<CFileItem>& item, const CVariant& data);
+    void DoAnnounce(const std::vector<Announcement>& announcements);
 
     struct CAnnounceData
     {
@@ -80,6 +97,9 @@ namespace ANNOUNCEMENT
       std::string message;
       std::shared_ptr<CFileItem> item;
       CVariant data;
+      std::chrono::steady_clock::time_point queued;
+      std::chrono::steady_clock::time_point due; //!< end of its coalescing window
+      std::string key; //!< library item it is about, empty if it can't be coalesced
     };
     std::list<CAnnounceData> m_announcementQueue;
     CEvent m_queueEvent;
@@ -88,8 +108,17 @@ namespace ANNOUNCEMENT
     CAnnouncementManager(const CAnnouncementManager&) = delete;
     CAnnouncementManager const& operator=(CAnnouncementManager const&) = delete;
 
-    CCriticalSection m_announcersCritSection;
-    CCriticalSection m_queueCritSection;
-    std::vector<IAnnouncer *> m_announcers;
+    struct Announcer
+    {
+      IAnnouncer* listener;
+      int flags;
+    };
+
+    mutable CCriticalSection m_announcersCritSection;
+    mutable CCriticalSection m_queueCritSection;
+    std::vector<Announcer> m_announcers;
+    //! latest queued announcement about each library item
+    std::map<std::string, std::list<CAnnounceData>::iterator> m_pending;
+    Stats m_stats;
   };
 }
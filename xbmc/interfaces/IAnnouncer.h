@@ -8,9 +8,11 @@
 
 #pragma once
 
+#include "utils/Variant.h"
+
 #include <string>
+#include <vector>
 
-class CVariant;
 namespace ANNOUNCEMENT
 {
   enum AnnouncementFlag
@@ -67,6 +69,14 @@ namespace ANNOUNCEMENT
     }
   }
 
+  struct Announcement
+  {
+    AnnouncementFlag flag;
+    std::string sender;
+    std::string message;
+    CVariant data;
+  };
+
   class IAnnouncer
   {
   public:
@@ -76,5 +86,16 @@ namespace ANNOUNCEMENT
                           const std::string& sender,
                           const std::string& message,
                           const CVariant& data) = 0;
+
+    /*!
+      \brief Receive the announcements that were due at the same time, in order
+      Listeners that can handle a burst of announcements at once (e.g. the updates of a library
+      scan) override this, by default each announcement is passed to Announce().
+      */
+    virtual void AnnounceBatch(const std::vector<Announcement>& announcements)
+    {
+      for (const auto& announcement : announcements)
+        Announce(announcement.flag, announcement.sender, announcement.message, announcement.data);
+    }
   };
 }
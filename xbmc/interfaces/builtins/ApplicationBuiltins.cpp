@@ -18,12 +18,16 @@
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
+#include "utils/Benchmark.h"
 #include "utils/JSONVariantParser.h"
+#include "utils/JobManager.h"
+#include "utils/Profiler.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 #include "utils/Variant.h"
 #include "utils/log.h"
 
+#include <algorithm>
 #include <stdlib.h>
 
 /*! \brief Extract an archive.
@@ -124,6 +128,36 @@ static int SetVolume(const std::vector<std::string>& params)
   return 0;
 }
 
+#ifdef HAS_PROFILER
+/*! \brief Run a benchmark suite in the background.
+ *  \param params The parameters.
+ *  \details params[0] = The suite, "core" or "library".
+ *           params[1] = The scale of its data (optional), 1 by default.
+ *           params[2] = "update" to store the results as the baseline (optional).
+ */
+static int Benchmark(const std::vector<std::string>& params)
+{
+  const std::string suite = params[0];
+  const unsigned int scale = params.size() > 1 ? std::max(atoi(params[1].c_str()), 1) : 1;
+  const bool update = params.size() > 2 && StringUtils::EqualsNoCase(params[2], "update");
+  CServiceBroker::GetJobManager()->Submit(
+      [suite, scale, update]() { CBenchmark::RunSuite(suite, scale, update); });
+
+  return 0;
+}
+
+/*! \brief Write the recorded timing zones as a Chrome trace.
+ *  \param params The parameters.
+ *  \details params[0] = The file to write to (optional), special://temp/profile.json by default.
+ */
+static int DumpProfile(const std::vector<std::string>& params)
+{
+  CProfiler::Dump(params.empty() ? "special://temp/profile.json" : params[0]);
+
+  return 0;
+}
+#endif
+
 /*! \brief Toggle debug info.
  *  \param params (ignored)
  */
@@ -224,6 +258,10 @@ static int WakeOnLAN(const std::vector<std::string>& params)
 CBuiltins::CommandMap CApplicationBuiltins::GetOperations() const
 {
   return {
+#ifdef HAS_PROFILER
+           {"benchmark", {"Runs a benchmark suite and compares it with its baseline", 1, Benchmark}},
+           {"dumpprofile", {"Writes the recorded timing zones as a Chrome trace", 0, DumpProfile}},
+#endif
            {"extract", {"Extracts the specified archive", 1, Extract}},
            {"mute", {"Mute the player", 0, Mute}},
            {"notifyall", {"Notify all connected clients", 2, NotifyAll}},
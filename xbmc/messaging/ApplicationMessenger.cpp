@@ -12,9 +12,11 @@
 #include "guilib/GUIMessage.h"
 #include "messaging/IMessageTarget.h"
 #include "threads/SingleLock.h"
+#include "utils/Profiler.h"
 #include "utils/log.h"
 #include "guilib/GraphicContext.h"
 
+#include <algorithm>
 #include <memory>
 #include <mutex>
 #include <utility>
@@ -24,6 +26,70 @@ namespace KODI
 namespace MESSAGING
 {
 
+namespace
+{
+// time a frame spends on each message queue before leaving the rest for the next frame
+constexpr auto MESSAGE_BUDGET = std::chrono::milliseconds(8);
+
+void AddToHistogram(std::array<unsigned int, 8>& histogram, size_t value)
+{
+  size_t bucket = 0;
+  for (size_t limit = 1; bucket < histogram.size() - 1 && value >= limit; limit *= 4)
+    bucket++;
+  histogram[bucket]++;
+}
+} // unnamed namespace
+
+void CApplicationMessenger::CMessageQueue::Push(ThreadMessage&& msg)
+{
+  if (m_count == m_slots.size())
+  {
+    // full, grow the ring and unwrap it so the oldest message is in front again
+    std::vector<Slot> slots(std::max<size_t>(16, m_slots.size() * 2));
+    for (size_t i = 0; i < m_count; i++)
+      slots[i] = std::move(m_slots[(m_head + i) % m_slots.size()]);
+    m_slots.swap(slots);
+    m_head = 0;
+  }
+
+  AddToHistogram(m_stats.depth, m_count);
+  m_stats.maxDepth = std::max(m_stats.maxDepth, m_count + 1);
+
+  if (msg.waitEvent)
+    m_waiters++;
+
+  Slot& slot = m_slots[(m_head + m_count) % m_slots.size()];
+  slot.msg = std::move(msg);
+  slot.queued = std::chrono::steady_clock::now();
+  m_count++;
+}
+
+void CApplicationMessenger::CMessageQueue::Pop(ThreadMessage& msg)
+{
+  Slot& slot = m_slots[m_head];
+  msg = std::move(slot.msg);
+  m_head = (m_head + 1) % m_slots.size();
+  m_count--;
+
+  if (msg.waitEvent)
+    m_waiters--;
+
+  AddToHistogram(m_stats.latency, std::chrono::duration_cast<std::chrono::milliseconds>(
+                                      std::chrono::steady_clock::now() - slot.queued)
+                                      .count());
+}
+
+void CApplicationMessenger::CMessageQueue::Clear()
+{
+  ThreadMessage msg;
+  while (!Empty())
+  {
+    Pop(msg);
+    if (msg.waitEvent)
+      msg.waitEvent->Set();
+  }
+}
+
 class CDelayedMessage : public CThread
 {
   public:
@@ -61,27 +127,8 @@ void CApplicationMessenger::Cleanup()
 {
   std::unique_lock<CCriticalSection> lock(m_critSection);
 
-  while (!m_vecMessages.empty())
-  {
-    ThreadMessage* pMsg = m_vecMessages.front();
-
-    if (pMsg->waitEvent)
-      pMsg->waitEvent->Set();
-
-    delete pMsg;
-    m_vecMessages.pop();
-  }
-
-  while (!m_vecWindowMessages.empty())
-  {
-    ThreadMessage* pMsg = m_vecWindowMessages.front();
-
-    if (pMsg->waitEvent)
-      pMsg->waitEvent->Set();
-
-    delete pMsg;
-    m_vecWindowMessages.pop();
-  }
+  m_messages.Clear();
+  m_windowMessages.Clear();
 }
 
 int CApplicationMessenger::SendMsg(ThreadMessage&& message, bool wait)
@@ -114,17 +161,15 @@ int CApplicationMessenger::SendMsg(ThreadMessage&& message, bool wait)
   if (m_bStop)
     return -1;
 
-  ThreadMessage* msg = new ThreadMessage(std::move(message));
-
   std::unique_lock<CCriticalSection> lock(m_critSection);
 
-  if (msg->dwMessage == TMSG_GUI_MESSAGE)
-    m_vecWindowMessages.push(msg);
+  if (message.dwMessage == TMSG_GUI_MESSAGE)
+    m_windowMessages.Push(std::move(message));
   else
-    m_vecMessages.push(msg);
-  lock.unlock(); // this releases the lock on the vec of messages and
+    m_messages.Push(std::move(message));
+  lock.unlock(); // this releases the lock on the queue of messages and
       //   allows the ProcessMessage to execute and therefore
-      //   delete the message itself. Therefore any access
+      //   reuse the slot of the message. Therefore any access
       //   of the message itself after this point constitutes
       //   a race condition (yarc - "yet another race condition")
       //
@@ -204,28 +249,9 @@ void CApplicationMessenger::PostMsg(uint32_t messageId, int param1, int param2,
 
 void CApplicationMessenger::ProcessMessages()
 {
+  PROFILE_ZONE("CApplicationMessenger::ProcessMessages");
   // process threadmessages
-  std::unique_lock<CCriticalSection> lock(m_critSection);
-  while (!m_vecMessages.empty())
-  {
-    ThreadMessage* pMsg = m_vecMessages.front();
-    //first remove the message from the queue, else the message could be processed more then once
-    m_vecMessages.pop();
-
-    //Leave here as the message might make another
-    //thread call processmessages or sendmessage
-
-    std::shared_ptr<CEvent> waitEvent = pMsg->waitEvent;
-    lock.unlock(); // <- see the large comment in SendMessage ^
-
-    ProcessMessage(pMsg);
-
-    if (waitEvent)
-      waitEvent->Set();
-    delete pMsg;
-
-    lock.lock();
-  }
+  ProcessQueue(m_messages);
 }
 
 void CApplicationMessenger::ProcessMessage(ThreadMessage *pMsg)
@@ -253,23 +279,40 @@ void CApplicationMessenger::ProcessMessage(ThreadMessage *pMsg)
 
 void CApplicationMessenger::ProcessWindowMessages()
 {
-  std::unique_lock<CCriticalSection> lock(m_critSection);
+  PROFILE_ZONE("CApplicationMessenger::ProcessWindowMessages");
   //message type is window, process window messages
-  while (!m_vecWindowMessages.empty())
+  ProcessQueue(m_windowMessages);
+}
+
+void CApplicationMessenger::ProcessQueue(CMessageQueue& queue)
+{
+  const auto end = std::chrono::steady_clock::now() + MESSAGE_BUDGET;
+  ThreadMessage msg;
+
+  std::unique_lock<CCriticalSection> lock(m_critSection);
+  while (!queue.Empty())
   {
-    ThreadMessage* pMsg = m_vecWindowMessages.front();
+    // a thread blocked in SendMsg shouldn't wait for frames to be rendered, so the queue is
+    // worked through up to its message regardless of the budget. Order is kept either way.
+    if (std::chrono::steady_clock::now() >= end && !queue.HasWaiters())
+    {
+      queue.m_stats.deferred++;
+      break;
+    }
+
     //first remove the message from the queue, else the message could be processed more then once
-    m_vecWindowMessages.pop();
+    queue.Pop(msg);
 
-    // leave here in case we make more thread messages from this one
+    //Leave here as the message might make another
+    //thread call processmessages or sendmessage
 
-    std::shared_ptr<CEvent> waitEvent = pMsg->waitEvent;
+    std::shared_ptr<CEvent> waitEvent = std::move(msg.waitEvent);
     lock.unlock(); // <- see the large comment in SendMessage ^
 
-    ProcessMessage(pMsg);
+    ProcessMessage(&msg);
+
     if (waitEvent)
       waitEvent->Set();
-    delete pMsg;
 
     lock.lock();
   }
@@ -289,6 +332,12 @@ void CApplicationMessenger::RegisterReceiver(IMessageTarget* target)
   m_mapTargets.insert(std::make_pair(target->GetMessageMask(), target));
 }
 
+CApplicationMessenger::QueueStats CApplicationMessenger::GetQueueStats(bool windowMessages) const
+{
+  std::unique_lock<CCriticalSection> lock(m_critSection);
+  return windowMessages ? m_windowMessages.m_stats : m_messages.m_stats;
+}
+
 bool CApplicationMessenger::IsProcessThread() const
 {
   return m_processThreadId == CThread::GetCurrentThreadId();
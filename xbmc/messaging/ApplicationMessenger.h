@@ -12,9 +12,10 @@
 #include "messaging/ThreadMessage.h"
 #include "threads/Thread.h"
 
+#include <array>
+#include <chrono>
 #include <map>
 #include <memory>
-#include <queue>
 #include <string>
 #include <vector>
 
@@ -419,17 +420,66 @@ public:
   //! \brief Returns true if this is the process / app loop thread.
   bool IsProcessThread() const;
 
+  /*!
+   * \brief Histograms of a message queue, to see how far behind its processing is
+   * Bucket 0 counts zero, bucket i counts values from 4^(i-1) up to 4^i, the last bucket the rest.
+   */
+  struct QueueStats
+  {
+    std::array<unsigned int, 8> depth{}; //!< messages already queued when one is added
+    std::array<unsigned int, 8> latency{}; //!< milliseconds from queueing to processing
+    size_t maxDepth = 0;
+    unsigned int deferred = 0; //!< times messages were left for the next frame
+  };
+
+  /*!
+   * \brief Get the statistics of a message queue
+   * \param windowMessages the UI message queue instead of the regular one
+   */
+  QueueStats GetQueueStats(bool windowMessages) const;
+
 private:
   CApplicationMessenger(const CApplicationMessenger&) = delete;
   CApplicationMessenger const& operator=(CApplicationMessenger const&) = delete;
 
+  /*!
+   * \brief FIFO of messages in a ring buffer
+   * The buffer only grows, to the largest backlog seen. Queueing a message then moves it into a
+   * free slot rather than allocating it.
+   */
+  class CMessageQueue
+  {
+  public:
+    void Push(ThreadMessage&& msg);
+    void Pop(ThreadMessage& msg);
+    bool Empty() const { return m_count == 0; }
+    //! whether a thread waits for one of the queued messages to be processed
+    bool HasWaiters() const { return m_waiters > 0; }
+    void Clear();
+
+    QueueStats m_stats;
+
+  private:
+    struct Slot
+    {
+      ThreadMessage msg;
+      std::chrono::steady_clock::time_point queued;
+    };
+
+    std::vector<Slot> m_slots;
+    size_t m_head = 0;
+    size_t m_count = 0;
+    size_t m_waiters = 0;
+  };
+
   int SendMsg(ThreadMessage&& msg, bool wait);
   void ProcessMessage(ThreadMessage *pMsg);
+  void ProcessQueue(CMessageQueue& queue);
 
-  std::queue<ThreadMessage*> m_vecMessages; /*!< queue for regular messages */
-  std::queue<ThreadMessage*> m_vecWindowMessages; /*!< queue for UI messages */
+  CMessageQueue m_messages; /*!< queue for regular messages */
+  CMessageQueue m_windowMessages; /*!< queue for UI messages */
   std::map<int, IMessageTarget*> m_mapTargets; /*!< a map of registered receivers indexed on the message mask*/
-  CCriticalSection m_critSection;
+  mutable CCriticalSection m_critSection;
   std::thread::id m_guiThreadId;
   std::thread::id m_processThreadId;
   bool m_bStop{ false };
@@ -30,6 +30,7 @@
 #include "filesystem/Directory.h"
 #include "filesystem/DirectoryCache.h"
 #include "filesystem/File.h"
+#include "filesystem/FileExistenceChecker.h"
 #include "filesystem/MusicDatabaseDirectory/DirectoryNode.h"
 #include "guilib/GUIComponent.h"
 #include "guilib/GUIWindowManager.h"
@@ -75,8 +76,11 @@ using namespace CDDB;
 using namespace MEDIA_DETECT;
 #endif
 
-static void AnnounceRemove(const std::string& content, int id)
+void CMusicDatabase::AnnounceRemove(const std::string& content, int id) const
 {
+  if (!m_announceChanges)
+    return;
+
   CVariant data;
   data["type"] = content;
   data["id"] = id;
@@ -85,8 +89,13 @@ static void AnnounceRemove(const std::string& content, int id)
   CServiceBroker::GetAnnouncementManager()->Announce(ANNOUNCEMENT::AudioLibrary, "OnRemove", data);
 }
 
-static void AnnounceUpdate(const std::string& content, int id, bool added = false)
+void CMusicDatabase::AnnounceUpdate(const std::string& content,
+                                    int id,
+                                    bool added /* = false */) const
 {
+  if (!m_announceChanges)
+    return;
+
   CVariant data;
   data["type"] = content;
   data["id"] = id;
@@ -97,9 +106,31 @@ static void AnnounceUpdate(const std::string& content, int id, bool added = fals
   CServiceBroker::GetAnnouncementManager()->Announce(ANNOUNCEMENT::AudioLibrary, "OnUpdate", data);
 }
 
+// full text search indexes, the first column is the most relevant one
+struct MusicSearchIndex
+{
+  const char* searchTable;
+  const char* contentTable;
+  const char* idColumn;
+  std::vector<std::string> columns;
+};
+
+static const MusicSearchIndex musicSearchIndexes[] = {
+    {"artistsearch", "artist", "idArtist", {"strArtist", "strSortName"}},
+    {"albumsearch", "album", "idAlbum", {"strAlbum", "strArtistDisp"}},
+    {"songsearch", "song", "idSong", {"strTitle", "strArtistDisp"}},
+};
+
+// binary sort keys of titles ignoring articles, SQLite only
+static const std::vector<CDatabase::SortKeyColumn> musicSortKeys = {
+    {"album", "idAlbum", "strAlbum", "strAlbumSortKey"},
+    {"song", "idSong", "strTitle", "strTitleSortKey"},
+};
+
 CMusicDatabase::CMusicDatabase(void)
 {
   m_translateBlankArtist = true;
+  m_announceChanges = true;
 }
 
 CMusicDatabase::~CMusicDatabase(void)
@@ -157,7 +188,7 @@ void CMusicDatabase::CreateTables()
               " iDiscTotal INTEGER NOT NULL DEFAULT 0, "
               " iAlbumDuration INTEGER NOT NULL DEFAULT 0, "
               " idInfoSetting INTEGER NOT NULL DEFAULT 0, "
-              " dateAdded TEXT, dateNew TEXT, dateModified TEXT)");
+              " dateAdded TEXT, dateNew TEXT, dateModified TEXT, strAlbumSortKey TEXT)");
 
   CLog::Log(LOGINFO, "create audiobook table");
   m_pDS->exec("CREATE TABLE audiobook (idBook integer primary key, "
@@ -200,7 +231,7 @@ void CMusicDatabase::CreateTables()
               " iBitRate INTEGER NOT NULL DEFAULT 0, "
               " iSampleRate INTEGER NOT NULL DEFAULT 0, iChannels INTEGER NOT NULL DEFAULT 0, "
               " strReplayGain text, "
-              " dateAdded TEXT, dateNew TEXT, dateModified TEXT)");
+              " dateAdded TEXT, dateNew TEXT, dateModified TEXT, strTitleSortKey TEXT)");
   CLog::Log(LOGINFO, "create song_artist table");
   m_pDS->exec("CREATE TABLE song_artist (idArtist integer, idSong integer, idRole integer, iOrder "
               "integer, strArtist text)");
@@ -235,6 +266,11 @@ void CMusicDatabase::CreateTables()
 
   CLog::Log(LOGINFO, "create removed_link table");
   m_pDS->exec("CREATE TABLE removed_link (idArtist INTEGER, idMedia INTEGER, idRole INTEGER)");
+
+  for (const auto& index : musicSearchIndexes)
+    CreateSearchTable(index.searchTable, index.contentTable, index.idColumn, index.columns);
+
+  CreateSortKeyTable();
 }
 
 void CMusicDatabase::CreateAnalytics()
@@ -326,8 +362,10 @@ void CMusicDatabase::CreateAnalytics()
                 " AND NEW.dateNew IS NULL;"
                 " UPDATE song SET dateModified = DATETIME('now') WHERE idSong = NEW.idSong;"
                 " END");
+    // Refreshing the title sort keys is not a modification of the song or album
     m_pDS->exec("CREATE TRIGGER tgrUpdateSong AFTER UPDATE ON song FOR EACH ROW"
-                " WHEN NEW.dateModified <= OLD.dateModified BEGIN"
+                " WHEN NEW.dateModified <= OLD.dateModified"
+                " AND NEW.strTitleSortKey IS OLD.strTitleSortKey BEGIN"
                 " UPDATE song SET dateModified = DATETIME('now') WHERE idSong = OLD.idSong;"
                 " END");
     m_pDS->exec("CREATE TRIGGER tgrInsertAlbum AFTER INSERT ON album FOR EACH ROW BEGIN"
@@ -336,7 +374,8 @@ void CMusicDatabase::CreateAnalytics()
                 " UPDATE album SET dateModified = DATETIME('now') WHERE idAlbum = NEW.idAlbum;"
                 " END");
     m_pDS->exec("CREATE TRIGGER tgrUpdateAlbum AFTER UPDATE ON album FOR EACH ROW"
-                " WHEN NEW.dateModified <= OLD.dateModified BEGIN"
+                " WHEN NEW.dateModified <= OLD.dateModified"
+                " AND NEW.strAlbumSortKey IS OLD.strAlbumSortKey BEGIN"
                 " UPDATE album SET dateModified = DATETIME('now') WHERE idAlbum = OLD.idAlbum;"
                 " END");
     m_pDS->exec("CREATE TRIGGER tgrInsertArtist AFTER INSERT ON artist FOR EACH ROW BEGIN"
@@ -391,6 +430,14 @@ void CMusicDatabase::CreateAnalytics()
               "END");
   CreateRemovedLinkTriggers(); // DELETE ON song_artist and album_artist tables
 
+  // Triggers to keep the full text search indexes up to date (SQLite only)
+  for (const auto& index : musicSearchIndexes)
+    CreateSearchTriggers(index.searchTable, index.contentTable, index.idColumn, index.columns);
+
+  // Index and triggers maintaining the title sort keys (SQLite only)
+  for (const auto& sortKey : musicSortKeys)
+    CreateSortKeyTriggers(sortKey);
+
   // Create native functions stored in DB (MySQL/MariaDB only)
   CreateNativeDBFunctions();
 
@@ -452,7 +499,9 @@ void CMusicDatabase::CreateViews()
               "        album.iDiscTotal as iDiscTotal, "
               "        song.dateAdded as dateAdded, "
               "        song.dateNew AS dateNew, "
-              "        song.dateModified AS dateModified "
+              "        song.dateModified AS dateModified, "
+              "        song.strTitleSortKey AS strTitleSortKey, "
+              "        album.strAlbumSortKey AS strAlbumSortKey "
               "FROM song"
               "  JOIN album ON"
               "    song.idAlbum=album.idAlbum"
@@ -492,7 +541,8 @@ void CMusicDatabase::CreateViews()
               "iDiscTotal, "
               "(SELECT MAX(song.lastplayed) FROM song "
               "WHERE song.idAlbum = album.idAlbum) AS lastplayed, "
-              "iAlbumDuration "
+              "iAlbumDuration, "
+              "strAlbumSortKey "
               "FROM album");
 
   CLog::Log(LOGINFO, "create artist view");
@@ -3348,7 +3398,12 @@ bool CMusicDatabase::SearchArtists(const std::string& search, CFileItemList& art
 
     std::string strVariousArtists = g_localizeStrings.Get(340).c_str();
     std::string strSQL;
-    if (search.size() >= MIN_FULL_SEARCH_LENGTH)
+    std::string searchJoin = PrepareSearchJoin("artistsearch", "artist.idArtist", search);
+    if (!searchJoin.empty())
+      strSQL = "SELECT artist.* FROM artist" + searchJoin +
+               PrepareSQL(" WHERE strArtist <> '%s' ORDER BY searchRank",
+                          strVariousArtists.c_str());
+    else if (search.size() >= MIN_FULL_SEARCH_LENGTH)
       strSQL = PrepareSQL("SELECT * FROM artist "
                           "WHERE (strArtist LIKE '%s%%' OR strArtist LIKE '%% %s%%') "
                           "AND strArtist <> '%s' ",
@@ -3995,7 +4050,10 @@ bool CMusicDatabase::SearchSongs(const std::string& search, CFileItemList& items
       return false;
 
     std::string strSQL;
-    if (search.size() >= MIN_FULL_SEARCH_LENGTH)
+    std::string searchJoin = PrepareSearchJoin("songsearch", "songview.idSong", search);
+    if (!searchJoin.empty())
+      strSQL = "SELECT songview.* FROM songview" + searchJoin + " ORDER BY searchRank LIMIT 1000";
+    else if (search.size() >= MIN_FULL_SEARCH_LENGTH)
       strSQL = PrepareSQL("SELECT * FROM songview "
                           "WHERE strTitle LIKE '%s%%' or strTitle LIKE '%% %s%%' LIMIT 1000",
                           search.c_str(), search.c_str());
@@ -4038,7 +4096,10 @@ bool CMusicDatabase::SearchAlbums(const std::string& search, CFileItemList& albu
       return false;
 
     std::string strSQL;
-    if (search.size() >= MIN_FULL_SEARCH_LENGTH)
+    std::string searchJoin = PrepareSearchJoin("albumsearch", "albumview.idAlbum", search);
+    if (!searchJoin.empty())
+      strSQL = "SELECT albumview.* FROM albumview" + searchJoin + " ORDER BY searchRank";
+    else if (search.size() >= MIN_FULL_SEARCH_LENGTH)
       strSQL = PrepareSQL("SELECT * FROM albumview "
                           "WHERE strAlbum LIKE '%s%%' OR strAlbum LIKE '%% %s%%'",
                           search.c_str(), search.c_str());
@@ -4094,7 +4155,9 @@ bool CMusicDatabase::CleanupSongsByIds(const std::string& strSongIds)
       m_pDS->close();
       return true;
     }
-    std::vector<std::string> songsToDelete;
+    // check all songs at once, listing every folder only once
+    CFileExistenceChecker checker;
+    std::vector<std::pair<std::string, size_t>> songs;
     while (!m_pDS->eof())
     { // get the full song path
       std::string strFileName = URIUtils::AddFileToFolder(
@@ -4111,14 +4174,34 @@ bool CMusicDatabase::CleanupSongsByIds(const std::string& strSongIds)
         URIUtils::RemoveSlashAtEnd(strFileName);
       }
 
-      if (!CFile::Exists(strFileName, false))
-      { // file no longer exists, so add to deletion list
-        songsToDelete.push_back(m_pDS->fv("song.idSong").get_asString());
-      }
+      songs.emplace_back(m_pDS->fv("song.idSong").get_asString(), checker.Add(strFileName));
       m_pDS->next();
     }
     m_pDS->close();
 
+    checker.Check();
+
+    std::vector<std::string> songsToDelete;
+    unsigned int unreachable = 0;
+    for (const auto& song : songs)
+    {
+      switch (checker.GetState(song.second))
+      {
+        case CFileExistenceChecker::State::MISSING:
+          // file no longer exists, so add to deletion list
+          songsToDelete.push_back(song.first);
+          break;
+        case CFileExistenceChecker::State::UNKNOWN:
+          // never remove songs from a share that is offline
+          unreachable++;
+          break;
+        default:
+          break;
+      }
+    }
+    if (unreachable > 0)
+      CLog::Log(LOGINFO, "{} - keeping {} songs that can't be reached", __FUNCTION__, unreachable);
+
     if (!songsToDelete.empty())
     {
       std::string strSongsToDelete = "(" + StringUtils::Join(songsToDelete, ",") + ")";
@@ -4147,22 +4230,27 @@ bool CMusicDatabase::CleanupSongs(CGUIDialogProgress* progressDialog /*= nullptr
     if (total == 0)
       return true;
 
-    // run through all songs and get all unique path ids
-    int iLIMIT = 1000;
-    for (int i = 0;; i += iLIMIT)
+    // get all the folders holding songs, and check the songs a few folders at a time so that
+    // every folder is only listed once
+    if (!m_pDS->query("SELECT DISTINCT idPath FROM song"))
+      return false;
+    std::vector<std::string> pathIds;
+    while (!m_pDS->eof())
+    {
+      pathIds.push_back(m_pDS->fv(0).get_asString());
+      m_pDS->next();
+    }
+    m_pDS->close();
+
+    const size_t iLIMIT = 100;
+    for (size_t i = 0; i < pathIds.size(); i += iLIMIT)
     {
-      std::string strSQL = PrepareSQL("SELECT song.idSong FROM song "
-                                      "ORDER BY song.idSong LIMIT %i OFFSET %i",
-                                      iLIMIT, i);
+      std::vector<std::string> batch(pathIds.begin() + i,
+                                     pathIds.begin() + std::min(i + iLIMIT, pathIds.size()));
+      std::string strSQL = "SELECT song.idSong FROM song WHERE idPath IN (" +
+                           StringUtils::Join(batch, ",") + ")";
       if (!m_pDS->query(strSQL))
         return false;
-      int iRowsFound = m_pDS->num_rows();
-      // keep going until no rows are left!
-      if (iRowsFound == 0)
-      {
-        m_pDS->close();
-        return true;
-      }
 
       std::vector<std::string> songIds;
       while (!m_pDS->eof())
@@ -4175,7 +4263,7 @@ bool CMusicDatabase::CleanupSongs(CGUIDialogProgress* progressDialog /*= nullptr
       CLog::Log(LOGDEBUG, "Checking songs from song ID list: {}", strSongIds);
       if (progressDialog)
       {
-        int percentage = i * 100 / total;
+        int percentage = static_cast<int>(i * 100 / pathIds.size());
         if (percentage > progressDialog->GetPercentage())
         {
           progressDialog->SetPercentage(percentage);
@@ -4542,6 +4630,12 @@ int CMusicDatabase::Cleanup(CGUIDialogProgress* progressDialog /*= nullptr*/)
     ret = ERROR_REORG_OTHER;
     goto error;
   }
+  // Refresh the sort keys when the articles to ignore have changed
+  if (!UpdateSortKeys(musicSortKeys))
+  {
+    ret = ERROR_REORG_OTHER;
+    goto error;
+  }
 
   // commit transaction
   if (progressDialog)
@@ -9287,6 +9381,25 @@ void CMusicDatabase::UpdateTables(int version)
     m_pDS->exec("DROP TABLE artist");
     m_pDS->exec("ALTER TABLE artist_new RENAME TO artist");
   }
+  if (version < 83)
+  {
+    for (const auto& index : musicSearchIndexes)
+      CreateSearchTable(index.searchTable, index.contentTable, index.idColumn, index.columns);
+  }
+
+  if (version < 84)
+  {
+    m_pDS->exec("ALTER TABLE album ADD strAlbumSortKey TEXT");
+    m_pDS->exec("ALTER TABLE song ADD strTitleSortKey TEXT");
+    CreateSortKeyTable();
+  }
+
+  // The search triggers don't exist while updating, so index whatever has been changed
+  for (const auto& index : musicSearchIndexes)
+    RebuildSearchTable(index.searchTable);
+  // Same for the sort keys
+  UpdateSortKeys(musicSortKeys, true);
+
   // Set the version of tag scanning required.
   // Not every schema change requires the tags to be rescanned, set to the highest schema version
   // that needs this. Forced rescanning (of music files that have not changed since they were
@@ -9307,7 +9420,7 @@ void CMusicDatabase::UpdateTables(int version)
 
 int CMusicDatabase::GetSchemaVersion() const
 {
-  return 82;
+  return 85;
 }
 
 int CMusicDatabase::GetMusicNeedsTagScan()
@@ -9428,6 +9541,7 @@ std::string CMusicDatabase::GetArtistsLastModified()
 }
 
 unsigned int CMusicDatabase::GetRandomSongIDs(const Filter& filter,
+                                              unsigned int count,
                                               std::vector<std::pair<int, int>>& songIDs)
 {
   try
@@ -9437,27 +9551,54 @@ unsigned int CMusicDatabase::GetRandomSongIDs(const Filter& filter,
     if (nullptr == m_pDS)
       return 0;
 
-    std::string strSQL = "SELECT idSong FROM songview ";
-    if (!CDatabase::BuildSQL(strSQL, filter, strSQL))
-      return false;
-    strSQL += PrepareSQL(" ORDER BY RANDOM()");
+    // songs picked before, for as long as this connection is open
+    m_pDS->exec("CREATE TEMPORARY TABLE IF NOT EXISTS tmp_randomsongs (idSong INTEGER PRIMARY KEY)");
+    Filter remaining(filter);
+    remaining.AppendWhere("NOT EXISTS (SELECT 1 FROM tmp_randomsongs "
+                          "WHERE tmp_randomsongs.idSong = songview.idSong)");
 
+    std::string strSQL = "SELECT COUNT(1) FROM songview ";
+    if (!CDatabase::BuildSQL(strSQL, remaining, strSQL))
+      return 0;
     if (!m_pDS->query(strSQL))
       return 0;
-    songIDs.clear();
-    if (m_pDS->num_rows() == 0)
-    {
-      m_pDS->close();
+    const unsigned int total = m_pDS->eof() ? 0 : m_pDS->fv(0).get_asInt();
+    m_pDS->close();
+    if (count == 0 || total == 0)
+      return total;
+
+    // the songs at random offsets are collected in a single pass over the ids in order, up to
+    // the last offset. Sorting all of them at random is avoided.
+    std::vector<unsigned int> offsets = KODI::UTILS::RandomSample(total, count);
+    std::sort(offsets.begin(), offsets.end());
+    strSQL = "SELECT songview.idSong FROM songview ";
+    if (!CDatabase::BuildSQL(strSQL, remaining, strSQL))
       return 0;
-    }
-    songIDs.reserve(m_pDS->num_rows());
-    while (!m_pDS->eof())
+    strSQL += PrepareSQL(" ORDER BY songview.idSong LIMIT %u", offsets.back() + 1);
+    if (!m_pDS->query(strSQL))
+      return 0;
+
+    std::vector<std::string> picked;
+    picked.reserve(offsets.size());
+    auto offset = offsets.begin();
+    for (unsigned int row = 0; !m_pDS->eof() && offset != offsets.end(); row++, m_pDS->next())
     {
-      songIDs.push_back(std::make_pair<int, int>(1, m_pDS->fv(song_idSong).get_asInt()));
-      m_pDS->next();
-    } // cleanup
+      if (row == *offset)
+      {
+        picked.emplace_back(m_pDS->fv(0).get_asString());
+        ++offset;
+      }
+    }
     m_pDS->close();
-    return static_cast<unsigned int>(songIDs.size());
+    if (picked.empty())
+      return total;
+
+    m_pDS->exec("INSERT INTO tmp_randomsongs (idSong) VALUES (" +
+                StringUtils::Join(picked, "),(") + ")");
+    KODI::UTILS::RandomShuffle(picked.begin(), picked.end());
+    for (const std::string& idSong : picked)
+      songIDs.emplace_back(1, std::stoi(idSong));
+    return total;
   }
   catch (...)
   {
@@ -13113,6 +13254,14 @@ int CMusicDatabase::GetOrderFilter(const std::string& type,
       // Natural number case-insensitive sort
       filter.AppendOrder(AlphanumericSortSQL(name, sorting.sortOrder));
     }
+    else if ((StringUtils::EndsWith(name, "strAlbum") || StringUtils::EndsWith(name, "strTitle")) &&
+             (sorting.sortAttributes & SortAttributeIgnoreArticle) && HasSortKeys())
+    {
+      // Binary sort key stored along with the title, ordering walks its index
+      filter.AppendField(name + "SortKey AS titlesortname");
+      iFieldsAdded++;
+      filter.AppendOrder("titlesortname" + DESC);
+    }
     else if (StringUtils::EndsWith(name, "strAlbum") || StringUtils::EndsWith(name, "strTitle"))
     {
       sortSQL = SortnameBuildSQL("titlesortname", sorting.sortAttributes, name, "");
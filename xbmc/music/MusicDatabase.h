@@ -400,6 +400,10 @@ public:
   bool UpdateArtistScrapedMBID(int idArtist, const std::string& strMusicBrainzArtistID);
   bool GetTranslateBlankArtist() { return m_translateBlankArtist; }
   void SetTranslateBlankArtist(bool translate) { m_translateBlankArtist = translate; }
+  /*! \brief Whether songs, albums and artists added, updated or removed are announced to the
+  AudioLibrary listeners. Off for databases other than the library, e.g. of the benchmarks.
+  */
+  void SetAnnounceChanges(bool announce) { m_announceChanges = announce; }
   bool HasArtistBeenScraped(int idArtist);
   bool ClearArtistLastScrapedTime(int idArtist);
   int AddArtistDiscography(int idArtist, const CDiscoAlbum& discoAlbum);
@@ -647,12 +651,16 @@ public:
   /////////////////////////////////////////////////
   // Party Mode
   /////////////////////////////////////////////////
-  /*! \brief Gets song IDs in random order that match the filter criteria
+  /*! \brief Picks song IDs at random from those that match the filter criteria
+  Songs picked are not picked again for as long as the database stays open.
   \param filter the criteria to apply in the query
-  \param songIDs a vector of <1, id> pairs suited to party mode use
-  \return count of song ids found.
+  \param count how many song ids to pick, 0 to only count the matching songs
+  \param songIDs [out] the picked ids are appended as <1, id> pairs suited to party mode use
+  \return count of songs matching the filter that weren't picked before.
   */
-  unsigned int GetRandomSongIDs(const Filter& filter, std::vector<std::pair<int, int>>& songIDs);
+  unsigned int GetRandomSongIDs(const Filter& filter,
+                                unsigned int count,
+                                std::vector<std::pair<int, int>>& songIDs);
 
   /////////////////////////////////////////////////
   // JSON-RPC
@@ -894,6 +902,9 @@ private:
   void CreateNativeDBFunctions();
   void CreateRemovedLinkTriggers();
 
+  void AnnounceRemove(const std::string& content, int id) const;
+  void AnnounceUpdate(const std::string& content, int id, bool added = false) const;
+
   void SplitPath(const std::string& strFileNameAndPath,
                  std::string& strPath,
                  std::string& strFileName);
@@ -978,6 +989,7 @@ private:
   bool MigrateSources();
 
   bool m_translateBlankArtist;
+  bool m_announceChanges;
 
   // Fields should be ordered as they
   // appear in the songview
@@ -1022,6 +1034,8 @@ private:
     song_dateAdded,
     song_dateNew,
     song_dateModified,
+    song_strTitleSortKey,
+    song_strAlbumSortKey,
     song_enumCount // end of the enum, do not add past here
   } SongFields;
 
@@ -1060,6 +1074,7 @@ private:
     album_iTotalDiscs,
     album_dtLastPlayed,
     album_iAlbumDuration,
+    album_strAlbumSortKey,
     album_enumCount // end of the enum, do not add past here
   } AlbumFields;
 
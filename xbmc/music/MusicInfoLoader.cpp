@@ -53,11 +53,7 @@ void CMusicInfoLoader::OnLoaderStart()
   if (!m_strCacheFileName.empty())
     LoadCache(m_strCacheFileName, *m_mapFileItems);
   else
-  {
-    m_mapFileItems->SetPath(m_pVecItems->GetPath());
-    m_mapFileItems->Load();
-    m_mapFileItems->SetFastLookup(true);
-  }
+    m_cachedItems.Open(m_pVecItems->GetDiscFileCache());
 
   m_strPrevPath.clear();
 
@@ -176,7 +172,8 @@ bool CMusicInfoLoader::LoadItemLookup(CFileItem* pItem)
   if ((!pItem->HasMusicInfoTag() || !pItem->GetMusicInfoTag()->Loaded()) && pItem->IsAudio())
   {
     // first check the cached item
-    CFileItemPtr mapItem = (*m_mapFileItems)[pItem->GetPath()];
+    CFileItemPtr mapItem = m_strCacheFileName.empty() ? m_cachedItems.Get(pItem->GetPath())
+                                                      : (*m_mapFileItems)[pItem->GetPath()];
     if (mapItem && mapItem->m_dateTime==pItem->m_dateTime && mapItem->HasMusicInfoTag() && mapItem->GetMusicInfoTag()->Loaded())
     { // Query map if we previously cached the file on HD
       *pItem->GetMusicInfoTag() = *mapItem->GetMusicInfoTag();
@@ -250,6 +247,7 @@ void CMusicInfoLoader::OnLoaderFinish()
 
   // cleanup cache loaded from HD
   m_mapFileItems->Clear();
+  m_cachedItems.Close();
 
   // Save loaded items to HD
   if (!m_strCacheFileName.empty())
@@ -9,6 +9,7 @@
 #pragma once
 
 #include "BackgroundInfoLoader.h"
+#include "FileItemListDiscCache.h"
 #include "MusicDatabase.h"
 
 class CFileItemList;
@@ -36,6 +37,7 @@ protected:
 protected:
   std::string m_strCacheFileName;
   CFileItemList* m_mapFileItems;
+  CFileItemListDiscCache m_cachedItems;
   MAPSONGS m_songsMap;
   std::string m_strPrevPath;
   CMusicDatabase m_musicDatabase;
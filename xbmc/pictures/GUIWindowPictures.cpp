@@ -13,7 +13,9 @@
 #include "GUIDialogPictureInfo.h"
 #include "GUIPassword.h"
 #include "GUIWindowSlideShow.h"
+#include "PictureDatabase.h"
 #include "PictureInfoLoader.h"
+#include "PictureScannerJob.h"
 #include "ServiceBroker.h"
 #include "URL.h"
 #include "Util.h"
@@ -23,6 +25,7 @@
 #include "application/ApplicationPlayer.h"
 #include "dialogs/GUIDialogMediaSource.h"
 #include "dialogs/GUIDialogProgress.h"
+#include "dialogs/GUIDialogSelect.h"
 #include "guilib/GUIComponent.h"
 #include "guilib/GUIWindowManager.h"
 #include "input/Key.h"
@@ -55,7 +58,8 @@ using namespace std::chrono_literals;
 #define CONTROL_SHUFFLE      9
 
 CGUIWindowPictures::CGUIWindowPictures(void)
-    : CGUIMediaWindow(WINDOW_PICTURES, "MyPics.xml")
+    : CGUIMediaWindow(WINDOW_PICTURES, "MyPics.xml"),
+      m_pictureScanner(true, 1, CJob::PRIORITY_LOW_PAUSABLE)
 {
   m_thumbLoader.SetObserver(this);
   m_slideShowStarted = false;
@@ -235,6 +239,10 @@ void CGUIWindowPictures::OnPrepareFileItems(CFileItemList& items)
 
   if (bProgressVisible && m_dlgProgress)
     m_dlgProgress->Close();
+
+  // Index the pictures of this folder in the background, with the tags loaded so far
+  if (!loader.IsLoading() && loader.IndexChanged())
+    m_pictureScanner.AddJob(new CPictureScannerJob(items));
 }
 
 bool CGUIWindowPictures::Update(const std::string &strDirectory, bool updateFilterPath /* = true */)
@@ -435,6 +443,54 @@ void CGUIWindowPictures::OnSlideShow(const std::string &strPicture)
   }
 }
 
+void CGUIWindowPictures::OnSlideShowByCamera(const std::string& strPath)
+{
+  CGUIWindowSlideShow *pSlideShow = CServiceBroker::GetGUI()->GetWindowManager().GetWindow<CGUIWindowSlideShow>(WINDOW_SLIDESHOW);
+  CGUIDialogSelect *pDlgSelect = CServiceBroker::GetGUI()->GetWindowManager().GetWindow<CGUIDialogSelect>(WINDOW_DIALOG_SELECT);
+  if (!pSlideShow || !pDlgSelect)
+    return;
+
+  // only the pictures below the folder that are indexed already, taken from the picture database
+  CPictureDatabase db;
+  std::vector<std::string> models;
+  if (!db.Open() || !db.GetCameraModels(strPath, models) || models.empty())
+    return;
+
+  CFileItemList items;
+  for (const auto& model : models)
+    items.Add(std::make_shared<CFileItem>(model));
+
+  pDlgSelect->Reset();
+  pDlgSelect->SetHeading(CVariant{13323});
+  pDlgSelect->SetItems(items);
+  pDlgSelect->Open();
+  const int selected = pDlgSelect->GetSelectedItem();
+  if (!pDlgSelect->IsConfirmed() || selected < 0 || selected >= static_cast<int>(models.size()))
+    return;
+
+  CDatabase::Filter filter(db.PrepareSQL("cameraModel = '%s'", models[selected].c_str()));
+  filter.order = "dateTaken";
+  std::vector<std::string> files;
+  if (!db.GetPictures(strPath, filter, files) || files.empty())
+    return;
+
+  const auto& components = CServiceBroker::GetAppComponents();
+  const auto appPlayer = components.GetComponent<CApplicationPlayer>();
+  if (appPlayer->IsPlayingVideo())
+    g_application.StopPlaying();
+
+  pSlideShow->Reset();
+  for (const auto& file : files)
+  {
+    const CFileItem item(file, false);
+    pSlideShow->Add(&item);
+  }
+  pSlideShow->StartSlideShow();
+
+  m_slideShowStarted = true;
+  CServiceBroker::GetGUI()->GetWindowManager().ActivateWindow(WINDOW_SLIDESHOW);
+}
+
 void CGUIWindowPictures::OnRegenerateThumbs()
 {
   if (m_thumbLoader.IsLoading()) return;
@@ -466,6 +522,10 @@ void CGUIWindowPictures::GetContextButtons(int itemNumber, CContextButtons &butt
         }
         if (item->m_bIsFolder)
           buttons.Add(CONTEXT_BUTTON_RECURSIVE_SLIDESHOW, 13318);     // Recursive Slideshow
+        if (item->m_bIsFolder && !item->IsParentFolder() &&
+            CPictureScannerJob::CanScan(item->GetPath()) &&
+            CServiceBroker::GetSettingsComponent()->GetSettings()->GetBool(CSettings::SETTING_PICTURES_USETAGS))
+          buttons.Add(CONTEXT_BUTTON_CAMERA_SLIDESHOW, 13323);        // Slideshow by camera
 
         if (!m_thumbLoader.IsLoading())
           buttons.Add(CONTEXT_BUTTON_REFRESH_THUMBS, 13315);         // Create Thumbnails
@@ -503,6 +563,10 @@ bool CGUIWindowPictures::OnContextButton(int itemNumber, CONTEXT_BUTTON button)
     if (item)
       OnSlideShowRecursive(item->GetPath());
     return true;
+  case CONTEXT_BUTTON_CAMERA_SLIDESHOW:
+    if (item)
+      OnSlideShowByCamera(item->GetPath());
+    return true;
   case CONTEXT_BUTTON_INFO:
     OnItemInfo(itemNumber);
     return true;
@@ -11,6 +11,8 @@
 #include "PictureThumbLoader.h"
 #include "windows/GUIMediaWindow.h"
 
+#include <string>
+
 class CGUIDialogProgress;
 
 class CGUIWindowPictures : public CGUIMediaWindow, public IBackgroundLoaderObserver
@@ -41,6 +43,7 @@ protected:
   void OnSlideShow();
   void OnSlideShowRecursive(const std::string& strPicture);
   void OnSlideShowRecursive();
+  void OnSlideShowByCamera(const std::string& strPath);
   void OnItemLoaded(CFileItem* pItem) override;
   void LoadPlayList(const std::string& strPlayList) override;
 
@@ -48,4 +51,6 @@ protected:
 
   CPictureThumbLoader m_thumbLoader;
   bool m_slideShowStarted;
+
+  CJobQueue m_pictureScanner;
 };
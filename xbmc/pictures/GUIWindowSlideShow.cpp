@@ -28,8 +28,11 @@
 #include "input/Key.h"
 #include "interfaces/AnnouncementManager.h"
 #include "pictures/GUIViewStatePictures.h"
+#include "pictures/PictureDatabase.h"
+#include "pictures/PictureInfoTag.h"
 #include "pictures/PictureThumbLoader.h"
 #include "playlists/PlayListTypes.h"
+#include "settings/AdvancedSettings.h"
 #include "settings/DisplaySettings.h"
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
@@ -39,6 +42,8 @@
 #include "utils/XTimeUtils.h"
 #include "utils/log.h"
 
+#include <algorithm>
+#include <map>
 #include <random>
 
 using namespace XFILE;
@@ -71,6 +76,7 @@ CBackgroundPicLoader::CBackgroundPicLoader()
   , m_maxHeight{0}
   , m_isLoading{false}
   , m_pCallback{nullptr}
+  , m_pCache{nullptr}
 {
 }
 
@@ -79,9 +85,10 @@ CBackgroundPicLoader::~CBackgroundPicLoader()
   StopThread();
 }
 
-void CBackgroundPicLoader::Create(CGUIWindowSlideShow *pCallback)
+void CBackgroundPicLoader::Create(CGUIWindowSlideShow *pCallback, CSlideShowPicCache *pCache)
 {
   m_pCallback = pCallback;
+  m_pCache = pCache;
   m_isLoading = false;
   CThread::Create(false);
 }
@@ -98,7 +105,8 @@ void CBackgroundPicLoader::Process()
       {
         auto start = std::chrono::steady_clock::now();
         std::unique_ptr<CTexture> texture =
-            CTexture::LoadFromFile(m_strFileName, m_maxWidth, m_maxHeight);
+            m_pCache ? m_pCache->Acquire(m_iSlideNumber, m_strFileName, m_maxWidth, m_maxHeight)
+                     : CTexture::LoadFromFile(m_strFileName, m_maxWidth, m_maxHeight);
 
         auto end = std::chrono::steady_clock::now();
         auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
@@ -122,7 +130,7 @@ void CBackgroundPicLoader::Process()
           }
         }
         m_pCallback->OnLoadPic(m_iPic, m_iSlideNumber, m_strFileName, std::move(texture),
-                               bFullSize);
+                               m_maxWidth, m_maxHeight, bFullSize);
         m_isLoading = false;
       }
     }
@@ -224,12 +232,15 @@ void CGUIWindowSlideShow::Reset()
   m_fInitialRotate = 0.0f;
   m_iZoomFactor = 1;
   m_fZoom = 1.0f;
+  m_bReloadImage = false;
   m_fInitialZoom = 0.0f;
   m_iCurrentSlide = 0;
   m_iNextSlide = 1;
   m_iCurrentPic = 0;
   m_iDirection = 1;
   m_iLastFailedNextSlide = -1;
+  m_prefetchCache.Clear();
+  m_iPrefetchSlide = -1;
   m_slides.clear();
   AnnouncePlaylistClear();
   m_Resolution = g_graphicsContext.GetVideoResolution();
@@ -261,6 +272,8 @@ void CGUIWindowSlideShow::OnDeinitWindow(int nextWindowID)
     // and close the images.
     m_Image[0].Close();
     m_Image[1].Close();
+    m_prefetchCache.Clear();
+    m_iPrefetchSlide = -1;
   }
   CServiceBroker::GetGUI()->GetInfoManager().GetInfoProviders().GetPicturesInfoProvider().SetCurrentSlide(nullptr);
   m_bSlideShow = false;
@@ -294,6 +307,7 @@ void CGUIWindowSlideShow::ShowNext()
   m_iNextSlide   = GetNextSlide();
   m_iZoomFactor  = 1;
   m_fZoom        = 1.0f;
+  m_bReloadImage = false;
   m_fRotate      = 0.0f;
   m_bLoadNextPic = true;
 }
@@ -307,6 +321,7 @@ void CGUIWindowSlideShow::ShowPrevious()
   m_iNextSlide   = GetNextSlide();
   m_iZoomFactor  = 1;
   m_fZoom        = 1.0f;
+  m_bReloadImage = false;
   m_fRotate      = 0.0f;
   m_bLoadNextPic = true;
 }
@@ -398,7 +413,7 @@ void CGUIWindowSlideShow::Process(unsigned int currentTime, CDirtyRegionList &re
   if (!m_pBackgroundLoader)
   {
     m_pBackgroundLoader.reset(new CBackgroundPicLoader());
-    m_pBackgroundLoader->Create(this);
+    m_pBackgroundLoader->Create(this, &m_prefetchCache);
   }
 
   bool bSlideShow = m_bSlideShow && !m_bPause && !m_bPlayingVideo;
@@ -474,6 +489,10 @@ void CGUIWindowSlideShow::Process(unsigned int currentTime, CDirtyRegionList &re
     return;
   }
 
+  int prefetchWidth, prefetchHeight;
+  GetCheckedSize((float)res.iWidth, (float)res.iHeight, prefetchWidth, prefetchHeight);
+  UpdatePrefetch(prefetchWidth, prefetchHeight);
+
   if (!m_Image[m_iCurrentPic].IsLoaded() && !m_pBackgroundLoader->IsLoading())
   { // load first image
     CFileItemPtr item = m_slides.at(m_iCurrentSlide);
@@ -498,9 +517,25 @@ void CGUIWindowSlideShow::Process(unsigned int currentTime, CDirtyRegionList &re
     }
   }
 
+  if (m_bReloadImage && m_Image[m_iCurrentPic].IsLoaded() && !m_pBackgroundLoader->IsLoading())
+  { // load the current image again, at the size it is zoomed to
+    std::string picturePath = GetPicturePath(m_slides.at(m_iCurrentSlide).get());
+    if (!picturePath.empty())
+    {
+      CLog::Log(LOGDEBUG, "Reloading the current image {} at zoom {}", m_iCurrentSlide, m_fZoom);
+      int maxWidth, maxHeight;
+      GetCheckedSize((float)res.iWidth * m_fZoom,
+                     (float)res.iHeight * m_fZoom,
+                     maxWidth, maxHeight);
+      m_pBackgroundLoader->LoadPic(m_iCurrentPic, m_iCurrentSlide, picturePath, maxWidth, maxHeight);
+    }
+    else
+      m_bReloadImage = false;
+  }
+
   // check if we should discard an already loaded next slide
   if (m_Image[1 - m_iCurrentPic].IsLoaded() && m_Image[1 - m_iCurrentPic].SlideNumber() != m_iNextSlide)
-    m_Image[1 - m_iCurrentPic].Close();
+    ReleasePic(1 - m_iCurrentPic);
 
   if (m_iNextSlide != m_iCurrentSlide && m_Image[m_iCurrentPic].IsLoaded() && !m_Image[1 - m_iCurrentPic].IsLoaded() && !m_pBackgroundLoader->IsLoading() && m_iLastFailedNextSlide != m_iNextSlide)
   { // load the next image
@@ -625,6 +660,7 @@ void CGUIWindowSlideShow::Process(unsigned int currentTime, CDirtyRegionList &re
 
     m_iZoomFactor = 1;
     m_fZoom = 1.0f;
+    m_bReloadImage = false;
     m_fRotate = 0.0f;
   }
 
@@ -716,6 +752,64 @@ int CGUIWindowSlideShow::GetNextSlide()
   return m_iCurrentSlide;
 }
 
+void CGUIWindowSlideShow::UpdatePrefetch(int maxWidth, int maxHeight)
+{
+  if (m_iPrefetchSlide == m_iCurrentSlide && m_iPrefetchDirection == m_iDirection &&
+      m_iPrefetchSlides == static_cast<int>(m_slides.size()) && m_iPrefetchWidth == maxWidth &&
+      m_iPrefetchHeight == maxHeight)
+    return;
+
+  m_iPrefetchSlide = m_iCurrentSlide;
+  m_iPrefetchDirection = m_iDirection;
+  m_iPrefetchSlides = static_cast<int>(m_slides.size());
+  m_iPrefetchWidth = maxWidth;
+  m_iPrefetchHeight = maxHeight;
+
+  const std::shared_ptr<CAdvancedSettings> advancedSettings =
+      CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
+  const int ahead = advancedSettings->m_slideshowPrefetchCount;
+  const size_t memoryBudget =
+      static_cast<size_t>(advancedSettings->m_slideshowPrefetchMemory) * 1024 * 1024;
+
+  // follow the direction we are moving in, keep a few slides behind for stepping back
+  std::vector<std::pair<int, std::string>> slides;
+  const int numSlides = static_cast<int>(m_slides.size());
+  const int step = m_iDirection >= 0 ? 1 : -1;
+  auto addSlides = [&](int direction, int count) {
+    int slide = m_iCurrentSlide;
+    for (int i = 0; i < numSlides - 1 && count > 0; i++)
+    {
+      slide = (slide + direction + numSlides) % numSlides;
+      const CFileItemPtr& item = m_slides.at(slide);
+      if (item->IsVideo() || item->HasProperty("unplayable"))
+        continue;
+      std::string picturePath = GetPicturePath(item.get());
+      if (picturePath.empty())
+        continue;
+      std::pair<int, std::string> wanted(slide, std::move(picturePath));
+      if (std::find(slides.begin(), slides.end(), wanted) == slides.end())
+        slides.emplace_back(std::move(wanted));
+      count--;
+    }
+  };
+  addSlides(step, ahead);
+  addSlides(-step, (ahead + 1) / 2);
+
+  m_prefetchCache.Prefetch(slides, maxWidth, maxHeight, memoryBudget);
+}
+
+void CGUIWindowSlideShow::ReleasePic(int iPic)
+{
+  const int slide = m_Image[iPic].SlideNumber();
+  std::unique_ptr<CTexture> texture = m_Image[iPic].ReleaseTexture();
+  if (slide < 0 || slide >= static_cast<int>(m_slides.size()))
+    return;
+  // hand it back at the size it was decoded at, a picture reloaded for zooming is bigger than
+  // the prefetched ones and must not be taken for one of them
+  m_prefetchCache.Release(slide, GetPicturePath(m_slides.at(slide).get()), m_iImageWidth[iPic],
+                          m_iImageHeight[iPic], std::move(texture));
+}
+
 EVENT_RESULT CGUIWindowSlideShow::OnMouseEvent(const CPoint &point, const CMouseEvent &event)
 {
   if (event.m_id == ACTION_GESTURE_NOTIFY)
@@ -1060,6 +1154,7 @@ bool CGUIWindowSlideShow::OnMessage(CGUIMessage& message)
             AnnouncePlayerPlay(m_slides.at(m_iCurrentSlide));
             m_iZoomFactor = 1;
             m_fZoom = 1.0f;
+            m_bReloadImage = false;
             m_fRotate = 0.0f;
           }
         }
@@ -1110,6 +1205,8 @@ void CGUIWindowSlideShow::ZoomRelative(float fZoom, bool immediate /* = false */
     return;
 
   m_fZoom = fZoom;
+  if (m_fZoom > 1.0f && !m_Image[m_iCurrentPic].FullSize())
+    m_bReloadImage = true;
 
   // find the nearest zoom factor
   for (unsigned int i = 1; i < MAX_ZOOM_FACTOR; i++)
@@ -1170,6 +1267,8 @@ void CGUIWindowSlideShow::OnLoadPic(int iPic,
                                     int iSlideNumber,
                                     const std::string& strFileName,
                                     std::unique_ptr<CTexture> pTexture,
+                                    int maxWidth,
+                                    int maxHeight,
                                     bool bFullSize)
 {
   if (pTexture)
@@ -1179,10 +1278,25 @@ void CGUIWindowSlideShow::OnLoadPic(int iPic,
     { // throw this away - we must have cleared the slideshow while we were still loading
       return;
     }
+    if (m_bReloadImage && iPic == m_iCurrentPic && m_Image[iPic].IsLoaded() &&
+        m_Image[iPic].SlideNumber() == iSlideNumber)
+    { // a zoomed in picture, keep showing it as it is
+      CLog::Log(LOGDEBUG, "Finished reloading slot {}, {}: {}", iPic, iSlideNumber,
+                m_slides.at(iSlideNumber)->GetPath());
+      m_Image[iPic].SetOriginalSize(pTexture->GetOriginalWidth(), pTexture->GetOriginalHeight(), bFullSize);
+      m_Image[iPic].UpdateTexture(std::move(pTexture));
+      m_iImageWidth[iPic] = maxWidth;
+      m_iImageHeight[iPic] = maxHeight;
+      m_bReloadImage = false;
+      MarkDirtyRegion();
+      return;
+    }
     CLog::Log(LOGDEBUG, "Finished background loading slot {}, {}: {}", iPic, iSlideNumber,
               m_slides.at(iSlideNumber)->GetPath());
     m_Image[iPic].SetOriginalSize(pTexture->GetOriginalWidth(), pTexture->GetOriginalHeight(), bFullSize);
     m_Image[iPic].SetTexture(iSlideNumber, std::move(pTexture), GetDisplayEffect(iSlideNumber));
+    m_iImageWidth[iPic] = maxWidth;
+    m_iImageHeight[iPic] = maxHeight;
 
     m_Image[iPic].m_bIsComic = false;
     if (URIUtils::IsInRAR(m_slides.at(m_iCurrentSlide)->GetPath()) || URIUtils::IsInZIP(m_slides.at(m_iCurrentSlide)->GetPath())) // move to top for cbr/cbz
@@ -1221,6 +1335,7 @@ void CGUIWindowSlideShow::Shuffle()
   KODI::UTILS::RandomShuffle(m_slides.begin(), m_slides.end());
   m_iCurrentSlide = 0;
   m_iNextSlide = GetNextSlide();
+  m_iPrefetchSlide = -1;
   m_bShuffled = true;
 
   AnnouncePropertyChanged("shuffled", true);
@@ -1318,6 +1433,24 @@ void CGUIWindowSlideShow::AddItems(const std::string &strPath, path_set *recursi
   if (!CDirectory::GetDirectory(strPath, items, viewState.GetExtensions(), DIR_FLAG_NO_FILE_DIRS))
     return;
 
+  // sorting by date taken needs the picture tags, take the ones indexed in the picture database
+  if (method == SortByDateTaken)
+  {
+    CPictureDatabase db;
+    std::map<std::string, PictureDatabaseEntry> pictures;
+    if (db.Open() && db.GetPathPictures(strPath, pictures))
+    {
+      for (int i = 0; i < items.Size(); i++)
+      {
+        const CFileItemPtr& item = items[i];
+        const auto it = pictures.find(URIUtils::GetFileName(item->GetPath()));
+        if (!item->m_bIsFolder && it != pictures.end() &&
+            it->second.Matches(item->m_dateTime, item->m_dwSize))
+          CPictureDatabase::DecodeTag(it->second.tag, *item->GetPictureInfoTag());
+      }
+    }
+  }
+
   items.Sort(method, order, sortAttributes);
 
   // need to go into all subdirs
@@ -1337,8 +1470,10 @@ void CGUIWindowSlideShow::AddItems(const std::string &strPath, path_set *recursi
 
 void CGUIWindowSlideShow::GetCheckedSize(float width, float height, int &maxWidth, int &maxHeight)
 {
-  maxWidth = g_graphicsContext.GetMaxTextureSize();
-  maxHeight = g_graphicsContext.GetMaxTextureSize();
+  // pictures are decoded about as large as they are shown, and loaded again when zoomed in
+  const int maxTextureSize = static_cast<int>(g_graphicsContext.GetMaxTextureSize());
+  maxWidth = std::min(static_cast<int>(width), maxTextureSize);
+  maxHeight = std::min(static_cast<int>(height), maxTextureSize);
 }
 
 std::string CGUIWindowSlideShow::GetPicturePath(CFileItem *item)
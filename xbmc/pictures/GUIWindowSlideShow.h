@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "SlideShowPicCache.h"
 #include "SlideShowPicture.h"
 #include "guilib/GUIDialog.h"
 #include "threads/Event.h"
@@ -28,7 +29,7 @@ public:
   CBackgroundPicLoader();
   ~CBackgroundPicLoader() override;
 
-  void Create(CGUIWindowSlideShow *pCallback);
+  void Create(CGUIWindowSlideShow *pCallback, CSlideShowPicCache *pCache);
   void LoadPic(int iPic, int iSlideNumber, const std::string &strFileName, const int maxWidth, const int maxHeight);
   bool IsLoading() { return m_isLoading; }
   int SlideNumber() const { return m_iSlideNumber; }
@@ -46,6 +47,7 @@ private:
   bool m_isLoading;
 
   CGUIWindowSlideShow *m_pCallback;
+  CSlideShowPicCache *m_pCache;
 };
 
 class CGUIWindowSlideShow : public CGUIDialog
@@ -86,6 +88,8 @@ public:
                  int iSlideNumber,
                  const std::string& strFileName,
                  std::unique_ptr<CTexture> pTexture,
+                 int maxWidth,
+                 int maxHeight,
                  bool bFullSize);
   int NumSlides() const;
   int CurrentSlide() const;
@@ -117,6 +121,8 @@ private:
   void GetCheckedSize(float width, float height, int &maxWidth, int &maxHeight);
   std::string GetPicturePath(CFileItem *item);
   int  GetNextSlide();
+  void UpdatePrefetch(int maxWidth, int maxHeight);
+  void ReleasePic(int iPic);
 
   void AnnouncePlayerPlay(const CFileItemPtr& item);
   void AnnouncePlayerPause(const CFileItemPtr& item);
@@ -144,12 +150,21 @@ private:
   std::vector<CFileItemPtr> m_slides;
 
   CSlideShowPic m_Image[2];
+  int m_iImageWidth[2] = {}; ///< maximal width the texture of each image was decoded at
+  int m_iImageHeight[2] = {}; ///< maximal height the texture of each image was decoded at
 
   int m_iCurrentPic;
   // background loader
   std::unique_ptr<CBackgroundPicLoader> m_pBackgroundLoader;
+  CSlideShowPicCache m_prefetchCache;
+  int m_iPrefetchSlide = -1;
+  int m_iPrefetchDirection = 0;
+  int m_iPrefetchSlides = 0;
+  int m_iPrefetchWidth = 0;
+  int m_iPrefetchHeight = 0;
   int m_iLastFailedNextSlide;
   bool m_bLoadNextPic;
+  bool m_bReloadImage = false; ///< load the current picture again, at the size it's zoomed to
   RESOLUTION m_Resolution;
   CPoint m_firstGesturePoint;
 };
@@ -0,0 +1,288 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "PictureDatabase.h"
+
+#include "dbwrappers/dataset.h"
+#include "pictures/PictureInfoTag.h"
+#include "utils/Archive.h"
+#include "utils/Base64.h"
+#include "utils/URIUtils.h"
+#include "utils/log.h"
+
+#include <stdexcept>
+
+CPictureDatabase::CPictureDatabase() = default;
+
+CPictureDatabase::~CPictureDatabase() = default;
+
+bool CPictureDatabase::Open()
+{
+  return CDatabase::Open();
+}
+
+void CPictureDatabase::CreateTables()
+{
+  CLog::Log(LOGINFO, "create picture table");
+  m_pDS->exec("CREATE TABLE picture ("
+              "idPicture integer primary key,"
+              "path text,"
+              "filename text,"
+              "modified text,"
+              "size integer,"
+              "dateTaken text,"
+              "cameraMake text,"
+              "cameraModel text,"
+              "width integer,"
+              "height integer,"
+              "orientation integer,"
+              "iso integer,"
+              "focalLength real,"
+              "keywords text,"
+              "caption text,"
+              "city text,"
+              "country text,"
+              "tag text)");
+}
+
+void CPictureDatabase::CreateAnalytics()
+{
+  CLog::Log(LOGINFO, "{} - creating indices", __FUNCTION__);
+  m_pDS->exec("CREATE UNIQUE INDEX idxPicture ON picture(path, filename)");
+  m_pDS->exec("CREATE INDEX idxPictureDateTaken ON picture(dateTaken)");
+  m_pDS->exec("CREATE INDEX idxPictureCamera ON picture(cameraMake, cameraModel)");
+}
+
+bool CPictureDatabase::GetPictureInfo(const std::string& file,
+                                      const CDateTime& modified,
+                                      int64_t size,
+                                      CPictureInfoTag& tag)
+{
+  try
+  {
+    if (!m_pDB)
+      return false;
+    if (!m_pDS)
+      return false;
+
+    std::string sql = PrepareSQL("SELECT modified, size, tag FROM picture WHERE path='%s' AND filename='%s'",
+                                 URIUtils::GetDirectory(file).c_str(),
+                                 URIUtils::GetFileName(file).c_str());
+    m_pDS->query(sql);
+    if (!m_pDS->eof())
+    {
+      PictureDatabaseEntry entry;
+      entry.modified.SetFromDBDateTime(m_pDS->fv(0).get_asString());
+      entry.size = m_pDS->fv(1).get_asInt64();
+      entry.tag = m_pDS->fv(2).get_asString();
+      m_pDS->close();
+      return entry.Matches(modified, size) && DecodeTag(entry.tag, tag);
+    }
+    m_pDS->close();
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "{}, failed on file '{}'", __FUNCTION__, file);
+  }
+  return false;
+}
+
+bool CPictureDatabase::SetPictureInfo(const std::string& file,
+                                      const CDateTime& modified,
+                                      int64_t size,
+                                      const CPictureInfoTag& tag)
+{
+  try
+  {
+    if (!m_pDB)
+      return false;
+    if (!m_pDS)
+      return false;
+
+    // CArchive only stores mutable objects
+    CPictureInfoTag archivedTag(tag);
+    std::vector<uint8_t> buffer;
+    CArchive ar(buffer, CArchive::store);
+    ar << archivedTag;
+    ar.Close();
+
+    const CPictureInfoTag::ExifInfo& exif = tag.m_exifInfo;
+    const CPictureInfoTag::IPTCInfo& iptc = tag.m_iptcInfo;
+    const CDateTime& dateTaken = tag.GetDateTimeTaken();
+
+    std::string sql = PrepareSQL(
+        "INSERT OR REPLACE INTO picture (idPicture, path, filename, modified, size, dateTaken, "
+        "cameraMake, cameraModel, width, height, orientation, iso, focalLength, keywords, "
+        "caption, city, country, tag) "
+        "VALUES (NULL, '%s', '%s', '%s', %I64d, '%s', '%s', '%s', %i, %i, %i, %i, %f, '%s', "
+        "'%s', '%s', '%s', '%s')",
+        URIUtils::GetDirectory(file).c_str(), URIUtils::GetFileName(file).c_str(),
+        modified.IsValid() ? modified.GetAsDBDateTime().c_str() : "", size,
+        dateTaken.IsValid() ? dateTaken.GetAsDBDateTime().c_str() : "",
+        exif.CameraMake.c_str(), exif.CameraModel.c_str(), exif.Width, exif.Height,
+        exif.Orientation, exif.ISOequivalent, static_cast<double>(exif.FocalLength),
+        iptc.Keywords.c_str(), iptc.Caption.c_str(), iptc.City.c_str(), iptc.Country.c_str(),
+        Base64::Encode(reinterpret_cast<const char*>(buffer.data()), buffer.size()).c_str());
+    m_pDS->exec(sql);
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "{}, failed on file '{}'", __FUNCTION__, file);
+  }
+  return false;
+}
+
+bool CPictureDatabase::RemovePicture(const std::string& file)
+{
+  std::string sql = PrepareSQL("DELETE FROM picture WHERE path='%s' AND filename='%s'",
+                               URIUtils::GetDirectory(file).c_str(),
+                               URIUtils::GetFileName(file).c_str());
+  return ExecuteQuery(sql);
+}
+
+bool CPictureDatabase::GetPathPictures(const std::string& path,
+                                       std::map<std::string, PictureDatabaseEntry>& pictures)
+{
+  try
+  {
+    if (!m_pDB)
+      return false;
+    if (!m_pDS)
+      return false;
+
+    std::string folder(path);
+    URIUtils::AddSlashAtEnd(folder);
+
+    std::string sql = PrepareSQL("SELECT filename, modified, size, tag FROM picture WHERE path='%s'",
+                                 folder.c_str());
+    if (!m_pDS->query(sql))
+      return false;
+
+    while (!m_pDS->eof())
+    {
+      PictureDatabaseEntry& entry = pictures[m_pDS->fv(0).get_asString()];
+      entry.modified.SetFromDBDateTime(m_pDS->fv(1).get_asString());
+      entry.size = m_pDS->fv(2).get_asInt64();
+      entry.tag = m_pDS->fv(3).get_asString();
+      m_pDS->next();
+    }
+    m_pDS->close();
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "{}, failed on path '{}'", __FUNCTION__, path);
+  }
+  return false;
+}
+
+bool CPictureDatabase::GetPictures(const std::string& basePath,
+                                   const Filter& filter,
+                                   std::vector<std::string>& files)
+{
+  try
+  {
+    if (!m_pDB)
+      return false;
+    if (!m_pDS)
+      return false;
+
+    Filter extFilter = filter;
+    extFilter.fields = "path, filename";
+    if (!basePath.empty())
+      extFilter.AppendWhere(PrepareBelowPath(basePath));
+
+    std::string sqlFilter;
+    if (!CDatabase::BuildSQL("", extFilter, sqlFilter))
+      return false;
+
+    std::string sql = PrepareSQL("SELECT %s FROM picture", extFilter.fields.c_str()) + sqlFilter;
+    if (!m_pDS->query(sql))
+      return false;
+
+    while (!m_pDS->eof())
+    {
+      files.emplace_back(m_pDS->fv(0).get_asString() + m_pDS->fv(1).get_asString());
+      m_pDS->next();
+    }
+    m_pDS->close();
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "{}, failed on path '{}'", __FUNCTION__, basePath);
+  }
+  return false;
+}
+
+bool CPictureDatabase::GetCameraModels(const std::string& basePath, std::vector<std::string>& models)
+{
+  try
+  {
+    if (!m_pDB)
+      return false;
+    if (!m_pDS)
+      return false;
+
+    std::string sql = "SELECT DISTINCT cameraModel FROM picture WHERE cameraModel != ''";
+    if (!basePath.empty())
+      sql += " AND " + PrepareBelowPath(basePath);
+    sql += " ORDER BY cameraModel";
+    if (!m_pDS->query(sql))
+      return false;
+
+    while (!m_pDS->eof())
+    {
+      models.emplace_back(m_pDS->fv(0).get_asString());
+      m_pDS->next();
+    }
+    m_pDS->close();
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "{}, failed on path '{}'", __FUNCTION__, basePath);
+  }
+  return false;
+}
+
+std::string CPictureDatabase::PrepareBelowPath(const std::string& basePath) const
+{
+  // every path below the folder starts with it, and sorts before the folder with its
+  // separator incremented
+  std::string folder(basePath);
+  URIUtils::AddSlashAtEnd(folder);
+  std::string end(folder);
+  end.back()++;
+  return PrepareSQL("path >= '%s' AND path < '%s'", folder.c_str(), end.c_str());
+}
+
+bool CPictureDatabase::DecodeTag(const std::string& data, CPictureInfoTag& tag)
+{
+  if (data.empty())
+    return false;
+
+  // rows may be corrupt or written by another version, only take a tag that decodes exactly
+  const std::string buffer = Base64::Decode(data);
+  CPictureInfoTag decoded;
+  try
+  {
+    CArchive ar(reinterpret_cast<const uint8_t*>(buffer.data()), buffer.size());
+    ar >> decoded;
+    if (!ar.IsLoadComplete())
+      return false;
+  }
+  catch (const std::out_of_range&)
+  {
+    return false;
+  }
+
+  tag = decoded;
+  return true;
+}
@@ -0,0 +1,108 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "XBDateTime.h"
+#include "dbwrappers/Database.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+class CPictureInfoTag;
+
+/*! \brief Stored metadata of a picture, as returned by CPictureDatabase::GetPathPictures() */
+struct PictureDatabaseEntry
+{
+  CDateTime modified;
+  int64_t size = 0;
+  std::string tag; ///< serialized CPictureInfoTag, decode with CPictureDatabase::DecodeTag()
+
+  /*! \brief Whether the entry still describes a file with the given modification time and size */
+  bool Matches(const CDateTime& fileModified, int64_t fileSize) const
+  {
+    return size == fileSize && modified == fileModified;
+  }
+};
+
+/*! \brief Index of the EXIF/IPTC metadata of pictures.
+
+ Pictures are keyed by path, modification time and size, so that metadata parsed once is reused
+ until the file changes. The most useful EXIF/IPTC fields are stored in their own indexed columns
+ to allow sorting and filtering pictures without reading the files.
+ */
+class CPictureDatabase : public CDatabase
+{
+public:
+  CPictureDatabase();
+  ~CPictureDatabase() override;
+  bool Open() override;
+
+  /*! \brief Get the metadata of a picture
+   \param file path of the picture.
+   \param modified modification time of the picture.
+   \param size size of the picture.
+   \param tag [out] the metadata of the picture.
+   \return true if the picture is in the database and unchanged, false otherwise.
+   */
+  bool GetPictureInfo(const std::string& file,
+                      const CDateTime& modified,
+                      int64_t size,
+                      CPictureInfoTag& tag);
+
+  /*! \brief Store the metadata of a picture, replacing any previous entry
+   \param file path of the picture.
+   \param modified modification time of the picture.
+   \param size size of the picture.
+   \param tag the metadata of the picture.
+   \return true on success, false otherwise.
+   */
+  bool SetPictureInfo(const std::string& file,
+                      const CDateTime& modified,
+                      int64_t size,
+                      const CPictureInfoTag& tag);
+
+  bool RemovePicture(const std::string& file);
+
+  /*! \brief Get all pictures stored for a folder
+   \param path the folder.
+   \param pictures [out] the stored pictures, keyed by file name.
+   \return true on success, false otherwise.
+   */
+  bool GetPathPictures(const std::string& path, std::map<std::string, PictureDatabaseEntry>& pictures);
+
+  /*! \brief Get the pictures below a folder, filtered and sorted on the indexed columns
+   Available columns are path, filename, dateTaken, cameraMake, cameraModel, width, height,
+   orientation, iso, focalLength, keywords, caption, city and country.
+   \param basePath the folder to look in, including its subfolders.
+   \param filter where, order and limit clauses to apply.
+   \param files [out] paths of the matching pictures.
+   \return true on success, false otherwise.
+   */
+  bool GetPictures(const std::string& basePath, const Filter& filter, std::vector<std::string>& files);
+
+  /*! \brief Get the distinct camera models of the pictures below a folder */
+  bool GetCameraModels(const std::string& basePath, std::vector<std::string>& models);
+
+  /*! \brief Decode a tag stored in the database
+   \param data the stored tag, see PictureDatabaseEntry::tag
+   \param tag the decoded tag, left untouched on failure
+   \return true if data is a valid tag, false otherwise.
+   */
+  static bool DecodeTag(const std::string& data, CPictureInfoTag& tag);
+
+protected:
+  /*! \brief Condition on the paths below a folder, as a range that can use the path index */
+  std::string PrepareBelowPath(const std::string& basePath) const;
+
+  void CreateTables() override;
+  void CreateAnalytics() override;
+  int GetSchemaVersion() const override { return 1; }
+  const char* GetBaseDBName() const override { return "MyPictures"; }
+};
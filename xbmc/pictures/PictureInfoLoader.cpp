@@ -11,31 +11,35 @@
 #include "FileItem.h"
 #include "PictureInfoTag.h"
 #include "ServiceBroker.h"
+#include "pictures/PictureScannerJob.h"
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
+#include "utils/URIUtils.h"
 
 CPictureInfoLoader::CPictureInfoLoader()
 {
-  m_mapFileItems = new CFileItemList;
   m_tagReads = 0;
 }
 
 CPictureInfoLoader::~CPictureInfoLoader()
 {
   StopThread();
-  delete m_mapFileItems;
 }
 
 void CPictureInfoLoader::OnLoaderStart()
 {
-  // Load previously cached items from HD
-  m_mapFileItems->SetPath(m_pVecItems->GetPath());
-  m_mapFileItems->Load();
-  m_mapFileItems->SetFastLookup(true);
+  // Open previously cached items from HD, items are only read when looked up
+  m_cachedItems.Open(m_pVecItems->GetDiscFileCache());
 
   m_tagReads = 0;
   m_loadTags = CServiceBroker::GetSettingsComponent()->GetSettings()->GetBool(CSettings::SETTING_PICTURES_USETAGS);
 
+  // Fetch the tags indexed for this folder in a single query
+  m_indexedPictures.clear();
+  m_indexChanged = false;
+  if (m_loadTags && CPictureScannerJob::CanScan(m_pVecItems->GetPath()) && m_database.Open())
+    m_database.GetPathPictures(m_pVecItems->GetPath(), m_indexedPictures);
+
   if (m_pProgressCallback)
     m_pProgressCallback->SetProgressMax(m_pVecItems->GetFileCount());
 }
@@ -57,7 +61,7 @@ bool CPictureInfoLoader::LoadItemCached(CFileItem* pItem)
     return true;
 
   // Check the cached item
-  CFileItemPtr mapItem = (*m_mapFileItems)[pItem->GetPath()];
+  CFileItemPtr mapItem = m_cachedItems.Get(pItem->GetPath());
   if (mapItem && mapItem->m_dateTime==pItem->m_dateTime && mapItem->HasPictureInfoTag())
   { // Query map if we previously cached the file on HD
     *pItem->GetPictureInfoTag() = *mapItem->GetPictureInfoTag();
@@ -65,6 +69,18 @@ bool CPictureInfoLoader::LoadItemCached(CFileItem* pItem)
     return true;
   }
 
+  // Check the picture database
+  const auto it = m_indexedPictures.find(URIUtils::GetFileName(pItem->GetPath()));
+  if (it != m_indexedPictures.end() && it->second.Matches(pItem->m_dateTime, pItem->m_dwSize))
+  {
+    CPictureInfoTag tag;
+    if (CPictureDatabase::DecodeTag(it->second.tag, tag))
+    {
+      *pItem->GetPictureInfoTag() = tag;
+      m_tagReads++;
+    }
+  }
+
   return true;
 }
 
@@ -91,7 +107,28 @@ bool CPictureInfoLoader::LoadItemLookup(CFileItem* pItem)
 void CPictureInfoLoader::OnLoaderFinish()
 {
   // cleanup cache loaded from HD
-  m_mapFileItems->Clear();
+  m_cachedItems.Close();
+
+  // The folder needs indexing again if a picture isn't indexed as it is, or an indexed one is gone
+  if (m_database.IsOpen())
+  {
+    for (const auto& item : m_vecItems)
+    {
+      if (!CPictureScannerJob::CanIndex(*item))
+        continue;
+      const auto it = m_indexedPictures.find(URIUtils::GetFileName(item->GetPath()));
+      if (it == m_indexedPictures.end() || !it->second.Matches(item->m_dateTime, item->m_dwSize))
+      {
+        m_indexChanged = true;
+        break;
+      }
+      m_indexedPictures.erase(it);
+    }
+    if (!m_indexedPictures.empty())
+      m_indexChanged = true;
+    m_database.Close();
+  }
+  m_indexedPictures.clear();
 
   // Save loaded items to HD
   if (!m_bStop && m_tagReads > 0)
@@ -9,7 +9,10 @@
 #pragma once
 
 #include "BackgroundInfoLoader.h"
+#include "FileItemListDiscCache.h"
+#include "PictureDatabase.h"
 
+#include <map>
 #include <string>
 
 class CPictureInfoLoader : public CBackgroundInfoLoader
@@ -23,12 +26,18 @@ public:
   bool LoadItemCached(CFileItem* pItem) override;
   bool LoadItemLookup(CFileItem* pItem) override;
 
+  /*! \brief Whether the pictures of the folder differ from those in the picture database */
+  bool IndexChanged() const { return m_indexChanged; }
+
 protected:
   void OnLoaderStart() override;
   void OnLoaderFinish() override;
 
-  CFileItemList* m_mapFileItems;
+  CFileItemListDiscCache m_cachedItems;
+  CPictureDatabase m_database;
+  std::map<std::string, PictureDatabaseEntry> m_indexedPictures;
   unsigned int m_tagReads;
   bool m_loadTags;
+  bool m_indexChanged = false;
 };
 
@@ -31,6 +31,7 @@ class CVariant;
 
 class CPictureInfoTag : public IArchivable, public ISerializable, public ISortable
 {
+  friend class CPictureDatabase;
 #if 0
   friend class KODI::ADDONS::CImageDecoder;
 #endif
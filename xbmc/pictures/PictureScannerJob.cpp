@@ -0,0 +1,111 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "PictureScannerJob.h"
+
+#include "FileItem.h"
+#include "URL.h"
+#include "pictures/PictureDatabase.h"
+#include "pictures/PictureInfoTag.h"
+#include "utils/URIUtils.h"
+#include "utils/log.h"
+
+#include <chrono>
+#include <cstring>
+#include <map>
+
+CPictureScannerJob::CPictureScannerJob(const CFileItemList& items) : m_path(items.GetPath())
+{
+  URIUtils::AddSlashAtEnd(m_path);
+  for (const auto& item : items)
+  {
+    if (CanIndex(*item))
+      m_pictures.push_back(std::make_shared<CFileItem>(*item));
+  }
+}
+
+bool CPictureScannerJob::operator==(const CJob* job) const
+{
+  if (strcmp(job->GetType(), GetType()) == 0)
+  {
+    const CPictureScannerJob* scanJob = dynamic_cast<const CPictureScannerJob*>(job);
+    if (scanJob && scanJob->m_path == m_path)
+      return true;
+  }
+  return false;
+}
+
+bool CPictureScannerJob::CanScan(const std::string& path)
+{
+  return !path.empty() && !URIUtils::IsSourcesPath(path) && !URIUtils::IsPlugin(path) &&
+         !URIUtils::IsInternetStream(path) && !URIUtils::IsInArchive(path) &&
+         !URIUtils::IsLibraryFolder(path) && !URIUtils::IsSpecial(path);
+}
+
+bool CPictureScannerJob::CanIndex(const CFileItem& item)
+{
+  return !item.m_bIsFolder && item.IsPicture() && !item.IsZIP() && !item.IsRAR() &&
+         !item.IsCBZ() && !item.IsCBR() && !item.IsVideo();
+}
+
+bool CPictureScannerJob::DoWork()
+{
+  CPictureDatabase db;
+  if (!db.Open())
+    return false;
+
+  auto start = std::chrono::steady_clock::now();
+
+  std::map<std::string, PictureDatabaseEntry> indexed;
+  db.GetPathPictures(m_path, indexed);
+
+  unsigned int stored = 0;
+  unsigned int reads = 0;
+  db.BeginTransaction();
+  for (size_t i = 0; i < m_pictures.size(); i++)
+  {
+    if (ShouldCancel(i, m_pictures.size()))
+    {
+      db.CommitTransaction();
+      db.Close();
+      return false;
+    }
+
+    const CFileItemPtr& item = m_pictures[i];
+    auto entry = indexed.find(URIUtils::GetFileName(item->GetPath()));
+    if (entry != indexed.end())
+    {
+      bool unchanged = entry->second.Matches(item->m_dateTime, item->m_dwSize);
+      indexed.erase(entry);
+      if (unchanged)
+        continue;
+    }
+
+    if (!item->HasPictureInfoTag() || !item->GetPictureInfoTag()->Loaded())
+    {
+      item->GetPictureInfoTag()->Load(item->GetPath());
+      reads++;
+    }
+    db.SetPictureInfo(item->GetPath(), item->m_dateTime, item->m_dwSize,
+                      *item->GetPictureInfoTag());
+    stored++;
+  }
+
+  // whatever is left was removed from the folder
+  for (const auto& it : indexed)
+    db.RemovePicture(m_path + it.first);
+  db.CommitTransaction();
+
+  auto end = std::chrono::steady_clock::now();
+  CLog::Log(LOGDEBUG, "{} - indexed {} pictures ({} read) and removed {} in {} in {} ms",
+            __FUNCTION__, stored, reads, indexed.size(), CURL::GetRedacted(m_path),
+            std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count());
+
+  db.Close();
+  return true;
+}
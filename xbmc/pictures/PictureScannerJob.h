@@ -0,0 +1,47 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "utils/Job.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+class CFileItem;
+class CFileItemList;
+typedef std::shared_ptr<CFileItem> CFileItemPtr;
+
+/*!
+ \brief Job filling the picture database with the EXIF/IPTC metadata of the pictures in a folder.
+
+ The job gets the listing of the folder. Pictures whose tags were loaded already are stored as
+ they are, the others that are new or changed since they were last indexed are read. Pictures no
+ longer in the folder are dropped from the database.
+ */
+class CPictureScannerJob : public CJob
+{
+public:
+  explicit CPictureScannerJob(const CFileItemList& items);
+  ~CPictureScannerJob() override = default;
+
+  const char* GetType() const override { return "picturescanner"; }
+  bool operator==(const CJob* job) const override;
+  bool DoWork() override;
+
+  /*! \brief Whether the pictures in a folder can be indexed */
+  static bool CanScan(const std::string& path);
+
+  /*! \brief Whether an item of a folder is a picture that is indexed */
+  static bool CanIndex(const CFileItem& item);
+
+private:
+  std::string m_path;
+  std::vector<CFileItemPtr> m_pictures; ///< copies, the listing may change meanwhile
+};
@@ -0,0 +1,261 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "SlideShowPicCache.h"
+
+#include "ServiceBroker.h"
+#include "guilib/Texture.h"
+#include "threads/SingleLock.h"
+#include "utils/JobManager.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <mutex>
+
+using namespace std::chrono_literals;
+
+// number of pictures decoded at the same time
+#define MAX_PREFETCH_JOBS 2
+
+namespace
+{
+
+class CSlideShowPicLoadJob : public CJob
+{
+public:
+  CSlideShowPicLoadJob(const std::string& path, int maxWidth, int maxHeight)
+    : m_path(path), m_maxWidth(maxWidth), m_maxHeight(maxHeight)
+  {
+  }
+
+  bool DoWork() override
+  {
+    m_texture = CTexture::LoadFromFile(m_path, m_maxWidth, m_maxHeight);
+    return m_texture != nullptr;
+  }
+
+  const char* GetType() const override { return "slideshowpicload"; }
+
+  std::unique_ptr<CTexture> m_texture;
+
+private:
+  std::string m_path;
+  int m_maxWidth;
+  int m_maxHeight;
+};
+
+size_t GetTextureSize(const CTexture& texture)
+{
+  return static_cast<size_t>(texture.GetPitch()) * texture.GetRows();
+}
+
+} // unnamed namespace
+
+CSlideShowPicCache::~CSlideShowPicCache()
+{
+  Clear();
+}
+
+void CSlideShowPicCache::Prefetch(const std::vector<std::pair<int, std::string>>& slides,
+                                  int maxWidth,
+                                  int maxHeight,
+                                  size_t memoryBudget)
+{
+  std::unique_lock<CCriticalSection> lock(m_critSection);
+  m_wanted = slides;
+  m_maxWidth = maxWidth;
+  m_maxHeight = maxHeight;
+  m_memoryBudget = memoryBudget;
+
+  // forget about everything that fell out of the prefetch window
+  for (auto it = m_entries.begin(); it != m_entries.end();)
+  {
+    const CacheEntry& entry = it->second;
+    if (IsWanted(it->first, entry.path) &&
+        (entry.taken || (entry.maxWidth == maxWidth && entry.maxHeight == maxHeight)))
+    {
+      ++it;
+      continue;
+    }
+    if (entry.jobID)
+      CServiceBroker::GetJobManager()->CancelJob(entry.jobID);
+    it = m_entries.erase(it);
+  }
+
+  EnforceBudget();
+  QueueJobs();
+}
+
+std::unique_ptr<CTexture> CSlideShowPicCache::Acquire(int slide,
+                                                      const std::string& path,
+                                                      int maxWidth,
+                                                      int maxHeight)
+{
+  std::unique_lock<CCriticalSection> lock(m_critSection);
+  while (true)
+  {
+    auto it = m_entries.find(slide);
+    if (it == m_entries.end())
+      break;
+
+    CacheEntry& entry = it->second;
+    if (entry.taken || entry.path != path || entry.maxWidth != maxWidth ||
+        entry.maxHeight != maxHeight)
+      break;
+
+    if (!entry.jobID)
+    {
+      entry.taken = true;
+      if (!entry.texture)
+        break; // prefetch failed, give it another try
+      return std::move(entry.texture);
+    }
+
+    // being decoded, wait for it rather than decoding it twice
+    CSingleExit exit(m_critSection);
+    m_jobDone.Wait(100ms);
+  }
+  lock.unlock();
+
+  return CTexture::LoadFromFile(path, maxWidth, maxHeight);
+}
+
+void CSlideShowPicCache::Release(int slide,
+                                 const std::string& path,
+                                 int maxWidth,
+                                 int maxHeight,
+                                 std::unique_ptr<CTexture> texture)
+{
+  if (!texture)
+    return;
+
+  std::unique_lock<CCriticalSection> lock(m_critSection);
+  if (!IsWanted(slide, path))
+    return;
+
+  auto it = m_entries.find(slide);
+  if (it != m_entries.end() && !it->second.taken)
+    return;
+
+  CacheEntry& entry = m_entries[slide];
+  entry.path = path;
+  entry.maxWidth = maxWidth;
+  entry.maxHeight = maxHeight;
+  entry.jobID = 0;
+  entry.taken = false;
+  entry.texture = std::move(texture);
+
+  EnforceBudget();
+}
+
+void CSlideShowPicCache::Clear()
+{
+  std::unique_lock<CCriticalSection> lock(m_critSection);
+  for (const auto& it : m_entries)
+  {
+    if (it.second.jobID)
+      CServiceBroker::GetJobManager()->CancelJob(it.second.jobID);
+  }
+  m_entries.clear();
+  m_wanted.clear();
+  m_jobDone.Set();
+}
+
+void CSlideShowPicCache::OnJobComplete(unsigned int jobID, bool success, CJob* job)
+{
+  std::unique_lock<CCriticalSection> lock(m_critSection);
+  auto it = std::find_if(m_entries.begin(), m_entries.end(),
+                         [jobID](const auto& entry) { return entry.second.jobID == jobID; });
+  if (it != m_entries.end())
+  {
+    CacheEntry& entry = it->second;
+    entry.jobID = 0;
+    if (success)
+      entry.texture = std::move(static_cast<CSlideShowPicLoadJob*>(job)->m_texture);
+    else
+      CLog::Log(LOGDEBUG, "CSlideShowPicCache: failed to prefetch slide {}: {}", it->first,
+                entry.path);
+
+    // textures already on the GPU are only released from the rendering thread, so just stop
+    // prefetching once the budget is used up and let the next Prefetch() trim the cache.
+    QueueJobs();
+  }
+  m_jobDone.Set();
+}
+
+bool CSlideShowPicCache::IsWanted(int slide, const std::string& path) const
+{
+  return std::find(m_wanted.begin(), m_wanted.end(), std::make_pair(slide, path)) !=
+         m_wanted.end();
+}
+
+size_t CSlideShowPicCache::GetCachedSize() const
+{
+  size_t size = 0;
+  for (const auto& it : m_entries)
+  {
+    if (it.second.texture)
+      size += GetTextureSize(*it.second.texture);
+  }
+  return size;
+}
+
+void CSlideShowPicCache::EnforceBudget()
+{
+  size_t size = GetCachedSize();
+  // evict the least wanted slides first
+  for (auto wanted = m_wanted.rbegin(); wanted != m_wanted.rend() && size > m_memoryBudget;
+       ++wanted)
+  {
+    auto it = m_entries.find(wanted->first);
+    if (it == m_entries.end() || !it->second.texture)
+      continue;
+
+    size -= GetTextureSize(*it->second.texture);
+    m_entries.erase(it);
+  }
+}
+
+void CSlideShowPicCache::QueueJobs()
+{
+  const size_t estimate = static_cast<size_t>(m_maxWidth) * m_maxHeight * 4;
+  size_t size = GetCachedSize();
+  unsigned int jobs = 0;
+  for (const auto& it : m_entries)
+  {
+    if (it.second.jobID)
+      jobs++;
+  }
+  size += jobs * estimate;
+
+  for (const auto& wanted : m_wanted)
+  {
+    if (jobs >= MAX_PREFETCH_JOBS)
+      break;
+    if (m_entries.find(wanted.first) != m_entries.end())
+      continue;
+    // always allow a single picture, whatever the budget is
+    if (size + estimate > m_memoryBudget && size > 0)
+      break;
+
+    CacheEntry& entry = m_entries[wanted.first];
+    entry.path = wanted.second;
+    entry.maxWidth = m_maxWidth;
+    entry.maxHeight = m_maxHeight;
+    entry.jobID = CServiceBroker::GetJobManager()->AddJob(
+        new CSlideShowPicLoadJob(wanted.second, m_maxWidth, m_maxHeight), this,
+        CJob::PRIORITY_NORMAL);
+    if (!entry.jobID)
+    {
+      m_entries.erase(wanted.first);
+      break;
+    }
+    jobs++;
+    size += estimate;
+  }
+}
@@ -0,0 +1,101 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "utils/Job.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+class CTexture;
+
+/*!
+ \brief Decoded picture cache used by the slideshow to prefetch slides around the current one.
+
+ The slideshow tells the cache which slides it wants held, most wanted first, and the cache
+ decodes them in parallel through the job manager, downscaled to the requested size. Decoded
+ textures are kept within a memory budget, evicting the least wanted slides first.
+ */
+class CSlideShowPicCache : public IJobCallback
+{
+public:
+  CSlideShowPicCache() = default;
+  ~CSlideShowPicCache() override;
+
+  /*!
+   \brief Set the slides to keep decoded.
+   \param slides slide number and picture path of each wanted slide, in priority order.
+   \param maxWidth maximal width to decode the pictures at.
+   \param maxHeight maximal height to decode the pictures at.
+   \param memoryBudget maximal number of bytes of decoded textures to hold.
+   */
+  void Prefetch(const std::vector<std::pair<int, std::string>>& slides,
+                int maxWidth,
+                int maxHeight,
+                size_t memoryBudget);
+
+  /*!
+   \brief Get the texture for a slide, taking it out of the cache.
+
+   Waits for the decode if the slide is already being prefetched, and decodes it in the calling
+   thread if it is not cached at all.
+   */
+  std::unique_ptr<CTexture> Acquire(int slide,
+                                    const std::string& path,
+                                    int maxWidth,
+                                    int maxHeight);
+
+  /*!
+   \brief Hand back the texture of a slide that is no longer displayed.
+
+   The texture is kept if the slide is still wanted, so that stepping back to it is instant.
+   Must be called from the rendering thread.
+   */
+  void Release(int slide,
+               const std::string& path,
+               int maxWidth,
+               int maxHeight,
+               std::unique_ptr<CTexture> texture);
+
+  /*!
+   \brief Cancel all outstanding decodes and drop all cached textures.
+   */
+  void Clear();
+
+  void OnJobComplete(unsigned int jobID, bool success, CJob* job) override;
+
+private:
+  struct CacheEntry
+  {
+    std::string path;
+    int maxWidth = 0;
+    int maxHeight = 0;
+    unsigned int jobID = 0; ///< non-zero while the slide is being decoded
+    bool taken = false; ///< texture was handed out with Acquire()
+    std::unique_ptr<CTexture> texture;
+  };
+
+  bool IsWanted(int slide, const std::string& path) const;
+  size_t GetCachedSize() const;
+  void EnforceBudget();
+  void QueueJobs();
+
+  mutable CCriticalSection m_critSection;
+  CEvent m_jobDone;
+  std::map<int, CacheEntry> m_entries;
+  std::vector<std::pair<int, std::string>> m_wanted;
+  int m_maxWidth = 0;
+  int m_maxHeight = 0;
+  size_t m_memoryBudget = 0;
+};
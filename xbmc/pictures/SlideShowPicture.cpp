@@ -85,6 +85,14 @@ void CSlideShowPic::Close()
 #endif
 }
 
+std::unique_ptr<CTexture> CSlideShowPic::ReleaseTexture()
+{
+  std::unique_lock<CCriticalSection> lock(m_textureAccess);
+  std::unique_ptr<CTexture> texture = std::move(m_pImage);
+  Close();
+  return texture;
+}
+
 void CSlideShowPic::Reset(DISPLAY_EFFECT dispEffect, TRANSITION_EFFECT transEffect)
 {
   std::unique_lock<CCriticalSection> lock(m_textureAccess);
@@ -844,6 +852,9 @@ void CSlideShowPic::Render(float* x, float* y, CTexture* pTexture, UTILS::COLOR:
   }
 
 #elif defined(HAS_GL)
+  // drawn directly, so the GUI quads batched so far must be drawn first
+  g_graphicsContext.GetRenderBatch().Finish();
+
   if (pTexture)
   {
     int unit = 0;
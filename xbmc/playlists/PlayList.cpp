@@ -23,6 +23,7 @@
 #include <algorithm>
 #include <cassert>
 #include <iostream>
+#include <numeric>
 #include <sstream>
 #include <string>
 #include <utility>
@@ -72,55 +73,98 @@ void CPlayList::AnnounceAdd(const std::shared_ptr<CFileItem>& item, int pos)
   CServiceBroker::GetAnnouncementManager()->Announce(ANNOUNCEMENT::Playlist, "OnAdd", item, data);
 }
 
-void CPlayList::Add(const std::shared_ptr<CFileItem>& item, int iPosition, int iOrder)
+void CPlayList::AnnounceAdd(int pos, int count)
 {
-  int iOldSize = size();
+  if (m_id == TYPE_NONE)
+    return;
+
+  // a single announcement for the whole range, rather than one with the details of every item
+  CVariant data;
+  data["playlistid"] = m_id;
+  data["position"] = pos;
+  data["count"] = count;
+  CServiceBroker::GetAnnouncementManager()->Announce(ANNOUNCEMENT::Playlist, "OnAdd", data);
+}
+
+void CPlayList::Add(const std::vector<std::shared_ptr<CFileItem>>& items, int iPosition, int iOrder)
+{
+  if (items.empty())
+    return;
+
+  const int iOldSize = size();
+  const int iCount = static_cast<int>(items.size());
   if (iPosition < 0 || iPosition >= iOldSize)
     iPosition = iOldSize;
   if (iOrder < 0 || iOrder >= iOldSize)
-    item->m_iprogramCount = iOldSize;
-  else
-    item->m_iprogramCount = iOrder;
+    iOrder = iOldSize;
 
-  // increment the playable counter
-  item->ClearProperty("unplayable");
-  if (m_iPlayableItems < 0)
-    m_iPlayableItems = 1;
-  else
-    m_iPlayableItems++;
+  for (int i = 0; i < iCount; i++)
+  {
+    const std::shared_ptr<CFileItem>& item = items[i];
+    item->m_iprogramCount = iOrder + i;
+
+    // increment the playable counter
+    item->ClearProperty("unplayable");
+    if (m_iPlayableItems < 0)
+      m_iPlayableItems = 1;
+    else
+      m_iPlayableItems++;
 
-  // set 'IsPlayable' property - needed for properly handling plugin:// URLs
-  item->SetProperty("IsPlayable", true);
+    // set 'IsPlayable' property - needed for properly handling plugin:// URLs
+    item->SetProperty("IsPlayable", true);
+  }
 
-  //CLog::Log(LOGDEBUG,"{} item:({:02}/{:02})[{}]", __FUNCTION__, iPosition, item->m_iprogramCount, item->GetPath());
-  if (iPosition == iOldSize)
-    m_vecItems.push_back(item);
-  else
+  // make room for the new orders and positions, nothing moves when adding to the end
+  if (iOrder < iOldSize)
   {
-    ivecItems it = m_vecItems.begin() + iPosition;
-    m_vecItems.insert(it, 1, item);
-    // correct any duplicate order values
-    if (iOrder < iOldSize)
-      IncrementOrder(iPosition + 1, iOrder);
+    for (int& order : m_vecOrder)
+    {
+      if (order >= iOrder)
+        order += iCount;
+    }
+  }
+  if (iPosition < iOldSize)
+  {
+    for (int& position : m_vecPosition)
+    {
+      if (position >= iPosition)
+        position += iCount;
+    }
   }
-  AnnounceAdd(item, iPosition);
+
+  //CLog::Log(LOGDEBUG,"{} item:({:02}/{:02})[{}]", __FUNCTION__, iPosition, iOrder, items[0]->GetPath());
+  m_vecItems.insert(m_vecItems.begin() + iPosition, items.begin(), items.end());
+  m_vecOrder.insert(m_vecOrder.begin() + iPosition, iCount, 0);
+  m_vecPosition.insert(m_vecPosition.begin() + iOrder, iCount, 0);
+  for (int i = 0; i < iCount; i++)
+  {
+    m_vecOrder[iPosition + i] = iOrder + i;
+    m_vecPosition[iOrder + i] = iPosition + i;
+  }
+
+  if (iCount == 1)
+    AnnounceAdd(items[0], iPosition);
+  else
+    AnnounceAdd(iPosition, iCount);
 }
 
 void CPlayList::Add(const std::shared_ptr<CFileItem>& item)
 {
-  Add(item, -1, -1);
+  Add({item}, -1, -1);
 }
 
 void CPlayList::Add(const CPlayList& playlist)
 {
-  for (int i = 0; i < playlist.size(); i++)
-    Add(playlist[i], -1, -1);
+  Add(playlist.m_vecItems, -1, -1);
 }
 
 void CPlayList::Add(const CFileItemList& items)
 {
+  std::vector<std::shared_ptr<CFileItem>> vecItems;
+  vecItems.reserve(items.Size());
   for (int i = 0; i < items.Size(); i++)
-    Add(items[i]);
+    vecItems.push_back(items[i]);
+  Add(vecItems, -1, -1);
 }
 
 void CPlayList::Insert(const CPlayList& playlist, int iPosition /* = -1 */)
@@ -132,11 +176,7 @@ void CPlayList::Insert(const CPlayList& playlist, int iPosition /* = -1 */)
     Add(playlist);
     return;
   }
-  for (int i = 0; i < playlist.size(); i++)
-  {
-    int iPos = iPosition + i;
-    Add(playlist[i], iPos, iPos);
-  }
+  Add(playlist.m_vecItems, iPosition, iPosition);
 }
 
 void CPlayList::Insert(const CFileItemList& items, int iPosition /* = -1 */)
@@ -148,10 +188,11 @@ void CPlayList::Insert(const CFileItemList& items, int iPosition /* = -1 */)
     Add(items);
     return;
   }
+  std::vector<std::shared_ptr<CFileItem>> vecItems;
+  vecItems.reserve(items.Size());
   for (int i = 0; i < items.Size(); i++)
-  {
-    Add(items[i], iPosition + i, iPosition + i);
-  }
+    vecItems.push_back(items[i]);
+  Add(vecItems, iPosition, iPosition);
 }
 
 void CPlayList::Insert(const std::shared_ptr<CFileItem>& item, int iPosition /* = -1 */)
@@ -163,48 +204,14 @@ void CPlayList::Insert(const std::shared_ptr<CFileItem>& item, int iPosition /*
     Add(item);
     return;
   }
-  Add(item, iPosition, iPosition);
+  Add({item}, iPosition, iPosition);
 }
 
-void CPlayList::DecrementOrder(int iOrder)
+void CPlayList::ResetOrder()
 {
-  if (iOrder < 0) return;
-
-  // it was the last item so do nothing
-  if (iOrder == size()) return;
-
-  // fix all items with an order greater than the removed iOrder
-  ivecItems it;
-  it = m_vecItems.begin();
-  while (it != m_vecItems.end())
-  {
-    CFileItemPtr item = *it;
-    if (item->m_iprogramCount > iOrder)
-    {
-      //CLog::Log(LOGDEBUG,"{} fixing item at order {}", __FUNCTION__, item->m_iprogramCount);
-      item->m_iprogramCount--;
-    }
-    ++it;
-  }
-}
-
-void CPlayList::IncrementOrder(int iPosition, int iOrder)
-{
-  if (iOrder < 0) return;
-
-  // fix all items with an order equal or greater to the added iOrder at iPos
-  ivecItems it;
-  it = m_vecItems.begin() + iPosition;
-  while (it != m_vecItems.end())
-  {
-    CFileItemPtr item = *it;
-    if (item->m_iprogramCount >= iOrder)
-    {
-      //CLog::Log(LOGDEBUG,"{} fixing item at order {}", __FUNCTION__, item->m_iprogramCount);
-      item->m_iprogramCount++;
-    }
-    ++it;
-  }
+  m_vecOrder.resize(m_vecItems.size());
+  std::iota(m_vecOrder.begin(), m_vecOrder.end(), 0);
+  m_vecPosition = m_vecOrder;
 }
 
 void CPlayList::Clear()
@@ -212,7 +219,9 @@ void CPlayList::Clear()
   bool announce = false;
   if (!m_vecItems.empty())
   {
-    m_vecItems.erase(m_vecItems.begin(), m_vecItems.end());
+    m_vecItems.clear();
+    m_vecOrder.clear();
+    m_vecPosition.clear();
     announce = true;
   }
   m_strPlayListName = "";
@@ -241,13 +250,7 @@ const std::shared_ptr<CFileItem> CPlayList::operator[](int iItem) const
 
 std::shared_ptr<CFileItem> CPlayList::operator[](int iItem)
 {
-  if (iItem < 0 || iItem >= size())
-  {
-    assert(false);
-    CLog::Log(LOGERROR, "Error trying to retrieve an item that's out of range");
-    return CFileItemPtr();
-  }
-  return m_vecItems[iItem];
+  return static_cast<const CPlayList&>(*this)[iItem];
 }
 
 void CPlayList::Shuffle(int iPosition)
@@ -263,25 +266,38 @@ void CPlayList::Shuffle(int iPosition)
       iPosition = 0;
     CLog::Log(LOGDEBUG, "{} shuffling at pos:{}", __FUNCTION__, iPosition);
 
-    ivecItems it = m_vecItems.begin() + iPosition;
-    KODI::UTILS::RandomShuffle(it, m_vecItems.end());
+    // items and their orders are shuffled alike
+    std::vector<int> positions(size() - iPosition);
+    std::iota(positions.begin(), positions.end(), iPosition);
+    KODI::UTILS::RandomShuffle(positions.begin(), positions.end());
+
+    std::vector<std::shared_ptr<CFileItem>> items(m_vecItems.begin(), m_vecItems.begin() + iPosition);
+    std::vector<int> orders(m_vecOrder.begin(), m_vecOrder.begin() + iPosition);
+    items.reserve(m_vecItems.size());
+    orders.reserve(m_vecOrder.size());
+    for (int position : positions)
+    {
+      items.push_back(std::move(m_vecItems[position]));
+      orders.push_back(m_vecOrder[position]);
+    }
+    m_vecItems.swap(items);
+    m_vecOrder.swap(orders);
+    for (int i = iPosition; i < size(); i++)
+      m_vecPosition[m_vecOrder[i]] = i;
 
     // the list is now shuffled!
     m_bShuffled = true;
   }
 }
 
-struct SSortPlayListItem
-{
-  static bool PlaylistSort(const CFileItemPtr &left, const CFileItemPtr &right)
-  {
-    return (left->m_iprogramCount < right->m_iprogramCount);
-  }
-};
-
 void CPlayList::UnShuffle()
 {
-  std::sort(m_vecItems.begin(), m_vecItems.end(), SSortPlayListItem::PlaylistSort);
+  // every item goes straight back to its order, no sorting needed
+  std::vector<std::shared_ptr<CFileItem>> items(m_vecItems.size());
+  for (int i = 0; i < size(); i++)
+    items[m_vecOrder[i]] = std::move(m_vecItems[i]);
+  m_vecItems.swap(items);
+  ResetOrder();
   // the list is now unshuffled!
   m_bShuffled = false;
 }
@@ -293,85 +309,99 @@ const std::string& CPlayList::GetName() const
 
 void CPlayList::Remove(const std::string& strFileName)
 {
-  int iOrder = -1;
-  int position = 0;
-  ivecItems it;
-  it = m_vecItems.begin();
-  while (it != m_vecItems.end() )
+  RemoveIf([&strFileName](const CFileItem& item) { return item.GetPath() == strFileName; });
+}
+
+int CPlayList::RemoveIf(const std::function<bool(const CFileItem&)>& predicate)
+{
+  // items are removed in a single pass, the orders of the rest are fixed up once afterwards
+  std::vector<bool> removedOrders(m_vecItems.size(), false);
+  int iKept = 0;
+  for (int i = 0; i < size(); i++)
   {
-    CFileItemPtr item = *it;
-    if (item->GetPath() == strFileName)
+    if (predicate(*m_vecItems[i]))
     {
-      iOrder = item->m_iprogramCount;
-      it = m_vecItems.erase(it);
-      AnnounceRemove(position);
-      //CLog::Log(LOGDEBUG,"PLAYLIST, removing item at order {}", iPos);
+      removedOrders[m_vecOrder[i]] = true;
+      //CLog::Log(LOGDEBUG,"PLAYLIST, removing item at order {}", m_vecOrder[i]);
+      AnnounceRemove(iKept);
     }
     else
     {
-      ++position;
-      ++it;
+      m_vecItems[iKept] = std::move(m_vecItems[i]);
+      m_vecOrder[iKept] = m_vecOrder[i];
+      iKept++;
     }
   }
-  DecrementOrder(iOrder);
+
+  const int iRemoved = size() - iKept;
+  if (iRemoved == 0)
+    return 0;
+
+  // each order moves down by the number of removed orders below it
+  std::vector<int> newOrders(removedOrders.size());
+  int iBelow = 0;
+  for (size_t order = 0; order < removedOrders.size(); order++)
+  {
+    newOrders[order] = static_cast<int>(order) - iBelow;
+    if (removedOrders[order])
+      iBelow++;
+  }
+
+  m_vecItems.resize(iKept);
+  m_vecOrder.resize(iKept);
+  m_vecPosition.resize(iKept);
+  for (int i = 0; i < iKept; i++)
+  {
+    m_vecOrder[i] = newOrders[m_vecOrder[i]];
+    m_vecPosition[m_vecOrder[i]] = i;
+  }
+  return iRemoved;
 }
 
 int CPlayList::FindOrder(int iOrder) const
 {
-  for (int i = 0; i < size(); i++)
-  {
-    if (m_vecItems[i]->m_iprogramCount == iOrder)
-      return i;
-  }
-  return -1;
+  if (iOrder < 0 || iOrder >= size())
+    return -1;
+  return m_vecPosition[iOrder];
+}
+
+int CPlayList::GetOrder(int position) const
+{
+  if (position < 0 || position >= size())
+    return -1;
+  return m_vecOrder[position];
 }
 
 // remove item from playlist by position
 void CPlayList::Remove(int position)
 {
-  int iOrder = -1;
   if (position >= 0 && position < (int)m_vecItems.size())
   {
-    iOrder = m_vecItems[position]->m_iprogramCount;
+    const int iOrder = m_vecOrder[position];
     m_vecItems.erase(m_vecItems.begin() + position);
+    m_vecOrder.erase(m_vecOrder.begin() + position);
+    m_vecPosition.erase(m_vecPosition.begin() + iOrder);
+
+    // fix all items with an order or position greater than the removed one
+    for (int& order : m_vecOrder)
+    {
+      if (order > iOrder)
+        order--;
+    }
+    for (int& pos : m_vecPosition)
+    {
+      if (pos > position)
+        pos--;
+    }
   }
-  DecrementOrder(iOrder);
 
   AnnounceRemove(position);
 }
 
 int CPlayList::RemoveDVDItems()
 {
-  std::vector <std::string> vecFilenames;
-
-  // Collect playlist items from DVD share
-  ivecItems it;
-  it = m_vecItems.begin();
-  while (it != m_vecItems.end() )
-  {
-    CFileItemPtr item = *it;
-    if ( item->IsCDDA() || item->IsOnDVD() )
-    {
-      vecFilenames.push_back( item->GetPath() );
-    }
-    ++it;
-  }
-
-  // Delete them from playlist
-  int nFileCount = vecFilenames.size();
-  if ( nFileCount )
-  {
-    std::vector <std::string>::iterator it;
-    it = vecFilenames.begin();
-    while (it != vecFilenames.end() )
-    {
-      std::string& strFilename = *it;
-      Remove( strFilename );
-      ++it;
-    }
-    vecFilenames.erase( vecFilenames.begin(), vecFilenames.end() );
-  }
-  return nFileCount;
+  // Delete playlist items from DVD share
+  return RemoveIf([](const CFileItem& item) { return item.IsCDDA() || item.IsOnDVD(); });
 }
 
 bool CPlayList::Swap(int position1, int position2)
@@ -386,14 +416,15 @@ bool CPlayList::Swap(int position1, int position2)
     return false;
   }
 
-  if (!IsShuffled())
+  if (IsShuffled())
   {
-    // swap the ordinals before swapping the items!
-    //CLog::Log(LOGDEBUG,"PLAYLIST swapping items at orders ({}, {})",m_vecItems[position1]->m_iprogramCount,m_vecItems[position2]->m_iprogramCount);
-    std::swap(m_vecItems[position1]->m_iprogramCount, m_vecItems[position2]->m_iprogramCount);
+    // the items take their orders along
+    std::swap(m_vecOrder[position1], m_vecOrder[position2]);
+    m_vecPosition[m_vecOrder[position1]] = position1;
+    m_vecPosition[m_vecOrder[position2]] = position2;
   }
 
-  // swap the items
+  // swap the items, unshuffled the orders stay with the positions
   std::swap(m_vecItems[position1], m_vecItems[position2]);
   return true;
 }
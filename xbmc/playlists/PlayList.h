@@ -10,6 +10,7 @@
 
 #include "PlayListTypes.h"
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -40,6 +41,9 @@ public:
   void Insert(const std::shared_ptr<CFileItem>& item, int iPosition = -1);
 
   int FindOrder(int iOrder) const;
+  // The original order of the item at a position. The m_iprogramCount of the items is only set
+  // as they are added, it's not kept up to date.
+  int GetOrder(int position) const;
   const std::string& GetName() const;
   void Remove(const std::string& strFileName);
   void Remove(int position);
@@ -75,17 +79,26 @@ protected:
   bool m_bWasPlayed;
 
 //  CFileItemList m_vecItems;
-  std::vector<std::shared_ptr<CFileItem>> m_vecItems;
+  std::vector<std::shared_ptr<CFileItem>> m_vecItems; // in play order
   typedef std::vector<std::shared_ptr<CFileItem>>::iterator ivecItems;
 
+  // Subclasses filling m_vecItems directly make its items ordered as they are
+  void ResetOrder();
+
 private:
-  void Add(const std::shared_ptr<CFileItem>& item, int iPosition, int iOrderOffset);
-  void DecrementOrder(int iOrder);
-  void IncrementOrder(int iPosition, int iOrder);
+  void Add(const std::vector<std::shared_ptr<CFileItem>>& items, int iPosition, int iOrder);
+  int RemoveIf(const std::function<bool(const CFileItem&)>& predicate);
 
   void AnnounceRemove(int pos);
   void AnnounceClear();
   void AnnounceAdd(const std::shared_ptr<CFileItem>& item, int pos);
+  void AnnounceAdd(int pos, int count);
+
+  // The original order of the items, as permutations between positions and orders. The orders
+  // are kept here rather than in the items, so adding, removing and (un)shuffling doesn't go
+  // through all of them.
+  std::vector<int> m_vecOrder; // order of the item at each position
+  std::vector<int> m_vecPosition; // position of the item with each order
 };
 
 typedef std::shared_ptr<CPlayList> CPlayListPtr;
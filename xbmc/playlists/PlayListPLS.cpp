@@ -177,6 +177,7 @@ bool CPlayListPLS::Load(const std::string &strFile)
 
   if (bFailed)
   {
+    ResetOrder();
     CLog::Log(LOGERROR,
               "File {} is not a valid PLS playlist. Location of first file,title or length is not "
               "permitted (eg. File0 should be File1)",
@@ -197,6 +198,7 @@ bool CPlayListPLS::Load(const std::string &strFile)
       ++p;
     }
   }
+  ResetOrder();
 
   return true;
 }
@@ -184,6 +184,8 @@ void CAdvancedSettings::Initialize()
   m_slideshowPanAmount = 2.5f;
   m_slideshowZoomAmount = 5.0f;
   m_slideshowBlackBarCompensation = 20.0f;
+  m_slideshowPrefetchCount = 4;
+  m_slideshowPrefetchMemory = 16;
 
   m_songInfoDuration = 10;
 
@@ -316,6 +318,7 @@ void CAdvancedSettings::Initialize()
   m_bVideoLibraryCleanOnUpdate = false;
   m_bVideoLibraryUseFastHash = true;
   m_bVideoScannerIgnoreErrors = false;
+  m_iVideoScannerLookups = 3;
   m_iVideoLibraryDateAdded = 1; // prefer mtime over ctime and current time
 
   m_videoEpisodeExtraArt = {};
@@ -839,6 +842,7 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
   if (pElement)
   {
     XMLUtils::GetBoolean(pElement, "ignoreerrors", m_bVideoScannerIgnoreErrors);
+    XMLUtils::GetInt(pElement, "lookups", m_iVideoScannerLookups, 1, 8);
   }
 
   // Backward-compatibility of ExternalPlayer config
@@ -853,6 +857,8 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetFloat(pElement, "panamount", m_slideshowPanAmount, 0.0f, 20.0f);
     XMLUtils::GetFloat(pElement, "zoomamount", m_slideshowZoomAmount, 0.0f, 20.0f);
     XMLUtils::GetFloat(pElement, "blackbarcompensation", m_slideshowBlackBarCompensation, 0.0f, 50.0f);
+    XMLUtils::GetInt(pElement, "prefetchcount", m_slideshowPrefetchCount, 0, 32);
+    XMLUtils::GetInt(pElement, "prefetchmemory", m_slideshowPrefetchMemory, 0, 64);
   }
 
   pElement = pRootElement->FirstChildElement("network");
@@ -180,6 +180,8 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     float m_slideshowBlackBarCompensation;
     float m_slideshowZoomAmount;
     float m_slideshowPanAmount;
+    int m_slideshowPrefetchCount; ///< number of pictures prefetched ahead of the current slide
+    int m_slideshowPrefetchMemory; ///< memory budget of the prefetched pictures in MB
 
     int m_songInfoDuration;
     int m_logLevel;
@@ -271,6 +273,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     std::vector<std::string> m_videoMusicVideoExtraArt;
 
     bool m_bVideoScannerIgnoreErrors;
+    int m_iVideoScannerLookups; ///< scraper lookups run at once by the video scanner
     int m_iVideoLibraryDateAdded;
 
     std::set<std::string> m_vecTokens;
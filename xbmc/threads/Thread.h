@@ -80,6 +80,8 @@ public:
 
   static CThread* GetCurrentThread();
 
+  const std::string& GetThreadName() const { return m_ThreadName; }
+
   virtual void OnException(){} // signal termination handler
 
 protected:
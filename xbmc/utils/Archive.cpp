@@ -49,6 +49,36 @@ CArchive::CArchive(CFile* pFile, int mode)
   }
 }
 
+CArchive::CArchive(std::vector<uint8_t>& buffer, int mode)
+{
+  m_pFile = nullptr;
+  m_iMode = mode;
+
+  if (mode == load)
+  {
+    // read straight from the caller's buffer, there is nothing to refill
+    m_BufferPos = buffer.data();
+    m_BufferRemain = buffer.size();
+  }
+  else
+  {
+    m_pMemory = &buffer;
+    m_pBuffer = std::unique_ptr<uint8_t[]>(new uint8_t[CARCHIVE_BUFFER_MAX]);
+    m_BufferPos = m_pBuffer.get();
+    m_BufferRemain = CARCHIVE_BUFFER_MAX;
+  }
+}
+
+CArchive::CArchive(const uint8_t* data, size_t size)
+{
+  m_pFile = nullptr;
+  m_iMode = load;
+
+  // loading never writes through m_BufferPos
+  m_BufferPos = const_cast<uint8_t*>(data);
+  m_BufferRemain = size;
+}
+
 CArchive::~CArchive()
 {
   FlushBuffer();
@@ -69,6 +99,11 @@ bool CArchive::IsStoring() const
   return (m_iMode == store);
 }
 
+bool CArchive::IsLoadComplete() const
+{
+  return m_iMode == load && m_BufferRemain == 0 && !m_bReadPastEnd;
+}
+
 CArchive& CArchive::operator<<(float f)
 {
   return streamout(&f, sizeof(f));
@@ -242,6 +277,9 @@ CArchive& CArchive::operator>>(std::string& str)
 
   if (iLength > MAX_STRING_SIZE)
     throw std::out_of_range("String too large, over 100MB");
+  // in memory the whole data is at hand, don't allocate for a length that can't be right
+  if (!m_pFile && iLength > m_BufferRemain)
+    throw std::out_of_range("String past the end of the data");
 
   auto s = std::unique_ptr<char[]>(new char[iLength]);
   streamin(s.get(), iLength * sizeof(char));
@@ -396,7 +434,13 @@ void CArchive::FlushBuffer()
 {
   if (m_iMode == store && m_BufferPos != m_pBuffer.get())
   {
-    if (m_pFile->Write(m_pBuffer.get(), m_BufferPos - m_pBuffer.get()) != m_BufferPos - m_pBuffer.get())
+    if (m_pMemory)
+    {
+      m_pMemory->insert(m_pMemory->end(), m_pBuffer.get(), m_BufferPos);
+      m_BufferPos = m_pBuffer.get();
+      m_BufferRemain = CARCHIVE_BUFFER_MAX;
+    }
+    else if (m_pFile->Write(m_pBuffer.get(), m_BufferPos - m_pBuffer.get()) != m_BufferPos - m_pBuffer.get())
       CLog::Log(LOGERROR, "{}: Error flushing buffer", __FUNCTION__);
     else
     {
@@ -423,7 +467,7 @@ CArchive &CArchive::streamout_bufferwrap(const uint8_t *ptr, size_t size)
 
 void CArchive::FillBuffer()
 {
-  if (m_iMode == load && m_BufferRemain == 0)
+  if (m_iMode == load && m_BufferRemain == 0 && m_pFile)
   {
     auto read = m_pFile->Read(m_pBuffer.get(), CARCHIVE_BUFFER_MAX);
     if (read > 0)
@@ -450,6 +494,7 @@ CArchive &CArchive::streamin_bufferwrap(uint8_t *ptr, size_t size)
                   static_cast<unsigned long>(ptr - orig_ptr + m_BufferRemain));
 
         memset(orig_ptr, 0, orig_size);
+        m_bReadPastEnd = true;
         return *this;
       }
     }
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <cstring>
 #include <memory>
 #include <string>
@@ -30,6 +31,16 @@ class CArchive
 {
 public:
   CArchive(XFILE::CFile* pFile, int mode);
+
+  /*! \brief Archive backed by memory instead of a file.
+   When storing, the data is appended to buffer as the archive is flushed. When loading, the
+   data is read from buffer, which must not be modified while the archive is in use.
+   */
+  CArchive(std::vector<uint8_t>& buffer, int mode);
+
+  /*! \brief Archive loading from a memory range, which must outlive the archive.
+   */
+  CArchive(const uint8_t* data, size_t size);
   ~CArchive();
 
   /* CArchive support storing and loading of all C basic integer types
@@ -135,6 +146,12 @@ public:
   bool IsLoading() const;
   bool IsStoring() const;
 
+  /*! \brief Whether loading from memory read the data up to its end, and not past it.
+   Reads past the end of the data are zero filled rather than reported, so decoders of untrusted
+   data check this once they are done.
+   */
+  bool IsLoadComplete() const;
+
   void Close();
 
   enum Mode {load = 0, store};
@@ -172,10 +189,12 @@ protected:
   }
 
   XFILE::CFile* m_pFile; //non-owning
+  std::vector<uint8_t>* m_pMemory = nullptr; //non-owning, used instead of m_pFile when storing
   int m_iMode;
   std::unique_ptr<uint8_t[]> m_pBuffer;
   uint8_t *m_BufferPos;
   size_t m_BufferRemain;
+  bool m_bReadPastEnd = false;
 
 private:
   void FlushBuffer();
@@ -0,0 +1,440 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "Benchmark.h"
+
+#include "URL.h"
+#include "XBDateTime.h"
+#include "filesystem/File.h"
+#include "guilib/GUIRenderBatch.h"
+#include "utils/CharsetConverter.h"
+#include "utils/Crc32.h"
+#include "utils/JSONVariantParser.h"
+#include "utils/JSONVariantWriter.h"
+#include "utils/SortUtils.h"
+#include "utils/StringUtils.h"
+#include "utils/SyntheticLibrary.h"
+#include "utils/URIUtils.h"
+#include "utils/Variant.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+
+#define BENCHMARK_RESULTS "special://temp/benchmark-{}.json"
+#define BENCHMARK_BASELINE "special://profile/benchmark-{}-baseline.json"
+// a case regresses if its median or p95 grows by more than this share, and by more than the
+// noise floor
+#define BENCHMARK_TOLERANCE 0.1
+#define BENCHMARK_NOISE_FLOOR 0.05
+
+namespace
+{
+double Percentile(std::vector<double> times, double percentile)
+{
+  if (times.empty())
+    return 0.0;
+
+  std::sort(times.begin(), times.end());
+  return times[std::min(static_cast<size_t>(percentile * times.size()), times.size() - 1)];
+}
+
+bool WriteResults(const std::string& path, const CVariant& results)
+{
+  XFILE::CFile file;
+  if (!file.OpenForWrite(path, true) || !CJSONVariantWriter::Write(results, file, false))
+  {
+    CLog::Log(LOGERROR, "CBenchmark: unable to write {}", path);
+    return false;
+  }
+  return true;
+}
+
+bool CheckCrc32()
+{
+  // slicing-by-8 works on 8 bytes at a time and the rest one by one, lowercasing on 64 bytes at a
+  // time with a fallback to StringUtils::ToLower for anything that isn't ASCII
+  const std::string tail = "The quick brown fox jumps over the lazy dog";
+  const std::string mixed =
+      "SMB://NAS/Music/Some Artist/Some Album (1999)/01 - The First Track Of The Album.FLAC";
+  const std::string nonAscii = "Ñandú Straße Ωmega 東京";
+  const std::string nonAsciiMixed = mixed + "/Ñandú ÉCOLE";
+  std::string lower = mixed;
+  StringUtils::ToLower(lower);
+  std::string nonAsciiLower = nonAsciiMixed;
+  StringUtils::ToLower(nonAsciiLower);
+
+  struct Answer
+  {
+    const char* name;
+    uint32_t crc;
+    uint32_t expected;
+  };
+  const Answer answers[] = {
+      {"Crc32::Compute(\"123456789\")", Crc32::Compute("123456789"), 0x0376E6E7},
+      {"Crc32::Compute of 43 bytes", Crc32::Compute(tail), 0xBA62119E},
+      {"Crc32::Compute of UTF-8", Crc32::Compute(nonAscii), 0xEC8FC658},
+      {"Crc32::ComputeFromLowerCase of mixed case", Crc32::ComputeFromLowerCase(mixed),
+       Crc32::Compute(lower)},
+      {"Crc32::ComputeFromLowerCase of UTF-8", Crc32::ComputeFromLowerCase(nonAsciiMixed),
+       Crc32::Compute(nonAsciiLower)},
+  };
+
+  bool success = true;
+  for (const auto& answer : answers)
+  {
+    if (answer.crc != answer.expected)
+    {
+      CLog::Log(LOGERROR, "CBenchmark: {} is {:08X} instead of {:08X}", answer.name, answer.crc,
+                answer.expected);
+      success = false;
+    }
+  }
+  return success;
+}
+
+// adds a quad at x for each of the states
+void AddQuads(CGUIRenderBatch& batch, const std::vector<GUIRenderState>& states, float x = 0)
+{
+  for (const auto& state : states)
+  {
+    GUIRenderVertex* v = batch.AddQuads(state);
+    v[0] = {x, 0, 0, 255, 255, 255, 255, 0, 0, 0, 0};
+    v[1] = {x + 16, 0, 0, 255, 255, 255, 255, 1, 0, 1, 0};
+    v[2] = {x + 16, 16, 0, 255, 255, 255, 255, 1, 1, 1, 1};
+    v[3] = {x, 16, 0, 255, 255, 255, 255, 0, 1, 0, 1};
+    x += 16;
+  }
+}
+
+bool CheckRenderBatch()
+{
+  CGUIRenderBatch batch;
+  auto* recorder = new CGUIRenderBackendRecorder;
+  batch.SetBackend(std::unique_ptr<IGUIRenderBackend>(recorder));
+
+  GUIRenderState texture;
+  texture.texture = 1;
+  GUIRenderState font;
+  font.mode = GUIRenderState::MODE_FONT;
+  font.texture = 2;
+
+  std::vector<GUIRenderState> alternating;
+  for (unsigned int quad = 0; quad < 100; ++quad)
+    alternating.push_back(quad % 2 ? font : texture);
+
+  // consecutive quads sharing their state are a single draw, every change of state flushes
+  struct Answer
+  {
+    const char* name;
+    std::vector<GUIRenderState> states;
+    unsigned int draws;
+  };
+  const Answer answers[] = {
+      {"quads sharing their state", std::vector<GUIRenderState>(100, texture), 1},
+      {"quads alternating between two states", alternating, 100},
+  };
+
+  bool success = true;
+  for (const auto& answer : answers)
+  {
+    const std::vector<GUIRenderState>& states = answer.states;
+    recorder->Clear();
+    AddQuads(batch, states);
+    batch.Finish();
+
+    const CGUIRenderBackendRecorder::Counters& counters = recorder->GetCounters();
+    if (counters.draws != answer.draws || counters.stateChanges != answer.draws ||
+        counters.quads != states.size() || counters.flushes != 1)
+    {
+      CLog::Log(LOGERROR,
+                "CBenchmark: CGUIRenderBatch drew {} quads in {} draws with {} state changes and "
+                "{} flushes for {}, instead of {} quads in {} draws",
+                counters.quads, counters.draws, counters.stateChanges, counters.flushes,
+                answer.name, states.size(), answer.draws);
+      success = false;
+    }
+  }
+  return success;
+}
+
+SortItems CopyItems(const SortItems& items)
+{
+  // sorting stores its keys in the items, a copy keeps every run from starting out sorted
+  SortItems copy;
+  copy.reserve(items.size());
+  for (const auto& item : items)
+    copy.push_back(std::make_shared<SortItem>(*item));
+  return copy;
+}
+} // namespace
+
+bool CBenchmark::RunSuite(const std::string& suite, unsigned int scale, bool updateBaseline)
+{
+  CBenchmark benchmark(suite);
+  if (suite == "core")
+  {
+    if (!benchmark.CheckCore())
+      return false;
+    benchmark.RunCore(scale);
+  }
+#ifdef HAS_PROFILER
+  // needs the databases and settings of the application, see BenchmarkLibrary.cpp
+  else if (suite == "library")
+  {
+    if (!benchmark.RunLibrary(scale))
+      return false;
+  }
+#endif
+  else
+  {
+    CLog::Log(LOGERROR, "CBenchmark: unknown suite {}", suite);
+    return false;
+  }
+
+  return benchmark.Finish(updateBaseline);
+}
+
+void CBenchmark::Run(const std::string& name,
+                     unsigned int runs,
+                     const std::function<void()>& function,
+                     const std::function<void()>& setup /* = nullptr */)
+{
+  Case benchmarkCase{name, {}};
+  for (unsigned int run = 0; run <= runs; ++run)
+  {
+    if (setup)
+      setup();
+
+    const auto start = std::chrono::steady_clock::now();
+    function();
+    const auto end = std::chrono::steady_clock::now();
+
+    // the first run fills caches and lazily built tables
+    if (run > 0)
+      benchmarkCase.times.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+  }
+
+  CLog::Log(LOGDEBUG, "CBenchmark: {}: {:.3f} ms", name, Percentile(benchmarkCase.times, 0.5));
+  m_cases.push_back(std::move(benchmarkCase));
+}
+
+bool CBenchmark::CheckCore() const
+{
+  // both are checked, to log every wrong result
+  const bool crc = CheckCrc32();
+  const bool renderBatch = CheckRenderBatch();
+  return crc && renderBatch;
+}
+
+void CBenchmark::RunCore(unsigned int scale)
+{
+  CSyntheticLibrary library;
+  const std::vector<CSyntheticLibrary::Song> songs = library.GetSongs(10000 * scale);
+  const std::vector<CSyntheticLibrary::Movie> movies = library.GetMovies(1000 * scale);
+
+  SortItems songItems;
+  songItems.reserve(songs.size());
+  for (const auto& song : songs)
+  {
+    auto item = std::make_shared<SortItem>();
+    (*item)[FieldId] = static_cast<int>(songItems.size() + 1);
+    (*item)[FieldLabel] = song.title;
+    (*item)[FieldTitle] = song.title;
+    (*item)[FieldArtist] = CVariant(std::vector<std::string>{song.artist});
+    (*item)[FieldAlbum] = song.album;
+    (*item)[FieldGenre] = song.genre;
+    (*item)[FieldYear] = song.year;
+    (*item)[FieldTrackNumber] = song.track;
+    (*item)[FieldTime] = song.duration;
+    (*item)[FieldPath] = song.path;
+    (*item)[FieldDateAdded] = song.dateAdded;
+    songItems.push_back(std::move(item));
+  }
+
+  SortItems movieItems;
+  movieItems.reserve(movies.size());
+  for (const auto& movie : movies)
+  {
+    auto item = std::make_shared<SortItem>();
+    (*item)[FieldId] = static_cast<int>(movieItems.size() + 1);
+    (*item)[FieldLabel] = movie.title;
+    (*item)[FieldTitle] = movie.title;
+    (*item)[FieldGenre] = CVariant(movie.genres);
+    (*item)[FieldDirector] = CVariant(std::vector<std::string>{movie.director});
+    (*item)[FieldYear] = movie.year;
+    (*item)[FieldRating] = movie.rating;
+    (*item)[FieldTime] = movie.runtime;
+    (*item)[FieldPath] = movie.path + movie.file;
+    (*item)[FieldDateAdded] = movie.dateAdded;
+    movieItems.push_back(std::move(item));
+  }
+
+  // keeps the results of the cases from being optimized out
+  size_t sink = 0;
+  SortItems items;
+  const auto sort = [&items](SortBy sortBy, SortOrder sortOrder, SortAttribute attributes) {
+    return [&items, sortBy, sortOrder, attributes]() {
+      SortUtils::Sort(sortBy, sortOrder, attributes, items);
+    };
+  };
+
+  Run("SortUtils::Sort songs by artist", 5,
+      sort(SortByArtist, SortOrderAscending, SortAttributeIgnoreArticle),
+      [&]() { items = CopyItems(songItems); });
+  Run("SortUtils::Sort songs by title", 5,
+      sort(SortByTitle, SortOrderAscending, SortAttributeIgnoreArticle),
+      [&]() { items = CopyItems(songItems); });
+  Run("SortUtils::Sort movies by year", 10,
+      sort(SortByYear, SortOrderAscending, SortAttributeNone),
+      [&]() { items = CopyItems(movieItems); });
+  Run("SortUtils::Sort movies by date added", 10,
+      sort(SortByDateAdded, SortOrderDescending, SortAttributeNone),
+      [&]() { items = CopyItems(movieItems); });
+  items.clear();
+
+  Run("CVariant copy of songs", 5, [&]() {
+    DatabaseResults results;
+    results.reserve(songItems.size());
+    for (const auto& item : songItems)
+      results.push_back(*item);
+    sink += results.size();
+  });
+
+  Run("StringUtils::AlphaNumericSortKey", 5, [&]() {
+    for (const auto& song : songs)
+      sink += StringUtils::AlphaNumericSortKey(song.title).size();
+  });
+
+  Run("StringUtils::Split and Join", 5, [&]() {
+    for (const auto& song : songs)
+      sink += StringUtils::Join(StringUtils::Split(song.path, "/"), "/").size();
+  });
+
+  Run("CURL", 5, [&]() {
+    for (const auto& song : songs)
+    {
+      const CURL url(song.path);
+      sink += url.GetFileName().size() + url.GetWithoutUserDetails().size();
+    }
+  });
+
+  Run("URIUtils", 5, [&]() {
+    for (const auto& song : songs)
+    {
+      const std::string folder = URIUtils::GetParentPath(song.path);
+      sink += URIUtils::AddFileToFolder(folder, URIUtils::GetFileName(song.path)).size();
+    }
+  });
+
+  Run("Crc32", 5, [&]() {
+    for (const auto& song : songs)
+      sink += Crc32::ComputeFromLowerCase(song.path) ^ Crc32::Compute(song.title);
+  });
+
+  Run("CDateTime", 5, [&]() {
+    CDateTime date;
+    for (const auto& song : songs)
+    {
+      date.SetFromDBDateTime(song.dateAdded);
+      sink += date.GetAsDBDateTime().size();
+    }
+  });
+
+  Run("CCharsetConverter::utf8ToW", 5, [&]() {
+    std::wstring title;
+    for (const auto& song : songs)
+    {
+      g_charsetConverter.utf8ToW(song.title, title, false);
+      sink += title.size();
+    }
+  });
+
+  // a poster wall: the shared frame, the poster and the glyphs of the title of each movie
+  CGUIRenderBatch batch;
+  auto* recorder = new CGUIRenderBackendRecorder;
+  batch.SetBackend(std::unique_ptr<IGUIRenderBackend>(recorder));
+  std::vector<GUIRenderState> states;
+  for (const auto& movie : movies)
+  {
+    GUIRenderState state;
+    state.texture = 1;
+    states.push_back(state);
+    state.texture = 10 + static_cast<unsigned int>(states.size() % 50);
+    states.push_back(state);
+    state.mode = GUIRenderState::MODE_FONT;
+    state.texture = 2;
+    states.insert(states.end(), movie.title.size(), state);
+  }
+  Run("CGUIRenderBatch", 10, [&]() {
+    recorder->Clear();
+    AddQuads(batch, states);
+    batch.Finish();
+    sink += recorder->GetCounters().draws + recorder->GetCounters().checksum;
+  });
+
+  CLog::Log(LOGDEBUG, "CBenchmark: core suite done ({})", sink);
+}
+
+bool CBenchmark::Finish(bool updateBaseline) const
+{
+  CVariant results(CVariant::VariantTypeObject);
+  for (const auto& benchmarkCase : m_cases)
+  {
+    CVariant& result = results[benchmarkCase.name];
+    result["runs"] = static_cast<unsigned int>(benchmarkCase.times.size());
+    result["median"] = Percentile(benchmarkCase.times, 0.5);
+    result["p95"] = Percentile(benchmarkCase.times, 0.95);
+    result["min"] = Percentile(benchmarkCase.times, 0.0);
+  }
+
+  WriteResults(StringUtils::Format(BENCHMARK_RESULTS, m_suite), results);
+
+  const std::string baselinePath = StringUtils::Format(BENCHMARK_BASELINE, m_suite);
+  if (updateBaseline)
+  {
+    CLog::Log(LOGINFO, "CBenchmark: stored the results of {} as the baseline", m_suite);
+    return WriteResults(baselinePath, results);
+  }
+
+  XFILE::CFile file;
+  std::vector<uint8_t> buffer;
+  CVariant baseline;
+  if (file.LoadFile(baselinePath, buffer) <= 0 ||
+      !CJSONVariantParser::Parse(std::string(buffer.begin(), buffer.end()), baseline))
+  {
+    CLog::Log(LOGINFO, "CBenchmark: no baseline of {} to compare with", m_suite);
+    return true;
+  }
+
+  bool success = true;
+  for (const auto& benchmarkCase : m_cases)
+  {
+    if (!baseline.isMember(benchmarkCase.name))
+      continue;
+
+    const auto regressed = [](double time, double before) {
+      return time > before * (1 + BENCHMARK_TOLERANCE) && time - before > BENCHMARK_NOISE_FLOOR;
+    };
+    const CVariant& result = results[benchmarkCase.name];
+    const CVariant& before = baseline[benchmarkCase.name];
+    const double median = result["median"].asDouble();
+    const double p95 = result["p95"].asDouble();
+    const bool medianRegressed = regressed(median, before["median"].asDouble());
+    const bool p95Regressed = regressed(p95, before["p95"].asDouble());
+    CLog::Log(medianRegressed || p95Regressed ? LOGWARNING : LOGINFO,
+              "CBenchmark: {}: median {:.3f} ms{}, baseline {:.3f} ms; p95 {:.3f} ms{}, baseline "
+              "{:.3f} ms",
+              benchmarkCase.name, median, medianRegressed ? " regressed" : "",
+              before["median"].asDouble(), p95, p95Regressed ? " regressed" : "",
+              before["p95"].asDouble());
+    success &= !medianRegressed && !p95Regressed;
+  }
+  return success;
+}
@@ -0,0 +1,73 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+/*!
+ \brief Repeatable timings of hot code paths, compared with a stored baseline.
+
+ The cases of a suite work on made-up data that is the same on every run (see CSyntheticLibrary).
+ Each case runs once to warm up and then a number of times. Its median, 95th percentile and
+ fastest time are written to special://temp/benchmark-<suite>.json. A case is reported as a
+ regression if its median is slower by more than the tolerance than in
+ special://profile/benchmark-<suite>-baseline.json.
+
+ Suites are run in the background with the Benchmark(suite[,scale][,update]) builtin of a
+ profiler build, or on the build machine with tools/benchmark:
+ - core: sorting, strings, variants, urls, checksums, dates, charset conversion and GUI render
+   batching, on 10000 songs and 1000 movies per scale. The checksums and the draws of the
+   batches are first checked against known answers.
+ - library: navigation queries of the music and video databases, on the same songs and movies.
+   They are added to databases of their own, MyMusicBenchmark<scale>x and MyVideosBenchmark<scale>x,
+   which are kept for later runs. Only in the application, see BenchmarkLibrary.cpp.
+ */
+class CBenchmark
+{
+public:
+  /*!
+   \brief Run a suite and compare it with its baseline
+   \param scale multiplies the size of the data.
+   \param updateBaseline store the results as the new baseline.
+   \return false if the suite is unknown, or a case got slower than in the baseline.
+   */
+  static bool RunSuite(const std::string& suite, unsigned int scale, bool updateBaseline);
+
+private:
+  explicit CBenchmark(const std::string& suite) : m_suite(suite) {}
+
+  struct Case
+  {
+    std::string name;
+    std::vector<double> times; ///< in ms
+  };
+
+  /*!
+   \brief Time a case
+   \param setup if set, called before each run of the case without being timed.
+   */
+  void Run(const std::string& name,
+           unsigned int runs,
+           const std::function<void()>& function,
+           const std::function<void()>& setup = nullptr);
+
+  /*!
+   \brief Check what the core suite times against known answers
+   \return false if a result is wrong, timing it would be pointless.
+   */
+  bool CheckCore() const;
+  void RunCore(unsigned int scale);
+  bool RunLibrary(unsigned int scale); ///< in BenchmarkLibrary.cpp
+  bool Finish(bool updateBaseline) const;
+
+  std::string m_suite;
+  std::vector<Case> m_cases;
+};
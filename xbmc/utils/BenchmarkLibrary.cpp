@@ -0,0 +1,215 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+// The library suite of CBenchmark. It works on the databases of the application and is only built
+// into it, with the profiler.
+
+#include "Benchmark.h"
+
+#include "DatabaseManager.h"
+#include "FileItem.h"
+#include "ServiceBroker.h"
+#include "music/MusicDatabase.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
+#include "utils/StringUtils.h"
+#include "utils/SyntheticLibrary.h"
+#include "utils/URIUtils.h"
+#include "utils/log.h"
+#include "video/VideoDatabase.h"
+
+#include <memory>
+
+namespace
+{
+bool OpenDatabase(CDatabase& db,
+                  DatabaseSettings settings,
+                  const std::string& name,
+                  bool recreate = false)
+{
+  // never the library of the user, whatever the database settings
+  settings.name = name;
+  if (!CServiceBroker::GetDatabaseManager().UpdateSeparateDatabase(db, settings, recreate))
+  {
+    CLog::Log(LOGERROR, "CBenchmark: unable to open database {}", name);
+    return false;
+  }
+  return true;
+}
+
+/*! \brief Add songs to a music database an album at a time, as the music scanner does */
+bool AddSongs(CMusicDatabase& db, const std::vector<CSyntheticLibrary::Song>& songs)
+{
+  const int idSource = db.AddSource("Synthetic music", "smb://nas/music/", {"smb://nas/music/"});
+  if (idSource < 0)
+    return false;
+
+  // the songs of an album follow each other, in the folder of the album
+  for (auto song = songs.begin(); song != songs.end();)
+  {
+    CAlbum album;
+    album.strAlbum = song->album;
+    album.artistCredits.emplace_back(song->albumArtist);
+    album.genre = {song->genre};
+    album.strReleaseDate = std::to_string(song->year);
+    album.strPath = URIUtils::GetDirectory(song->path);
+    for (; song != songs.end() && URIUtils::GetDirectory(song->path) == album.strPath; ++song)
+    {
+      CSong item;
+      item.strTitle = song->title;
+      item.strFileName = song->path;
+      for (const auto& artist : StringUtils::Split(song->artist, " feat. "))
+        item.artistCredits.emplace_back(artist);
+      item.genre = {song->genre};
+      item.iTrack = song->track;
+      item.iDuration = song->duration;
+      item.strReleaseDate = std::to_string(song->year);
+      item.dateAdded.SetFromDBDateTime(song->dateAdded);
+      item.dateNew = item.dateAdded;
+      album.songs.push_back(std::move(item));
+    }
+
+    if (!db.AddAlbum(album, idSource))
+      return false;
+  }
+  return true;
+}
+
+bool AddMovies(CVideoDatabase& db, const std::vector<CSyntheticLibrary::Movie>& movies)
+{
+  for (const auto& movie : movies)
+  {
+    CVideoInfoTag tag;
+    tag.SetTitle(movie.title);
+    tag.SetPlot(movie.plot);
+    tag.SetGenre(movie.genres);
+    tag.SetDirector({movie.director});
+    tag.SetYear(movie.year);
+    tag.SetRating(movie.rating);
+    tag.m_duration = movie.runtime;
+    tag.m_basePath = movie.path;
+    tag.m_strPath = movie.path;
+    tag.m_strFileNameAndPath = movie.path + movie.file;
+    tag.m_dateAdded.SetFromDBDateTime(movie.dateAdded);
+    if (db.SetDetailsForMovie(tag, {}) < 0)
+      return false;
+  }
+  return true;
+}
+} // namespace
+
+bool CBenchmark::RunLibrary(unsigned int scale)
+{
+  CSyntheticLibrary library;
+  const std::vector<CSyntheticLibrary::Song> songs = library.GetSongs(10000 * scale);
+  const std::vector<CSyntheticLibrary::Movie> movies = library.GetMovies(1000 * scale);
+
+  const std::shared_ptr<CAdvancedSettings> advancedSettings =
+      CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
+  const std::string musicName = StringUtils::Format("MyMusicBenchmark{}x", scale);
+  const std::string videoName = StringUtils::Format("MyVideosBenchmark{}x", scale);
+  CMusicDatabase musicdatabase;
+  CVideoDatabase videodatabase;
+  if (!OpenDatabase(musicdatabase, advancedSettings->m_databaseMusic, musicName) ||
+      !OpenDatabase(videodatabase, advancedSettings->m_databaseVideo, videoName))
+    return false;
+
+  // not the library, nobody is to be told about what is added to it
+  musicdatabase.SetAnnounceChanges(false);
+
+  // the databases are filled on the first run, adding to them takes much longer than the queries.
+  // One left incomplete or made from another synthetic library is recreated.
+  const int songCount = musicdatabase.GetSingleValueInt("SELECT COUNT(1) FROM song");
+  const int movieCount = videodatabase.GetSingleValueInt("SELECT COUNT(1) FROM movie");
+  if (songCount != static_cast<int>(songs.size()))
+  {
+    CLog::Log(LOGINFO, "CBenchmark: adding {} songs to the benchmark database, it has {}",
+              songs.size(), songCount);
+    if ((songCount != 0 &&
+         !OpenDatabase(musicdatabase, advancedSettings->m_databaseMusic, musicName, true)) ||
+        !AddSongs(musicdatabase, songs))
+    {
+      CLog::Log(LOGERROR, "CBenchmark: unable to add the songs");
+      return false;
+    }
+  }
+  if (movieCount != static_cast<int>(movies.size()))
+  {
+    CLog::Log(LOGINFO, "CBenchmark: adding {} movies to the benchmark database, it has {}",
+              movies.size(), movieCount);
+    if ((movieCount != 0 &&
+         !OpenDatabase(videodatabase, advancedSettings->m_databaseVideo, videoName, true)) ||
+        !AddMovies(videodatabase, movies))
+    {
+      CLog::Log(LOGERROR, "CBenchmark: unable to add the movies");
+      return false;
+    }
+  }
+
+  const int artists = musicdatabase.GetSingleValueInt("SELECT MAX(idArtist) FROM artist");
+  const int albums = musicdatabase.GetSingleValueInt("SELECT MAX(idAlbum) FROM album");
+  const int genres = videodatabase.GetSingleValueInt("SELECT MAX(genre_id) FROM genre");
+  if (artists <= 0 || albums <= 0 || genres <= 0)
+  {
+    CLog::Log(LOGERROR, "CBenchmark: the benchmark databases are empty");
+    return false;
+  }
+
+  // cases on a single artist, album or genre go through them in the same order on every run
+  CFileItemList items;
+  int id = 0;
+  const auto next = [&items, &id](int count) {
+    items.Clear();
+    id = id % count + 1;
+  };
+  const auto clear = [&items]() { items.Clear(); };
+
+  Run("CMusicDatabase::GetArtistsNav", 10,
+      [&]() { musicdatabase.GetArtistsNav("musicdb://artists/", items, true); }, clear);
+  Run("CMusicDatabase::GetAlbumsNav", 10,
+      [&]() { musicdatabase.GetAlbumsNav("musicdb://albums/", items); }, clear);
+  Run("CMusicDatabase::GetAlbumsNav of an artist", 50,
+      [&]() { musicdatabase.GetAlbumsNav("musicdb://albums/", items, -1, id); },
+      [&]() { next(artists); });
+  Run("CMusicDatabase::GetGenresNav", 20,
+      [&]() { musicdatabase.GetGenresNav("musicdb://genres/", items); }, clear);
+  Run("CMusicDatabase::GetSongsFullByWhere", 5, [&]() {
+    musicdatabase.GetSongsFullByWhere("musicdb://songs/", CDatabase::Filter(), items);
+  }, clear);
+
+  CDatabase::Filter filter;
+  Run("CMusicDatabase::GetSongsFullByWhere of an album", 50,
+      [&]() { musicdatabase.GetSongsFullByWhere("musicdb://songs/", filter, items); },
+      [&]() {
+        next(albums);
+        filter.where = musicdatabase.PrepareSQL("songview.idAlbum = %i", id);
+      });
+
+  Run("CMusicDatabase::GetRecentlyAddedAlbums", 20, [&]() {
+    VECALBUMS recent;
+    musicdatabase.GetRecentlyAddedAlbums(recent, 25);
+  });
+
+  Run("CVideoDatabase::GetMoviesNav", 10,
+      [&]() { videodatabase.GetMoviesNav("videodb://movies/titles/", items); }, clear);
+  Run("CVideoDatabase::GetMoviesNav of a genre", 20,
+      [&]() { videodatabase.GetMoviesNav("videodb://movies/titles/", items, id); },
+      [&]() { next(genres); });
+  Run("CVideoDatabase::GetGenresNav", 20, [&]() {
+    videodatabase.GetGenresNav("videodb://movies/genres/", items, VideoDbContentType::MOVIES);
+  }, clear);
+  Run("CVideoDatabase::GetYearsNav", 20, [&]() {
+    videodatabase.GetYearsNav("videodb://movies/years/", items, VideoDbContentType::MOVIES);
+  }, clear);
+  Run("CVideoDatabase::GetRecentlyAddedMoviesNav", 20, [&]() {
+    videodatabase.GetRecentlyAddedMoviesNav("videodb://recentlyaddedmovies/", items, 25);
+  }, clear);
+
+  CLog::Log(LOGDEBUG, "CBenchmark: library suite done ({} items)", items.Size());
+  return true;
+}
@@ -18,7 +18,10 @@
 #include "utils/Utf8Utils.h"
 
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <mutex>
+#include <type_traits>
 
 #include <fribidi.h>
 #include <iconv.h>
@@ -265,6 +268,229 @@ enum StdConversionType /* Keep it in sync with CCharsetConverter::CInnerConverte
 
 /* We don't want to pollute header file with many additional includes and definitions, so put
    here all staff that require usage of types defined in this file or in additional headers */
+namespace
+{
+/*!
+ \brief Length of the leading pure ASCII part of str, checked a word at a time
+ */
+size_t AsciiPrefixLength(const char* str, size_t length)
+{
+  constexpr uint64_t highBits = 0x8080808080808080ULL;
+
+  size_t pos = 0;
+  for (; pos + sizeof(uint64_t) <= length; pos += sizeof(uint64_t))
+  {
+    uint64_t word;
+    memcpy(&word, str + pos, sizeof(word)); // unaligned read
+    if (word & highBits)
+      break;
+  }
+  while (pos < length && static_cast<unsigned char>(str[pos]) < 0x80)
+    pos++;
+
+  return pos;
+}
+
+bool IsValidCodePoint(char32_t cp)
+{
+  return cp <= 0x10FFFF && (cp < 0xD800 || cp > 0xDFFF);
+}
+
+/*!
+ \brief Read the next code point from a UTF-8, UTF-16 or UTF-32 (wide) string
+ \return false if the input at pos is invalid, pos is then advanced by one code unit
+ */
+bool NextCodePoint(const std::string& str, size_t& pos, char32_t& cp)
+{
+  const unsigned char lead = static_cast<unsigned char>(str[pos]);
+  size_t length;
+  char32_t minimum;
+  if (lead < 0x80)
+  {
+    cp = lead;
+    pos++;
+    return true;
+  }
+  else if (lead >= 0xC2 && lead <= 0xDF)
+  {
+    length = 2;
+    minimum = 0x80;
+    cp = lead & 0x1F;
+  }
+  else if ((lead & 0xF0) == 0xE0)
+  {
+    length = 3;
+    minimum = 0x800;
+    cp = lead & 0x0F;
+  }
+  else if (lead >= 0xF0 && lead <= 0xF4)
+  {
+    length = 4;
+    minimum = 0x10000;
+    cp = lead & 0x07;
+  }
+  else
+  {
+    pos++;
+    return false;
+  }
+
+  if (pos + length > str.size())
+  {
+    pos++;
+    return false;
+  }
+
+  for (size_t i = 1; i < length; i++)
+  {
+    const unsigned char trail = static_cast<unsigned char>(str[pos + i]);
+    if ((trail & 0xC0) != 0x80)
+    {
+      pos++;
+      return false;
+    }
+    cp = (cp << 6) | (trail & 0x3F);
+  }
+
+  if (cp < minimum || !IsValidCodePoint(cp))
+  {
+    pos++;
+    return false;
+  }
+
+  pos += length;
+  return true;
+}
+
+bool NextCodePoint(const std::u32string& str, size_t& pos, char32_t& cp)
+{
+  cp = str[pos++];
+  return IsValidCodePoint(cp);
+}
+
+bool NextCodePoint(const std::wstring& str, size_t& pos, char32_t& cp)
+{
+  if constexpr (sizeof(wchar_t) == 2)
+  {
+    const char32_t unit = static_cast<char16_t>(str[pos++]);
+    if (unit < 0xD800 || unit > 0xDFFF)
+    {
+      cp = unit;
+      return true;
+    }
+    if (unit > 0xDBFF || pos >= str.size())
+      return false;
+
+    const char32_t low = static_cast<char16_t>(str[pos]);
+    if (low < 0xDC00 || low > 0xDFFF)
+      return false;
+
+    pos++;
+    cp = 0x10000 + ((unit - 0xD800) << 10) + (low - 0xDC00);
+    return true;
+  }
+  else
+  {
+    cp = static_cast<char32_t>(str[pos++]);
+    return IsValidCodePoint(cp);
+  }
+}
+
+void AppendCodePoint(std::string& str, char32_t cp)
+{
+  if (cp < 0x80)
+    str.push_back(static_cast<char>(cp));
+  else if (cp < 0x800)
+  {
+    str.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+    str.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+  }
+  else if (cp < 0x10000)
+  {
+    str.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+    str.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+    str.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+  }
+  else
+  {
+    str.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+    str.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+    str.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+    str.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+  }
+}
+
+void AppendCodePoint(std::u32string& str, char32_t cp)
+{
+  str.push_back(cp);
+}
+
+void AppendCodePoint(std::wstring& str, char32_t cp)
+{
+  if (sizeof(wchar_t) == 2 && cp >= 0x10000)
+  {
+    cp -= 0x10000;
+    str.push_back(static_cast<wchar_t>(0xD800 + (cp >> 10)));
+    str.push_back(static_cast<wchar_t>(0xDC00 + (cp & 0x3FF)));
+  }
+  else
+    str.push_back(static_cast<wchar_t>(cp));
+}
+
+/*!
+ \brief Convert between UTF-8, UTF-32 and wide strings without iconv
+ Invalid input is skipped one code unit at a time, like the iconv based conversion does.
+ */
+template<class INPUT, class OUTPUT>
+bool NativeConvert(const INPUT& strSource, OUTPUT& strDest, bool failOnInvalidChar)
+{
+  strDest.clear();
+  if (strSource.empty())
+    return true;
+
+  size_t pos = 0;
+  if constexpr (std::is_same_v<INPUT, std::string>)
+  {
+    // most labels are pure ASCII, which maps 1:1 to any of the unicode forms
+    pos = AsciiPrefixLength(strSource.data(), strSource.size());
+    strDest.assign(strSource.begin(), strSource.begin() + pos);
+    if (pos == strSource.size())
+      return true;
+  }
+
+  strDest.reserve(strSource.size());
+  char32_t cp;
+  while (pos < strSource.size())
+  {
+    if (NextCodePoint(strSource, pos, cp))
+      AppendCodePoint(strDest, cp);
+    else if (failOnInvalidChar)
+    {
+      strDest.clear();
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/*!
+ \brief Check if reordering by fribidi could change the string
+ Text that consists only of code points below the Hebrew block that fribidi doesn't strip
+ (explicit marks and boundary neutrals) is always displayed in logical order.
+ */
+bool NeedsBidiReordering(const std::u32string& str)
+{
+  for (const char32_t cp : str)
+  {
+    if (cp >= 0x0590 || cp == 0x00AD || cp < 0x09 || (cp >= 0x0E && cp < 0x20) ||
+        (cp >= 0x7F && cp < 0xA0))
+      return true;
+  }
+  return false;
+}
+} // namespace
+
 class CCharsetConverter::CInnerConverter
 {
 public:
@@ -278,6 +504,8 @@ public:
   template<class INPUT,class OUTPUT>
   static bool stdConvert(StdConversionType convertType, const INPUT& strSource, OUTPUT& strDest, bool failOnInvalidChar = false);
   template<class INPUT,class OUTPUT>
+  static bool unicodeConvert(StdConversionType convertType, const INPUT& strSource, OUTPUT& strDest, bool failOnInvalidChar = false);
+  template<class INPUT,class OUTPUT>
   static bool customConvert(const std::string& sourceCharset, const std::string& targetCharset, const INPUT& strSource, OUTPUT& strDest, bool failOnInvalidChar = false);
 
   template<class INPUT,class OUTPUT>
@@ -332,6 +560,20 @@ bool CCharsetConverter::CInnerConverter::stdConvert(StdConversionType convertTyp
   return convert(convType.GetConverter(converterLock), convType.GetTargetSingleCharMaxLen(), strSource, strDest, failOnInvalidChar);
 }
 
+template<class INPUT,class OUTPUT>
+bool CCharsetConverter::CInnerConverter::unicodeConvert([[maybe_unused]] StdConversionType convertType, const INPUT& strSource, OUTPUT& strDest, bool failOnInvalidChar /*= false*/)
+{
+#if defined(TARGET_DARWIN)
+  // UTF-8-MAC input may need normalization, leave anything but ASCII to iconv
+  if constexpr (std::is_same_v<INPUT, std::string>)
+  {
+    if (AsciiPrefixLength(strSource.data(), strSource.size()) != strSource.size())
+      return stdConvert(convertType, strSource, strDest, failOnInvalidChar);
+  }
+#endif
+  return NativeConvert(strSource, strDest, failOnInvalidChar);
+}
+
 template<class INPUT,class OUTPUT>
 bool CCharsetConverter::CInnerConverter::customConvert(const std::string& sourceCharset, const std::string& targetCharset, const INPUT& strSource, OUTPUT& strDest, bool failOnInvalidChar /*= false*/)
 {
@@ -485,6 +727,18 @@ bool CCharsetConverter::CInnerConverter::logicalToVisualBiDi(
   if (srcLen == 0)
     return true;
 
+  // text without any right-to-left or stripped characters stays as is, don't bother fribidi
+  if (!NeedsBidiReordering(stringSrc))
+  {
+    stringDst = stringSrc;
+    if (visualToLogicalMap)
+    {
+      for (size_t i = 0; i < srcLen; i++)
+        visualToLogicalMap[i] = static_cast<int>(i);
+    }
+    return true;
+  }
+
   stringDst.reserve(srcLen);
   size_t lineStart = 0;
 
@@ -540,10 +794,14 @@ bool CCharsetConverter::CInnerConverter::logicalToVisualBiDi(
 bool CCharsetConverter::CInnerConverter::isBidiDirectionRTL(const std::string& str)
 {
   std::u32string converted;
-  if (!CInnerConverter::stdConvert(Utf8ToUtf32, str, converted, true))
+  if (!CInnerConverter::unicodeConvert(Utf8ToUtf32, str, converted, true))
+    return false;
+
+  // a right-to-left paragraph needs a strong right-to-left character
+  if (!NeedsBidiReordering(converted))
     return false;
 
-  int lineLen = static_cast<int>(str.size());
+  int lineLen = static_cast<int>(converted.size());
   FriBidiCharType* charTypes = new FriBidiCharType[lineLen];
   fribidi_get_bidi_types(reinterpret_cast<const FriBidiChar*>(converted.c_str()),
                          (FriBidiStrIndex)lineLen, charTypes);
@@ -665,7 +923,7 @@ void CCharsetConverter::reinitCharsetsFromSettings(void)
 
 bool CCharsetConverter::utf8ToUtf32(const std::string& utf8StringSrc, std::u32string& utf32StringDst, bool failOnBadChar /*= true*/)
 {
-  return CInnerConverter::stdConvert(Utf8ToUtf32, utf8StringSrc, utf32StringDst, failOnBadChar);
+  return CInnerConverter::unicodeConvert(Utf8ToUtf32, utf8StringSrc, utf32StringDst, failOnBadChar);
 }
 
 std::u32string CCharsetConverter::utf8ToUtf32(const std::string& utf8StringSrc, bool failOnBadChar /*= true*/)
@@ -680,17 +938,17 @@ bool CCharsetConverter::utf8ToUtf32Visual(const std::string& utf8StringSrc, std:
   if (bVisualBiDiFlip)
   {
     std::u32string converted;
-    if (!CInnerConverter::stdConvert(Utf8ToUtf32, utf8StringSrc, converted, failOnBadChar))
+    if (!CInnerConverter::unicodeConvert(Utf8ToUtf32, utf8StringSrc, converted, failOnBadChar))
       return false;
 
     return CInnerConverter::logicalToVisualBiDi(converted, utf32StringDst, forceLTRReadingOrder ? FRIBIDI_TYPE_LTR : FRIBIDI_TYPE_PDF, failOnBadChar);
   }
-  return CInnerConverter::stdConvert(Utf8ToUtf32, utf8StringSrc, utf32StringDst, failOnBadChar);
+  return CInnerConverter::unicodeConvert(Utf8ToUtf32, utf8StringSrc, utf32StringDst, failOnBadChar);
 }
 
 bool CCharsetConverter::utf32ToUtf8(const std::u32string& utf32StringSrc, std::string& utf8StringDst, bool failOnBadChar /*= true*/)
 {
-  return CInnerConverter::stdConvert(Utf32ToUtf8, utf32StringSrc, utf8StringDst, failOnBadChar);
+  return CInnerConverter::unicodeConvert(Utf32ToUtf8, utf32StringSrc, utf8StringDst, failOnBadChar);
 }
 
 std::string CCharsetConverter::utf32ToUtf8(const std::u32string& utf32StringSrc, bool failOnBadChar /*= false*/)
@@ -706,7 +964,7 @@ bool CCharsetConverter::utf32ToW(const std::u32string& utf32StringSrc, std::wstr
   wStringDst.assign((const wchar_t*)utf32StringSrc.c_str(), utf32StringSrc.length());
   return true;
 #else // !WCHAR_IS_UCS_4
-  return CInnerConverter::stdConvert(Utf32ToW, utf32StringSrc, wStringDst, failOnBadChar);
+  return CInnerConverter::unicodeConvert(Utf32ToW, utf32StringSrc, wStringDst, failOnBadChar);
 #endif // !WCHAR_IS_UCS_4
 }
 
@@ -727,7 +985,7 @@ bool CCharsetConverter::wToUtf32(const std::wstring& wStringSrc, std::u32string&
   /* UCS-4 is almost equal to UTF-32, but UTF-32 has strict limits on possible values, while UCS-4 is usually unchecked.
    * With this "conversion" we ensure that output will be valid UTF-32 string. */
 #endif
-  return CInnerConverter::stdConvert(WToUtf32, wStringSrc, utf32StringDst, failOnBadChar);
+  return CInnerConverter::unicodeConvert(WToUtf32, wStringSrc, utf32StringDst, failOnBadChar);
 }
 
 // The bVisualBiDiFlip forces a flip of characters for hebrew/arabic languages, only set to false if the flipping
@@ -740,16 +998,16 @@ bool CCharsetConverter::utf8ToW(const std::string& utf8StringSrc, std::wstring&
   {
     wStringDst.clear();
     std::u32string utf32str;
-    if (!CInnerConverter::stdConvert(Utf8ToUtf32, utf8StringSrc, utf32str, failOnBadChar))
+    if (!CInnerConverter::unicodeConvert(Utf8ToUtf32, utf8StringSrc, utf32str, failOnBadChar))
       return false;
 
     std::u32string utf32flipped;
     const bool bidiResult = CInnerConverter::logicalToVisualBiDi(utf32str, utf32flipped, forceLTRReadingOrder ? FRIBIDI_TYPE_LTR : FRIBIDI_TYPE_PDF, failOnBadChar);
 
-    return CInnerConverter::stdConvert(Utf32ToW, utf32flipped, wStringDst, failOnBadChar) && bidiResult;
+    return CInnerConverter::unicodeConvert(Utf32ToW, utf32flipped, wStringDst, failOnBadChar) && bidiResult;
   }
 
-  return CInnerConverter::stdConvert(Utf8toW, utf8StringSrc, wStringDst, failOnBadChar);
+  return CInnerConverter::unicodeConvert(Utf8toW, utf8StringSrc, wStringDst, failOnBadChar);
 }
 
 bool CCharsetConverter::subtitleCharsetToUtf8(const std::string& stringSrc, std::string& utf8StringDst)
@@ -831,7 +1089,7 @@ bool CCharsetConverter::unknownToUTF8(const std::string& stringSrc, std::string&
 
 bool CCharsetConverter::wToUTF8(const std::wstring& wStringSrc, std::string& utf8StringDst, bool failOnBadChar /*= false*/)
 {
-  return CInnerConverter::stdConvert(WtoUtf8, wStringSrc, utf8StringDst, failOnBadChar);
+  return CInnerConverter::unicodeConvert(WtoUtf8, wStringSrc, utf8StringDst, failOnBadChar);
 }
 
 bool CCharsetConverter::utf16BEtoUTF8(const std::u16string& utf16StringSrc, std::string& utf8StringDst)
@@ -888,7 +1146,7 @@ bool CCharsetConverter::utf8logicalToVisualBiDi(const std::string& utf8StringSrc
   if (!utf8ToUtf32Visual(utf8StringSrc, utf32flipped, true, true, failOnBadString))
     return false;
 
-  return CInnerConverter::stdConvert(Utf32ToUtf8, utf32flipped, utf8StringDst, failOnBadString);
+  return CInnerConverter::unicodeConvert(Utf32ToUtf8, utf32flipped, utf8StringDst, failOnBadString);
 }
 
 bool CCharsetConverter::utf8IsRTLBidiDirection(const std::string& utf8String)
@@ -10,7 +10,11 @@
 
 #include "utils/StringUtils.h"
 
-uint32_t  crc_tab[256] =
+#include <algorithm>
+
+namespace
+{
+constexpr uint32_t crc_tab[256] =
 {
  0x00000000L, 0x04C11DB7L, 0x09823B6EL, 0x0D4326D9L,
  0x130476DCL, 0x17C56B6BL, 0x1A864DB2L, 0x1E475005L,
@@ -78,6 +82,31 @@ uint32_t  crc_tab[256] =
  0xBCB4666DL, 0xB8757BDAL, 0xB5365D03L, 0xB1F740B4L
 };
 
+struct SliceTables
+{
+  uint32_t table[8][256];
+};
+
+// table[k][b] is the CRC of byte b followed by k zero bytes, crc_tab being table[0]
+constexpr SliceTables MakeSliceTables()
+{
+  SliceTables slices = {};
+  for (int i = 0; i < 256; ++i)
+    slices.table[0][i] = crc_tab[i];
+  for (int k = 1; k < 8; ++k)
+  {
+    for (int i = 0; i < 256; ++i)
+    {
+      const uint32_t crc = slices.table[k - 1][i];
+      slices.table[k][i] = (crc << 8) ^ crc_tab[crc >> 24];
+    }
+  }
+  return slices;
+}
+
+constexpr SliceTables crc_slices = MakeSliceTables();
+} // namespace
+
 Crc32::Crc32()
 {
   Reset();
@@ -90,8 +119,23 @@ void Crc32::Reset()
 
 void Crc32::Compute(const char* buffer, size_t count)
 {
-   while (count--)
-      m_crc = (m_crc << 8) ^ crc_tab[((m_crc >> 24) ^ *buffer++) & 0xFF];
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(buffer);
+  const auto& t = crc_slices.table;
+  uint32_t crc = m_crc;
+
+  // slicing-by-8, a lookup per byte of 8 bytes at a time instead of a dependent one per byte
+  for (; count >= 8; count -= 8, data += 8)
+  {
+    const uint32_t high = crc ^ (static_cast<uint32_t>(data[0]) << 24 |
+                                 static_cast<uint32_t>(data[1]) << 16 |
+                                 static_cast<uint32_t>(data[2]) << 8 | data[3]);
+    crc = t[7][high >> 24] ^ t[6][(high >> 16) & 0xFF] ^ t[5][(high >> 8) & 0xFF] ^
+          t[4][high & 0xFF] ^ t[3][data[4]] ^ t[2][data[5]] ^ t[1][data[6]] ^ t[0][data[7]];
+  }
+
+  while (count--)
+    crc = (crc << 8) ^ crc_tab[((crc >> 24) ^ *data++) & 0xFF];
+  m_crc = crc;
 }
 
 uint32_t Crc32::Compute(const std::string& strValue)
@@ -103,8 +147,30 @@ uint32_t Crc32::Compute(const std::string& strValue)
 
 uint32_t Crc32::ComputeFromLowerCase(const std::string& strValue)
 {
-  std::string strLower = strValue;
-  StringUtils::ToLower(strLower);
-  return Compute(strLower);
+  // ASCII is lowercased a block at a time on the stack, without a copy of the whole string
+  Crc32 crc;
+  char block[64];
+  for (size_t pos = 0; pos < strValue.size(); pos += sizeof(block))
+  {
+    const size_t count = std::min(sizeof(block), strValue.size() - pos);
+    unsigned char bits = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+      const unsigned char c = static_cast<unsigned char>(strValue[pos + i]);
+      bits |= c;
+      block[i] = static_cast<char>(c | (static_cast<unsigned char>(c - 'A') < 26) << 5);
+    }
+
+    // leave other characters to tolower()
+    if (bits & 0x80)
+    {
+      std::string strLower = strValue;
+      StringUtils::ToLower(strLower);
+      return Compute(strLower);
+    }
+
+    crc.Compute(block, count);
+  }
+  return crc;
 }
 
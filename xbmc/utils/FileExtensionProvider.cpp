@@ -17,9 +17,11 @@
 #include "addons/addoninfo/AddonType.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/SettingsComponent.h"
+#include "utils/FileExtensionSet.h"
 #include "utils/URIUtils.h"
 #include "utils/StringUtils.h"
 
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -97,6 +99,99 @@ std::string CFileExtensionProvider::GetFileFolderExtensions() const
   return extensions;
 }
 
+std::shared_ptr<const CFileExtensionSet> CFileExtensionProvider::GetPictureExtensionSet() const
+{
+  return GetExtensionSet(ExtensionSet::PICTURE);
+}
+
+std::shared_ptr<const CFileExtensionSet> CFileExtensionProvider::GetMusicExtensionSet() const
+{
+  return GetExtensionSet(ExtensionSet::MUSIC);
+}
+
+std::shared_ptr<const CFileExtensionSet> CFileExtensionProvider::GetVideoExtensionSet() const
+{
+  return GetExtensionSet(ExtensionSet::VIDEO);
+}
+
+std::shared_ptr<const CFileExtensionSet> CFileExtensionProvider::GetSubtitleExtensionSet() const
+{
+  return GetExtensionSet(ExtensionSet::SUBTITLE);
+}
+
+std::shared_ptr<const CFileExtensionSet> CFileExtensionProvider::GetExtensionSet(
+    ExtensionSet set, unsigned int* generation /* = nullptr */) const
+{
+  const std::string* advancedExtensions = nullptr;
+  std::string (CFileExtensionProvider::*getExtensions)() const = nullptr;
+  switch (set)
+  {
+    case ExtensionSet::PICTURE:
+      advancedExtensions = &m_advancedSettings->m_pictureExtensions;
+      getExtensions = &CFileExtensionProvider::GetPictureExtensions;
+      break;
+    case ExtensionSet::MUSIC:
+      advancedExtensions = &m_advancedSettings->m_musicExtensions;
+      getExtensions = &CFileExtensionProvider::GetMusicExtensions;
+      break;
+    case ExtensionSet::VIDEO:
+      advancedExtensions = &m_advancedSettings->m_videoExtensions;
+      getExtensions = &CFileExtensionProvider::GetVideoExtensions;
+      break;
+    case ExtensionSet::SUBTITLE:
+      advancedExtensions = &m_advancedSettings->m_subtitlesExtensions;
+      getExtensions = &CFileExtensionProvider::GetSubtitleExtensions;
+      break;
+  }
+
+  CompiledExtensions& compiled = GetCompiledExtensions(set);
+  std::unique_lock<CCriticalSection> lock(m_critSection);
+
+  // add-on changes drop the compiled sets, advanced settings may be reloaded at any time
+  if (!compiled.extensions || compiled.advancedExtensions != *advancedExtensions)
+  {
+    const bool changed = compiled.extensions != nullptr;
+    compiled.advancedExtensions = *advancedExtensions;
+    compiled.extensions = std::make_shared<const CFileExtensionSet>((this->*getExtensions)());
+    // a dropped set was already given a new generation
+    if (changed)
+      compiled.Invalidate();
+  }
+
+  if (generation)
+    *generation = compiled.generation;
+  return compiled.extensions;
+}
+
+unsigned int CFileExtensionProvider::GetExtensionSetGeneration(ExtensionSet set) const
+{
+  return GetCompiledExtensions(set).generation;
+}
+
+CFileExtensionProvider::CompiledExtensions& CFileExtensionProvider::GetCompiledExtensions(
+    ExtensionSet set) const
+{
+  switch (set)
+  {
+    case ExtensionSet::PICTURE:
+      return m_pictureExtensionSet;
+    case ExtensionSet::MUSIC:
+      return m_musicExtensionSet;
+    case ExtensionSet::VIDEO:
+      return m_videoExtensionSet;
+    case ExtensionSet::SUBTITLE:
+    default:
+      return m_subtitleExtensionSet;
+  }
+}
+
+void CFileExtensionProvider::CompiledExtensions::Invalidate()
+{
+  // 0 is left to callers as the generation of nothing cached
+  if (++generation == 0)
+    ++generation;
+}
+
 bool CFileExtensionProvider::CanOperateExtension(const std::string& path) const
 {
   /*!
@@ -234,8 +329,27 @@ void CFileExtensionProvider::SetAddonExtensions(AddonType type)
     }
   }
 
+  std::unique_lock<CCriticalSection> lock(m_critSection);
+
   m_addonExtensions[type] = StringUtils::Join(extensions, "|");
   m_addonFileFolderExtensions[type] = StringUtils::Join(fileFolderExtensions, "|");
+
+  // only drop the sets the add-on type contributes to, see GetMusicExtensions() and friends
+  std::vector<CompiledExtensions*> dropped{&m_musicExtensionSet};
+  if (type == AddonType::VFS)
+    dropped = {&m_pictureExtensionSet, &m_musicExtensionSet, &m_videoExtensionSet,
+               &m_subtitleExtensionSet};
+  else if (type == AddonType::IMAGEDECODER)
+    dropped = {&m_pictureExtensionSet};
+
+  for (CompiledExtensions* compiled : dropped)
+  {
+    if (compiled->extensions)
+    {
+      compiled->extensions.reset();
+      compiled->Invalidate();
+    }
+  }
 }
 
 void CFileExtensionProvider::OnAddonEvent(const AddonEvent& event)
@@ -8,6 +8,9 @@
 
 #pragma once
 
+#include "threads/CriticalSection.h"
+
+#include <atomic>
 #include <map>
 #include <memory>
 #include <string>
@@ -21,10 +24,19 @@ struct AddonEvent;
 }
 
 class CAdvancedSettings;
+class CFileExtensionSet;
 
 class CFileExtensionProvider
 {
 public:
+  enum class ExtensionSet
+  {
+    PICTURE,
+    MUSIC,
+    VIDEO,
+    SUBTITLE,
+  };
+
   CFileExtensionProvider(ADDON::CAddonMgr& addonManager);
   ~CFileExtensionProvider();
 
@@ -58,6 +70,44 @@ public:
    */
   std::string GetFileFolderExtensions() const;
 
+  /*!
+   * @brief Returns the picture extensions compiled for fast lookups
+   */
+  std::shared_ptr<const CFileExtensionSet> GetPictureExtensionSet() const;
+
+  /*!
+   * @brief Returns the music extensions compiled for fast lookups
+   */
+  std::shared_ptr<const CFileExtensionSet> GetMusicExtensionSet() const;
+
+  /*!
+   * @brief Returns the video extensions compiled for fast lookups
+   */
+  std::shared_ptr<const CFileExtensionSet> GetVideoExtensionSet() const;
+
+  /*!
+   * @brief Returns the subtitle extensions compiled for fast lookups
+   */
+  std::shared_ptr<const CFileExtensionSet> GetSubtitleExtensionSet() const;
+
+  /*!
+   * @brief Returns the given extensions compiled for fast lookups
+   *
+   * @param set the extension list to compile
+   * @param[out] generation if not null, the generation of the returned set
+   */
+  std::shared_ptr<const CFileExtensionSet> GetExtensionSet(ExtensionSet set,
+                                                           unsigned int* generation = nullptr) const;
+
+  /*!
+   * @brief Returns a counter that changes whenever the given compiled extension set is rebuilt
+   * or dropped
+   *
+   * Allows callers to cache extension based classifications and drop them once add-ons or
+   * advanced settings change the list. Never 0, the generation of a set that was not compiled.
+   */
+  unsigned int GetExtensionSetGeneration(ExtensionSet set) const;
+
   /*!
    * @brief Returns whether a url protocol from add-ons use encoded hostnames
    */
@@ -78,6 +128,17 @@ private:
 
   void OnAddonEvent(const ADDON::AddonEvent& event);
 
+  struct CompiledExtensions
+  {
+    std::string advancedExtensions; ///< advanced settings part the set was compiled from
+    std::shared_ptr<const CFileExtensionSet> extensions;
+    std::atomic<unsigned int> generation{1};
+
+    void Invalidate();
+  };
+
+  CompiledExtensions& GetCompiledExtensions(ExtensionSet set) const;
+
   // Construction properties
   std::shared_ptr<CAdvancedSettings> m_advancedSettings;
   ADDON::CAddonMgr &m_addonManager;
@@ -88,4 +149,11 @@ private:
 
   // Protocols from add-ons with encoded host names
   std::vector<std::string> m_encoded;
+
+  // Compiled extension sets, rebuilt lazily after a change of the lists
+  mutable CCriticalSection m_critSection;
+  mutable CompiledExtensions m_pictureExtensionSet;
+  mutable CompiledExtensions m_musicExtensionSet;
+  mutable CompiledExtensions m_videoExtensionSet;
+  mutable CompiledExtensions m_subtitleExtensionSet;
 };
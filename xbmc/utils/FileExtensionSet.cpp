@@ -0,0 +1,62 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FileExtensionSet.h"
+
+#include "utils/StringUtils.h"
+
+#include <algorithm>
+#include <ctype.h>
+
+namespace
+{
+// Compares a lowercase set entry against a query of arbitrary case
+int CompareNoCase(std::string_view entry, std::string_view query)
+{
+  const size_t length = std::min(entry.size(), query.size());
+  for (size_t i = 0; i < length; ++i)
+  {
+    const unsigned char a = static_cast<unsigned char>(entry[i]);
+    const unsigned char b = static_cast<unsigned char>(::tolower(static_cast<unsigned char>(query[i])));
+    if (a != b)
+      return a < b ? -1 : 1;
+  }
+  if (entry.size() == query.size())
+    return 0;
+  return entry.size() < query.size() ? -1 : 1;
+}
+} // namespace
+
+CFileExtensionSet::CFileExtensionSet(const std::string& extensions) : m_source(extensions)
+{
+  for (const std::string& entry : StringUtils::Split(StringUtils::ToLower(extensions), '|'))
+  {
+    // an extension matches an entry if the entry ends with it, and extensions always start
+    // with a '.', so every '.' prefixed suffix of an entry is a possible match
+    for (size_t pos = entry.find('.'); pos != std::string::npos; pos = entry.find('.', pos + 1))
+    {
+      m_extensions.emplace_back(entry.substr(pos));
+      m_maxLength = std::max(m_maxLength, entry.size() - pos);
+    }
+  }
+
+  std::sort(m_extensions.begin(), m_extensions.end());
+  m_extensions.erase(std::unique(m_extensions.begin(), m_extensions.end()), m_extensions.end());
+}
+
+bool CFileExtensionSet::Contains(std::string_view extension) const
+{
+  if (extension.empty() || extension.size() > m_maxLength)
+    return false;
+
+  const auto it = std::lower_bound(m_extensions.begin(), m_extensions.end(), extension,
+                                   [](const std::string& entry, std::string_view query) {
+                                     return CompareNoCase(entry, query) < 0;
+                                   });
+  return it != m_extensions.end() && CompareNoCase(*it, extension) == 0;
+}
@@ -0,0 +1,47 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*!
+ \brief Precompiled form of a '|' separated extension list as used by URIUtils::HasExtension.
+
+ The list is lowercased, split and sorted once, so that lookups are a binary search over the
+ compiled entries without any string allocations. Matching follows the semantics of the
+ string based URIUtils::HasExtension: an extension matches when any list entry ends with it,
+ e.g. ".gz" matches an entry ".tar.gz".
+ */
+class CFileExtensionSet
+{
+public:
+  CFileExtensionSet() = default;
+  explicit CFileExtensionSet(const std::string& extensions);
+
+  /*!
+   \brief Check if the set contains the given extension.
+   \param extension '.' prefixed extension, e.g. ".mkv". The check is case insensitive.
+   \return true if any of the compiled list entries ends with the extension.
+   */
+  bool Contains(std::string_view extension) const;
+
+  bool IsEmpty() const { return m_extensions.empty(); }
+
+  /*!
+   \brief The list this set was compiled from.
+   */
+  const std::string& GetSource() const { return m_source; }
+
+private:
+  std::string m_source;
+  std::vector<std::string> m_extensions; ///< sorted, lowercase, unique
+  size_t m_maxLength = 0;
+};
@@ -0,0 +1,48 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "HostRateLimiter.h"
+
+#include "utils/XTimeUtils.h"
+
+#include <algorithm>
+#include <mutex>
+
+CHostRateLimiter::CHostRateLimiter(double rate, unsigned int burst)
+  : m_rate(rate), m_burst(std::max(burst, 1u))
+{
+}
+
+void CHostRateLimiter::Acquire(const std::string& host)
+{
+  if (host.empty() || m_rate <= 0)
+    return;
+
+  std::chrono::duration<double> wait{0};
+  {
+    std::unique_lock<CCriticalSection> lock(m_critSection);
+
+    const auto now = std::chrono::steady_clock::now();
+    auto it = m_buckets.find(host);
+    if (it == m_buckets.end())
+      it = m_buckets.insert(std::make_pair(host, Bucket{m_burst, now})).first;
+
+    Bucket& bucket = it->second;
+    const std::chrono::duration<double> elapsed = now - bucket.updated;
+    bucket.tokens = std::min(m_burst, bucket.tokens + elapsed.count() * m_rate);
+    bucket.updated = now;
+
+    // take the token now, a negative balance is paid off by waiting
+    bucket.tokens -= 1;
+    if (bucket.tokens < 0)
+      wait = std::chrono::duration<double>(-bucket.tokens / m_rate);
+  }
+
+  if (wait.count() > 0)
+    KODI::TIME::Sleep(std::chrono::duration_cast<std::chrono::milliseconds>(wait));
+}
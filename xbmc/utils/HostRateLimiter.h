@@ -0,0 +1,49 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/CriticalSection.h"
+
+#include <chrono>
+#include <map>
+#include <string>
+
+/*!
+ \brief Limits the rate of requests made to each host with a token bucket.
+
+ Every host gets a bucket holding up to \p burst tokens, refilled at \p rate tokens per second.
+ A request takes a token, and waits for the next one to be refilled if the bucket is empty.
+ Waiting requests reserve their token up front, so they are served in the order they came in.
+ */
+class CHostRateLimiter
+{
+public:
+  CHostRateLimiter(double rate, unsigned int burst);
+
+  /*!
+   \brief Wait until a request to the given host is allowed
+   \param host the host name, requests without one are never limited
+   */
+  void Acquire(const std::string& host);
+
+private:
+  CHostRateLimiter(const CHostRateLimiter&) = delete;
+  CHostRateLimiter& operator=(const CHostRateLimiter&) = delete;
+
+  struct Bucket
+  {
+    double tokens; ///< negative when requests are waiting for theirs
+    std::chrono::steady_clock::time_point updated;
+  };
+
+  const double m_rate;
+  const double m_burst;
+  CCriticalSection m_critSection;
+  std::map<std::string, Bucket> m_buckets;
+};
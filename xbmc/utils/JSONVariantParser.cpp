@@ -8,199 +8,426 @@
 
 #include "JSONVariantParser.h"
 
-#include <nlohmann/json.hpp>
+#include "utils/Utf8Utils.h"
 
-class CJSONVariantParserHandler : public nlohmann::json::json_sax_t
-{
-public:
-  explicit CJSONVariantParserHandler(CVariant& parsedObject);
-
-  bool null() override;
-  bool binary(binary_t& b) override;
-  bool boolean(bool b) override;
-  bool number_integer(number_integer_t i) override;
-  bool number_unsigned(number_unsigned_t u) override;
-  bool number_float(number_float_t d, const string_t& s) override;
-  bool string(std::string& str) override;
-  bool start_object(std::size_t elements) override;
-  bool key(string_t& str) override;
-  bool end_object() override;
-  bool start_array(std::size_t elements) override;
-  bool end_array() override;
-  bool parse_error(std::size_t position,
-                   const std::string& last_token,
-                   const nlohmann::json::exception& ex) override;
-
-private:
-  template <typename... TArgs>
-  bool Primitive(TArgs... args)
-  {
-    PushObject(CVariant(std::forward<TArgs>(args)...));
-    PopObject();
+#include <charconv>
+#include <clocale>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <utility>
+#include <vector>
 
-    return true;
-  }
+namespace
+{
+/*!
+ \brief Builds the CVariant of a JSON document in a single pass.
 
-  void PushObject(CVariant variant);
-  void PopObject();
+ Values are parsed onto a stack and moved into their array or object once it is closed, so
+ arrays are allocated once with their final size and nothing is copied. Nesting is handled with
+ explicit stacks rather than recursion, deeply nested documents can't overflow the thread stack.
+ */
+class CJSONVariantReader
+{
+public:
+  CJSONVariantReader(const char* json, size_t length) : m_pos(json), m_end(json + length) {}
 
-  CVariant& m_parsedObject;
-  std::vector<CVariant *> m_parse;
-  std::string m_key;
-  CVariant m_root;
+  bool Read(CVariant& data);
 
-  enum class PARSE_STATUS
+private:
+  struct Container
   {
-    Variable,
-    Array,
-    Object
+    bool object;
+    size_t firstValue; ///< index of the first member in m_values
+    size_t firstKey; ///< index of the first key in m_keys
   };
-  PARSE_STATUS m_status = PARSE_STATUS::Variable;
-};
 
-CJSONVariantParserHandler::CJSONVariantParserHandler(CVariant& parsedObject)
-  : m_parsedObject(parsedObject), m_parse(), m_key()
-{ }
+  bool ReadValue();
+  bool ReadKey();
+  bool ReadString(std::string& str);
+  bool ReadNumber();
+  bool ReadLiteral(const char* literal, const CVariant& value);
+  bool ReadHex(uint32_t& codepoint);
+  void CloseContainer();
+  void SkipWhitespace();
+
+  const char* m_pos;
+  const char* m_end;
+  std::vector<CVariant> m_values;
+  std::vector<std::string> m_keys;
+  std::vector<Container> m_containers;
+  bool m_opened = false; ///< a container was opened and its first member is next
+};
 
-bool CJSONVariantParserHandler::null()
+bool CJSONVariantReader::Read(CVariant& data)
 {
-  PushObject(CVariant::ConstNullVariant);
-  PopObject();
-
-  return true;
-}
+  // skip a leading UTF-8 byte order mark, as nlohmann::json did
+  if (m_end - m_pos >= 3 && strncmp(m_pos, "\xEF\xBB\xBF", 3) == 0)
+    m_pos += 3;
 
-bool CJSONVariantParserHandler::boolean(bool b)
-{
-  return Primitive(b);
+  SkipWhitespace();
+  for (;;)
+  {
+    if (!ReadValue())
+      return false;
+    if (m_opened)
+    {
+      // read the first member of the container just opened
+      m_opened = false;
+      continue;
+    }
+
+    // a value is complete, carry on with the container it belongs to
+    for (;;)
+    {
+      if (m_containers.empty())
+      {
+        SkipWhitespace();
+        if (m_pos != m_end)
+          return false; // trailing garbage
+
+        data = std::move(m_values.back());
+        return true;
+      }
+
+      SkipWhitespace();
+      if (m_pos == m_end)
+        return false;
+
+      const Container& container = m_containers.back();
+      char c = *m_pos++;
+      if (c == ',')
+      {
+        SkipWhitespace();
+        if (container.object && !ReadKey())
+          return false;
+        break; // next member
+      }
+      else if (c == (container.object ? '}' : ']'))
+        CloseContainer();
+      else
+        return false;
+    }
+  }
 }
 
-bool CJSONVariantParserHandler::number_integer(number_integer_t i)
+bool CJSONVariantReader::ReadValue()
 {
-  return Primitive(i);
-}
+  if (m_pos == m_end)
+    return false;
 
-bool CJSONVariantParserHandler::number_unsigned(number_unsigned_t u)
-{
-  return Primitive(u);
+  switch (*m_pos)
+  {
+  case '{':
+  case '[':
+  {
+    bool object = *m_pos++ == '{';
+    m_containers.push_back({object, m_values.size(), m_keys.size()});
+    SkipWhitespace();
+    if (m_pos != m_end && *m_pos == (object ? '}' : ']'))
+    {
+      m_pos++;
+      CloseContainer();
+      return true;
+    }
+    if (object && !ReadKey())
+      return false;
+    m_opened = true;
+    return true;
+  }
+  case '"':
+  {
+    std::string str;
+    if (!ReadString(str))
+      return false;
+    m_values.emplace_back(std::move(str));
+    return true;
+  }
+  case 't':
+    return ReadLiteral("true", CVariant(true));
+  case 'f':
+    return ReadLiteral("false", CVariant(false));
+  case 'n':
+    return ReadLiteral("null", CVariant::ConstNullVariant);
+  default:
+    return ReadNumber();
+  }
 }
 
-bool CJSONVariantParserHandler::number_float(number_float_t d, const string_t& s)
+bool CJSONVariantReader::ReadKey()
 {
-  return Primitive(d);
-}
+  if (m_pos == m_end || *m_pos != '"')
+    return false;
 
-bool CJSONVariantParserHandler::string(std::string& str)
-{
-  return Primitive(str);
-}
+  m_keys.emplace_back();
+  if (!ReadString(m_keys.back()))
+    return false;
 
-bool CJSONVariantParserHandler::binary(binary_t& b)
-{
+  SkipWhitespace();
+  if (m_pos == m_end || *m_pos++ != ':')
+    return false;
+  SkipWhitespace();
   return true;
 }
 
-bool CJSONVariantParserHandler::start_object(std::size_t elements)
+bool CJSONVariantReader::ReadString(std::string& str)
 {
-  PushObject(CVariant::VariantTypeObject);
-
-  return true;
+  m_pos++; // opening quote
+  const char* start = m_pos;
+  while (m_pos != m_end)
+  {
+    unsigned char c = static_cast<unsigned char>(*m_pos);
+    if (c == '"')
+    {
+      str.append(start, m_pos - start);
+      m_pos++;
+      return true;
+    }
+    else if (c < 0x20)
+      return false; // control characters must be escaped
+    else if (c >= 0x80)
+    {
+      size_t bytes = CUtf8Utils::SizeOfValidUtf8Char(m_pos, m_end - m_pos);
+      if (bytes == 0)
+        return false;
+      m_pos += bytes;
+      continue;
+    }
+    else if (c != '\\')
+    {
+      m_pos++;
+      continue;
+    }
+
+    str.append(start, m_pos - start);
+    if (++m_pos == m_end)
+      return false;
+    switch (*m_pos++)
+    {
+    case '"':
+      str += '"';
+      break;
+    case '\\':
+      str += '\\';
+      break;
+    case '/':
+      str += '/';
+      break;
+    case 'b':
+      str += '\b';
+      break;
+    case 'f':
+      str += '\f';
+      break;
+    case 'n':
+      str += '\n';
+      break;
+    case 'r':
+      str += '\r';
+      break;
+    case 't':
+      str += '\t';
+      break;
+    case 'u':
+    {
+      uint32_t codepoint;
+      if (!ReadHex(codepoint))
+        return false;
+      if (codepoint >= 0xDC00 && codepoint <= 0xDFFF)
+        return false; // low surrogate on its own
+      if (codepoint >= 0xD800 && codepoint <= 0xDBFF)
+      {
+        uint32_t low;
+        if (m_end - m_pos < 2 || m_pos[0] != '\\' || m_pos[1] != 'u')
+          return false;
+        m_pos += 2;
+        if (!ReadHex(low) || low < 0xDC00 || low > 0xDFFF)
+          return false;
+        codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+      }
+
+      if (codepoint < 0x80)
+        str += static_cast<char>(codepoint);
+      else if (codepoint < 0x800)
+      {
+        str += static_cast<char>(0xC0 | (codepoint >> 6));
+        str += static_cast<char>(0x80 | (codepoint & 0x3F));
+      }
+      else if (codepoint < 0x10000)
+      {
+        str += static_cast<char>(0xE0 | (codepoint >> 12));
+        str += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+        str += static_cast<char>(0x80 | (codepoint & 0x3F));
+      }
+      else
+      {
+        str += static_cast<char>(0xF0 | (codepoint >> 18));
+        str += static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F));
+        str += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+        str += static_cast<char>(0x80 | (codepoint & 0x3F));
+      }
+      break;
+    }
+    default:
+      return false;
+    }
+    start = m_pos;
+  }
+  return false; // unterminated
 }
 
-bool CJSONVariantParserHandler::key(std::string& str)
+bool CJSONVariantReader::ReadHex(uint32_t& codepoint)
 {
-  m_key = str;
+  if (m_end - m_pos < 4)
+    return false;
 
+  codepoint = 0;
+  for (int i = 0; i < 4; i++)
+  {
+    char c = *m_pos++;
+    codepoint <<= 4;
+    if (c >= '0' && c <= '9')
+      codepoint |= c - '0';
+    else if (c >= 'a' && c <= 'f')
+      codepoint |= c - 'a' + 10;
+    else if (c >= 'A' && c <= 'F')
+      codepoint |= c - 'A' + 10;
+    else
+      return false;
+  }
   return true;
 }
 
-bool CJSONVariantParserHandler::end_object()
+bool CJSONVariantReader::ReadNumber()
 {
-  PopObject();
+  // -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+  const char* start = m_pos;
+  const char* p = m_pos;
+  bool negative = p != m_end && *p == '-';
+  if (negative)
+    p++;
+  if (p == m_end || *p < '0' || *p > '9')
+    return false;
+  if (*p++ != '0')
+  {
+    while (p != m_end && *p >= '0' && *p <= '9')
+      p++;
+  }
 
-  return true;
-}
+  bool integer = true;
+  if (p != m_end && *p == '.')
+  {
+    integer = false;
+    if (++p == m_end || *p < '0' || *p > '9')
+      return false;
+    while (p != m_end && *p >= '0' && *p <= '9')
+      p++;
+  }
+  if (p != m_end && (*p == 'e' || *p == 'E'))
+  {
+    integer = false;
+    if (++p != m_end && (*p == '+' || *p == '-'))
+      p++;
+    if (p == m_end || *p < '0' || *p > '9')
+      return false;
+    while (p != m_end && *p >= '0' && *p <= '9')
+      p++;
+  }
+  m_pos = p;
 
-bool CJSONVariantParserHandler::start_array(std::size_t elements)
-{
-  PushObject(CVariant::VariantTypeArray);
+  // integers are signed when negative and unsigned otherwise, those too big become doubles
+  if (integer)
+  {
+    if (negative)
+    {
+      int64_t value;
+      std::from_chars_result result = std::from_chars(start, p, value);
+      if (result.ec == std::errc() && result.ptr == p)
+      {
+        m_values.emplace_back(value);
+        return true;
+      }
+    }
+    else
+    {
+      uint64_t value;
+      std::from_chars_result result = std::from_chars(start, p, value);
+      if (result.ec == std::errc() && result.ptr == p)
+      {
+        m_values.emplace_back(value);
+        return true;
+      }
+    }
+  }
 
+  // strtod needs a terminated string using the decimal point of the locale
+  std::string number(start, p - start);
+  const char decimalPoint = *localeconv()->decimal_point;
+  if (decimalPoint != '.')
+  {
+    size_t pos = number.find('.');
+    if (pos != std::string::npos)
+      number[pos] = decimalPoint;
+  }
+  m_values.emplace_back(strtod(number.c_str(), nullptr));
   return true;
 }
 
-bool CJSONVariantParserHandler::end_array()
+bool CJSONVariantReader::ReadLiteral(const char* literal, const CVariant& value)
 {
-  PopObject();
+  size_t length = strlen(literal);
+  if (static_cast<size_t>(m_end - m_pos) < length || strncmp(m_pos, literal, length) != 0)
+    return false;
 
+  m_pos += length;
+  m_values.push_back(value);
   return true;
 }
 
-bool CJSONVariantParserHandler::parse_error(std::size_t position,
-                                            const std::string& last_token,
-                                            const nlohmann::json::exception& ex)
-{
-  return false;
-}
-
-void CJSONVariantParserHandler::PushObject(CVariant variant)
+void CJSONVariantReader::CloseContainer()
 {
-  const auto variant_type = variant.type();
+  Container container = m_containers.back();
+  m_containers.pop_back();
 
-  if (m_status == PARSE_STATUS::Object)
+  auto first = m_values.begin() + container.firstValue;
+  if (container.object)
   {
-    (*m_parse.back())[m_key] = std::move(variant);
-    m_parse.push_back(&((*m_parse.back())[m_key]));
+    std::map<std::string, CVariant> members;
+    auto key = m_keys.begin() + container.firstKey;
+    for (auto value = first; value != m_values.end(); ++value, ++key)
+    {
+      // keys usually come sorted, a later duplicate replaces the earlier one
+      members.insert_or_assign(members.end(), std::move(*key), std::move(*value));
+    }
+    m_keys.erase(m_keys.begin() + container.firstKey, m_keys.end());
+    m_values.erase(first, m_values.end());
+    m_values.emplace_back(std::move(members));
   }
-  else if (m_status == PARSE_STATUS::Array)
-  {
-    CVariant *temp = m_parse[m_parse.size() - 1];
-    temp->push_back(std::move(variant));
-    m_parse.push_back(&(*temp)[temp->size() - 1]);
-  }
-  else if (m_parse.empty())
+  else
   {
-    m_root = std::move(variant);
-    m_parse.push_back(&m_root);
+    CVariant array(CVariant::VariantTypeArray);
+    array.reserve(m_values.end() - first);
+    for (auto value = first; value != m_values.end(); ++value)
+      array.push_back(std::move(*value));
+    m_values.erase(first, m_values.end());
+    m_values.push_back(std::move(array));
   }
-
-  if (variant_type == CVariant::VariantTypeObject)
-    m_status = PARSE_STATUS::Object;
-  else if (variant_type == CVariant::VariantTypeArray)
-    m_status = PARSE_STATUS::Array;
-  else
-    m_status = PARSE_STATUS::Variable;
 }
 
-void CJSONVariantParserHandler::PopObject()
+void CJSONVariantReader::SkipWhitespace()
 {
-  assert(!m_parse.empty());
-  CVariant* variant = m_parse.back();
-  m_parse.pop_back();
-
-  if (!m_parse.empty())
-  {
-    variant = m_parse[m_parse.size() - 1];
-    if (variant->isObject())
-      m_status = PARSE_STATUS::Object;
-    else if (variant->isArray())
-      m_status = PARSE_STATUS::Array;
-    else
-      m_status = PARSE_STATUS::Variable;
-  }
-  else
-  {
-    m_parsedObject = *variant;
-    m_status = PARSE_STATUS::Variable;
-  }
+  while (m_pos != m_end && (*m_pos == ' ' || *m_pos == '\n' || *m_pos == '\r' || *m_pos == '\t'))
+    m_pos++;
 }
+} // namespace
 
 bool CJSONVariantParser::Parse(const char* json, CVariant& data)
 {
   if (json == nullptr)
     return false;
 
-  CJSONVariantParserHandler handler(data);
-  return nlohmann::json::sax_parse(json, &handler);
+  CJSONVariantReader reader(json, strlen(json));
+  return reader.Read(data);
 }
 
 bool CJSONVariantParser::Parse(const std::string& json, CVariant& data)
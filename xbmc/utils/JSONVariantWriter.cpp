@@ -8,78 +8,295 @@
 
 #include "JSONVariantWriter.h"
 
+#include "filesystem/File.h"
+#include "utils/Utf8Utils.h"
 #include "utils/Variant.h"
 
-#include <nlohmann/json.hpp>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
 
-void InternalWrite(nlohmann::json& writer, const CVariant& value)
+// buffered output written to files in chunks of this size
+#define FILE_BUFFER_SIZE (64 * 1024)
+
+CJSONVariantStreamWriter::CJSONVariantStreamWriter(std::string& output, bool compact)
+  : m_output(output), m_compact(compact)
+{
+}
+
+CJSONVariantStreamWriter::CJSONVariantStreamWriter(XFILE::CFile& file, bool compact)
+  : m_output(m_buffer), m_file(&file), m_compact(compact)
+{
+  m_buffer.reserve(FILE_BUFFER_SIZE + 256);
+}
+
+CJSONVariantStreamWriter::~CJSONVariantStreamWriter()
+{
+  Flush();
+}
+
+void CJSONVariantStreamWriter::BeginObject()
+{
+  BeginContainer('{');
+}
+
+void CJSONVariantStreamWriter::EndObject()
+{
+  EndContainer('}');
+}
+
+void CJSONVariantStreamWriter::BeginArray()
+{
+  BeginContainer('[');
+}
+
+void CJSONVariantStreamWriter::EndArray()
+{
+  EndContainer(']');
+}
+
+void CJSONVariantStreamWriter::Key(const std::string& key)
+{
+  BeginValue();
+  WriteString(key.c_str(), key.size());
+  m_output += m_compact ? ":" : ": ";
+  m_afterKey = true;
+}
+
+void CJSONVariantStreamWriter::Value(const CVariant& value)
 {
   switch (value.type())
   {
   case CVariant::VariantTypeInteger:
-    writer = value.asInteger();
-    break;
   case CVariant::VariantTypeUnsignedInteger:
-    writer = value.asUnsignedInteger();
+  {
+    BeginValue();
+    char number[24];
+    std::to_chars_result result =
+        value.isSignedInteger()
+            ? std::to_chars(number, number + sizeof(number), value.asInteger())
+            : std::to_chars(number, number + sizeof(number), value.asUnsignedInteger());
+    m_output.append(number, result.ptr - number);
     break;
+  }
   case CVariant::VariantTypeDouble:
-    writer = value.asDouble();
+    BeginValue();
+    WriteDouble(value.asDouble());
     break;
   case CVariant::VariantTypeBoolean:
-    writer = value.asBoolean();
+    BeginValue();
+    m_output += value.asBoolean() ? "true" : "false";
     break;
   case CVariant::VariantTypeString:
-    writer = std::string(value.c_str(), value.size());
+    BeginValue();
+    WriteString(value.c_str(), value.size());
     break;
   case CVariant::VariantTypeArray:
-    writer = nlohmann::json::array();
-
+    BeginArray();
     for (CVariant::const_iterator_array itr = value.begin_array(); itr != value.end_array(); ++itr)
-    {
-      nlohmann::json& o = writer.emplace_back();
-      InternalWrite(o, *itr);
-    }
-
+      Value(*itr);
+    EndArray();
     break;
   case CVariant::VariantTypeObject:
-    writer = nlohmann::json::object();
-
+    BeginObject();
     for (CVariant::const_iterator_map itr = value.begin_map(); itr != value.end_map(); ++itr)
     {
-      nlohmann::json& o = writer[itr->first];
-      InternalWrite(o, itr->second);
+      Key(itr->first);
+      Value(itr->second);
     }
-
+    EndObject();
     break;
 
   case CVariant::VariantTypeConstNull:
   case CVariant::VariantTypeNull:
   default:
-    writer = nullptr;
+    BeginValue();
+    m_output += "null";
     break;
   }
+
+  FlushIfFull();
 }
 
-bool CJSONVariantWriter::Write(const CVariant &value, std::string& output, bool compact)
+bool CJSONVariantStreamWriter::Flush()
+{
+  if (m_file && !m_buffer.empty())
+  {
+    if (!m_failed &&
+        m_file->Write(m_buffer.data(), m_buffer.size()) != static_cast<ssize_t>(m_buffer.size()))
+      m_failed = true;
+    m_buffer.clear();
+  }
+  return !m_failed;
+}
+
+void CJSONVariantStreamWriter::BeginContainer(char open)
+{
+  BeginValue();
+  m_output += open;
+  m_empty.push_back(true);
+}
+
+void CJSONVariantStreamWriter::EndContainer(char close)
 {
-  try
+  if (m_empty.empty())
+  {
+    m_failed = true;
+    return;
+  }
+
+  bool empty = m_empty.back();
+  m_empty.pop_back();
+  if (!empty && !m_compact)
   {
-    nlohmann::json json;
-    InternalWrite(json, value);
+    m_output += '\n';
+    Indent(m_empty.size());
+  }
+  m_output += close;
+}
+
+void CJSONVariantStreamWriter::BeginValue()
+{
+  if (m_afterKey)
+  {
+    m_afterKey = false;
+    return;
+  }
+  if (m_empty.empty())
+    return;
 
-    if (compact)
+  if (!m_empty.back())
+    m_output += ',';
+  m_empty.back() = false;
+  if (!m_compact)
+  {
+    m_output += '\n';
+    Indent(m_empty.size());
+  }
+}
+
+void CJSONVariantStreamWriter::WriteString(const char* str, size_t length)
+{
+  static const char hex[] = "0123456789abcdef";
+
+  const unsigned char* s = reinterpret_cast<const unsigned char*>(str);
+  m_output += '"';
+  size_t start = 0;
+  size_t i = 0;
+  while (i < length)
+  {
+    unsigned char c = s[i];
+    if (c >= 0x20 && c != '"' && c != '\\')
     {
-      output = json.dump();
+      if (c < 0x80)
+      {
+        i++;
+        continue;
+      }
+      size_t bytes = CUtf8Utils::SizeOfValidUtf8Char(str + i, length - i);
+      if (bytes == 0)
+      {
+        m_failed = true;
+        break;
+      }
+      i += bytes;
+      continue;
     }
-    else
+
+    // copy the run of plain characters, then the escaped one
+    m_output.append(str + start, i - start);
+    m_output += '\\';
+    switch (c)
     {
-      output = json.dump(1, '\t');
+    case '"':
+    case '\\':
+      m_output += static_cast<char>(c);
+      break;
+    case '\b':
+      m_output += 'b';
+      break;
+    case '\f':
+      m_output += 'f';
+      break;
+    case '\n':
+      m_output += 'n';
+      break;
+    case '\r':
+      m_output += 'r';
+      break;
+    case '\t':
+      m_output += 't';
+      break;
+    default:
+      m_output += "u00";
+      m_output += hex[c >> 4];
+      m_output += hex[c & 0x0F];
+      break;
     }
+    start = ++i;
+  }
+  m_output.append(str + start, i - start);
+  m_output += '"';
+}
+
+void CJSONVariantStreamWriter::WriteDouble(double value)
+{
+  if (!std::isfinite(value))
+  {
+    m_output += "null";
+    return;
   }
-  catch (nlohmann::json::exception&)
+
+  // shortest of the usual precisions that reads back as the same value
+  char number[32];
+  int length = snprintf(number, sizeof(number), "%.15g", value);
+  if (strtod(number, nullptr) != value)
+    length = snprintf(number, sizeof(number), "%.17g", value);
+
+  bool fraction = false;
+  for (int i = 0; i < length; i++)
   {
+    if (number[i] == ',') // locales with a decimal comma
+      number[i] = '.';
+    if (number[i] == '.' || number[i] == 'e')
+      fraction = true;
+  }
+  m_output.append(number, length);
+  // keep it a floating point number when read back
+  if (!fraction)
+    m_output += ".0";
+}
+
+void CJSONVariantStreamWriter::Indent(size_t depth)
+{
+  m_output.append(depth, '\t');
+}
+
+void CJSONVariantStreamWriter::FlushIfFull()
+{
+  if (m_file && m_buffer.size() >= FILE_BUFFER_SIZE)
+    Flush();
+}
+
+bool CJSONVariantWriter::Write(const CVariant &value, std::string& output, bool compact)
+{
+  output.clear();
+
+  CJSONVariantStreamWriter writer(output, compact);
+  writer.Value(value);
+  if (writer.HasFailed())
+  {
+    output.clear();
     return false;
   }
 
   return true;
 }
+
+bool CJSONVariantWriter::Write(const CVariant& value, XFILE::CFile& file, bool compact)
+{
+  CJSONVariantStreamWriter writer(file, compact);
+  writer.Value(value);
+  return writer.Flush();
+}
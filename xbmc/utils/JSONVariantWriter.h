@@ -9,13 +9,87 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 class CVariant;
 
+namespace XFILE
+{
+class CFile;
+}
+
 class CJSONVariantWriter
 {
 public:
   CJSONVariantWriter() = delete;
 
   static bool Write(const CVariant &value, std::string& output, bool compact);
+
+  /*! \brief Write a variant as JSON to a file opened for writing
+   The JSON is written in chunks as it is produced, it is never held in memory as a whole.
+   */
+  static bool Write(const CVariant& value, XFILE::CFile& file, bool compact);
+};
+
+/*!
+ \brief Writes JSON piece by piece, to a string or to a file.
+
+ Large documents like a library export can be written one item at a time, so only the item
+ being written is held in memory:
+
+ \code
+ CJSONVariantStreamWriter writer(file, false);
+ writer.BeginArray();
+ for (...)
+   writer.Value(item);
+ writer.EndArray();
+ bool success = writer.Flush();
+ \endcode
+
+ Pretty output is indented with tabs, compact output has no whitespace at all.
+ Strings that aren't valid UTF-8 fail the whole document.
+ */
+class CJSONVariantStreamWriter
+{
+public:
+  CJSONVariantStreamWriter(std::string& output, bool compact);
+  CJSONVariantStreamWriter(XFILE::CFile& file, bool compact);
+  ~CJSONVariantStreamWriter();
+
+  void BeginObject();
+  void EndObject();
+  void BeginArray();
+  void EndArray();
+
+  /*! \brief Write the key of the next value, only within an object */
+  void Key(const std::string& key);
+
+  void Value(const CVariant& value);
+
+  /*! \brief Write out what is still buffered for a file
+   \return false if anything failed since the writer was created.
+   */
+  bool Flush();
+
+  bool HasFailed() const { return m_failed; }
+
+private:
+  CJSONVariantStreamWriter(const CJSONVariantStreamWriter&) = delete;
+  CJSONVariantStreamWriter& operator=(const CJSONVariantStreamWriter&) = delete;
+
+  void BeginContainer(char open);
+  void EndContainer(char close);
+  void BeginValue();
+  void WriteString(const char* str, size_t length);
+  void WriteDouble(double value);
+  void Indent(size_t depth);
+  void FlushIfFull();
+
+  std::string m_buffer;
+  std::string& m_output; ///< m_buffer when writing to a file
+  XFILE::CFile* m_file = nullptr;
+  bool m_compact;
+  bool m_failed = false;
+  bool m_afterKey = false;
+  std::vector<bool> m_empty; ///< whether each open container has no value yet
 };
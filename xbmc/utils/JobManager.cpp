@@ -50,13 +50,16 @@ void CJobWorker::Process()
       break;
 
     bool success = false;
-    try
-    {
-      success = job->DoWork();
-    }
-    catch (...)
     {
-      CLog::Log(LOGERROR, "{} error processing job {}", __FUNCTION__, job->GetType());
+      PROFILE_ZONE(job->GetType());
+      try
+      {
+        success = job->DoWork();
+      }
+      catch (...)
+      {
+        CLog::Log(LOGERROR, "{} error processing job {}", __FUNCTION__, job->GetType());
+      }
     }
     m_jobManager->OnJobComplete(success, job);
   }
@@ -306,6 +309,9 @@ CJob *CJobManager::PopJob()
       // add to the processing vector
       m_processing.push_back(job);
       job.m_job->m_callback = this;
+#ifdef HAS_PROFILER
+      CProfiler::AddWait(job.m_job->GetType(), job.m_queued, CProfiler::Now());
+#endif
       return job.m_job;
     }
   }
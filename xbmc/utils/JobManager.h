@@ -11,6 +11,7 @@
 #include "Job.h"
 #include "threads/CriticalSection.h"
 #include "threads/Thread.h"
+#include "utils/Profiler.h"
 
 #include <queue>
 #include <string>
@@ -235,6 +236,9 @@ class CJobManager final
     unsigned int  m_id;
     IJobCallback *m_callback;
     CJob::PRIORITY m_priority;
+#ifdef HAS_PROFILER
+    uint64_t m_queued = CProfiler::Now();
+#endif
   };
 
 public:
@@ -0,0 +1,232 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "Profiler.h"
+
+#ifdef HAS_PROFILER
+
+#include "filesystem/File.h"
+#include "threads/CriticalSection.h"
+#include "threads/Thread.h"
+#include "utils/JSONVariantWriter.h"
+#include "utils/StringUtils.h"
+#include "utils/Variant.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+// events kept of each thread, the oldest are overwritten
+constexpr uint32_t PROFILER_EVENTS = 4096;
+
+struct Event
+{
+  const char* name;
+  uint64_t start;
+  uint64_t end;
+  bool wait;
+};
+
+struct ThreadEvents
+{
+  std::array<Event, PROFILER_EVENTS> events;
+  std::atomic<uint32_t> count{0}; ///< recorded so far, the next one goes to count % PROFILER_EVENTS
+  std::atomic<bool> inUse{false};
+  unsigned int id = 0; ///< thread id in the trace
+  std::string name;
+};
+
+struct Registry
+{
+  CCriticalSection critSection;
+  std::vector<std::unique_ptr<ThreadEvents>> threads;
+};
+
+Registry& GetRegistry()
+{
+  static Registry registry;
+  return registry;
+}
+
+// hands the buffer of an exited thread over to the next new thread. Its events are kept, the two
+// threads share a track of the trace without overlapping.
+struct ThreadSlot
+{
+  ~ThreadSlot()
+  {
+    if (events)
+      events->inUse = false;
+  }
+
+  ThreadEvents* events = nullptr;
+};
+
+thread_local ThreadSlot t_slot;
+
+ThreadEvents& GetThreadEvents()
+{
+  if (t_slot.events)
+    return *t_slot.events;
+
+  Registry& registry = GetRegistry();
+  std::unique_lock<CCriticalSection> lock(registry.critSection);
+  auto it = std::find_if(registry.threads.begin(), registry.threads.end(),
+                         [](const auto& thread) { return !thread->inUse; });
+  ThreadEvents* events;
+  if (it != registry.threads.end())
+    events = it->get();
+  else
+  {
+    registry.threads.push_back(std::make_unique<ThreadEvents>());
+    events = registry.threads.back().get();
+    events->id = static_cast<unsigned int>(registry.threads.size());
+  }
+
+  const CThread* thread = CThread::GetCurrentThread();
+  events->name = thread ? thread->GetThreadName() : StringUtils::Format("thread {}", events->id);
+  events->inUse = true;
+  t_slot.events = events;
+  return *events;
+}
+
+void AddEvent(const char* name, uint64_t start, uint64_t end, bool wait)
+{
+  ThreadEvents& thread = GetThreadEvents();
+  const uint32_t count = thread.count.load(std::memory_order_relaxed);
+  thread.events[count % PROFILER_EVENTS] = {name, start, end, wait};
+  thread.count.store(count + 1, std::memory_order_release);
+}
+
+struct ThreadCopy
+{
+  unsigned int id;
+  std::string name;
+  std::vector<Event> events;
+};
+} // namespace
+
+uint64_t CProfiler::Now()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void CProfiler::AddZone(const char* name, uint64_t start, uint64_t end)
+{
+  AddEvent(name, start, end, false);
+}
+
+void CProfiler::AddWait(const char* name, uint64_t start, uint64_t end)
+{
+  AddEvent(name, start, end, true);
+}
+
+bool CProfiler::Dump(const std::string& path)
+{
+  // threads keep recording while their events are copied, a buffer is only handed over to
+  // another thread with the registry locked
+  std::vector<ThreadCopy> threads;
+  {
+    Registry& registry = GetRegistry();
+    std::unique_lock<CCriticalSection> lock(registry.critSection);
+    for (const auto& thread : registry.threads)
+    {
+      const uint32_t count = thread->count.load(std::memory_order_acquire);
+      const uint32_t first = count > PROFILER_EVENTS ? count - PROFILER_EVENTS : 0;
+      ThreadCopy copy{thread->id, thread->name, {}};
+      copy.events.reserve(count - first);
+      for (uint32_t i = first; i < count; ++i)
+        copy.events.push_back(thread->events[i % PROFILER_EVENTS]);
+
+      // drop what may have been overwritten in the meantime, including the event being written
+      const int64_t intact =
+          static_cast<int64_t>(thread->count.load(std::memory_order_acquire)) - PROFILER_EVENTS + 1;
+      if (intact > first)
+        copy.events.erase(copy.events.begin(),
+                          copy.events.begin() +
+                              std::min<int64_t>(intact - first, copy.events.size()));
+      threads.push_back(std::move(copy));
+    }
+  }
+
+  XFILE::CFile file;
+  if (!file.OpenForWrite(path, true))
+  {
+    CLog::Log(LOGERROR, "CProfiler: unable to write {}", path);
+    return false;
+  }
+
+  // timestamps of the trace are in microseconds
+  size_t events = 0;
+  unsigned int waits = 0;
+  CJSONVariantStreamWriter writer(file, true);
+  writer.BeginObject();
+  writer.Key("traceEvents");
+  writer.BeginArray();
+  for (const auto& thread : threads)
+  {
+    CVariant name(CVariant::VariantTypeObject);
+    name["name"] = "thread_name";
+    name["ph"] = "M";
+    name["pid"] = 1;
+    name["tid"] = thread.id;
+    name["args"]["name"] = thread.name;
+    writer.Value(name);
+
+    for (const auto& event : thread.events)
+    {
+      CVariant value(CVariant::VariantTypeObject);
+      value["name"] = event.name;
+      value["pid"] = 1;
+      value["tid"] = thread.id;
+      value["ts"] = event.start / 1000.0;
+      if (!event.wait)
+      {
+        value["ph"] = "X";
+        value["dur"] = (event.end - event.start) / 1000.0;
+        writer.Value(value);
+      }
+      else
+      {
+        // async begin and end, drawn apart from the zones of the thread
+        value["ph"] = "b";
+        value["cat"] = "wait";
+        value["id"] = ++waits;
+        writer.Value(value);
+        value["ph"] = "e";
+        value["ts"] = event.end / 1000.0;
+        writer.Value(value);
+      }
+    }
+    events += thread.events.size();
+  }
+  writer.EndArray();
+  writer.Key("displayTimeUnit");
+  writer.Value("ns");
+  writer.EndObject();
+
+  if (!writer.Flush())
+  {
+    CLog::Log(LOGERROR, "CProfiler: unable to write {}", path);
+    return false;
+  }
+
+  CLog::Log(LOGINFO, "CProfiler: wrote {} events of {} threads to {}", events, threads.size(),
+            path);
+  return true;
+}
+
+#endif
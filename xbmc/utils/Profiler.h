@@ -0,0 +1,82 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+/*!
+ \brief Scoped timing zones, compiled in with HAS_PROFILER (cmake -DENABLE_PROFILER=ON).
+
+ A zone records when it was entered and left into a ring buffer of the current thread, without
+ locks or allocations. The last events of every thread can be written out as Chrome trace-event
+ JSON with the DumpProfile builtin, to be opened in chrome://tracing or Perfetto.
+
+ \code
+ void CGUIWindowManager::Process(unsigned int currentTime)
+ {
+   PROFILE_ZONE("CGUIWindowManager::Process");
+   ...
+ \endcode
+
+ Without HAS_PROFILER the zones compile to nothing.
+ */
+
+#ifdef HAS_PROFILER
+
+#include <cstdint>
+#include <string>
+
+class CProfiler
+{
+public:
+  CProfiler() = delete;
+
+  /*! \brief Nanoseconds of a monotonic clock */
+  static uint64_t Now();
+
+  /*!
+   \brief Record a zone of the current thread
+   \param name must stay valid until the profile is dumped, usually a string literal.
+   */
+  static void AddZone(const char* name, uint64_t start, uint64_t end);
+
+  /*!
+   \brief Record a wait, which unlike a zone may overlap the other events of the thread
+   \param name must stay valid until the profile is dumped, usually a string literal.
+   */
+  static void AddWait(const char* name, uint64_t start, uint64_t end);
+
+  /*!
+   \brief Write the recorded events of all threads as Chrome trace-event JSON
+   \return false if the file couldn't be written.
+   */
+  static bool Dump(const std::string& path);
+};
+
+class CProfileZone
+{
+public:
+  explicit CProfileZone(const char* name) : m_name(name), m_start(CProfiler::Now()) {}
+  ~CProfileZone() { CProfiler::AddZone(m_name, m_start, CProfiler::Now()); }
+
+private:
+  CProfileZone(const CProfileZone&) = delete;
+  CProfileZone& operator=(const CProfileZone&) = delete;
+
+  const char* m_name;
+  uint64_t m_start;
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_ZONE(name) CProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+
+#else
+
+#define PROFILE_ZONE(name)
+
+#endif
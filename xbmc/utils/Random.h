@@ -9,7 +9,10 @@
 #pragma once
 
 #include <algorithm>
+#include <numeric>
 #include <random>
+#include <unordered_set>
+#include <vector>
 
 namespace KODI
 {
@@ -22,5 +25,37 @@ void RandomShuffle(TIterator begin, TIterator end)
   std::mt19937 mt(rd());
   std::shuffle(begin, end, mt);
 }
+
+/*!
+ * \brief Pick distinct numbers from [0, range) at random, in random order
+ * \param range the numbers to pick from
+ * \param count how many to pick, all numbers are picked if the range holds no more
+ */
+inline std::vector<unsigned int> RandomSample(unsigned int range, unsigned int count)
+{
+  std::vector<unsigned int> sample;
+  if (count >= range / 2)
+  {
+    // most of the range, drawing numbers until enough are distinct would take long
+    sample.resize(range);
+    std::iota(sample.begin(), sample.end(), 0);
+    RandomShuffle(sample.begin(), sample.end());
+    sample.resize(std::min(count, range));
+    return sample;
+  }
+
+  std::random_device rd;
+  std::mt19937 mt(rd());
+  std::uniform_int_distribution<unsigned int> distribution(0, range - 1);
+  std::unordered_set<unsigned int> picked;
+  sample.reserve(count);
+  while (sample.size() < count)
+  {
+    const unsigned int number = distribution(mt);
+    if (picked.insert(number).second)
+      sample.push_back(number);
+  }
+  return sample;
+}
 }
 }
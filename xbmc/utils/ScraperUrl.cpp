@@ -14,10 +14,13 @@
 #include "URL.h"
 #include "XMLUtils.h"
 #include "filesystem/CurlFile.h"
+#include "filesystem/HttpCache.h"
 #include "filesystem/ZipFile.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/SettingsComponent.h"
 #include "utils/CharsetDetection.h"
+#include "utils/HostRateLimiter.h"
+#include "utils/HttpHeader.h"
 #include "utils/Mime.h"
 #include "utils/StringUtils.h"
 #include "utils/XBMCTinyXML.h"
@@ -27,6 +30,20 @@
 #include <cstring>
 #include <sstream>
 
+namespace
+{
+// sites behind scrapers throttle or ban clients making too many requests, which is easily done
+// by a library scan looking up several items at once
+constexpr double REQUESTS_PER_SECOND = 4.0;
+constexpr unsigned int REQUEST_BURST = 8;
+
+CHostRateLimiter& GetRateLimiter()
+{
+  static CHostRateLimiter limiter(REQUESTS_PER_SECOND, REQUEST_BURST);
+  return limiter;
+}
+} // namespace
+
 CScraperUrl::CScraperUrl() : m_relevance(0.0), m_parsed(false)
 {
 }
@@ -324,6 +341,7 @@ bool CScraperUrl::Get(const SUrlEntry& scrURL,
   }
 
   auto strHTML1 = strHTML;
+  CHttpHeader headers;
 
   if (scrURL.m_post)
   {
@@ -331,15 +349,29 @@ bool CScraperUrl::Get(const SUrlEntry& scrURL,
     strOptions = strOptions.substr(1);
     url.SetOptions("");
 
+    GetRateLimiter().Acquire(url.GetHostName());
     if (!http.Post(url.Get(), strOptions, strHTML1))
       return false;
+    headers = http.GetHttpHeader();
+  }
+  else if (url.IsProtocol("http") || url.IsProtocol("https"))
+  {
+    // rescans and refreshes fetch the same pages again, let the server tell what is unchanged
+    if (!XFILE::CHttpCache::GetInstance().Get(http, url.Get(), strHTML1, headers,
+                                              &GetRateLimiter()))
+      return false;
+  }
+  else
+  {
+    GetRateLimiter().Acquire(url.GetHostName());
+    if (!http.Get(url.Get(), strHTML1))
+      return false;
+    headers = http.GetHttpHeader();
   }
-  else if (!http.Get(url.Get(), strHTML1))
-    return false;
 
   strHTML = strHTML1;
 
-  const auto mimeType = http.GetProperty(XFILE::FILE_PROPERTY_MIME_TYPE);
+  const auto mimeType = headers.GetMimeType();
   CMime::EFileType ftype = CMime::GetFileTypeFromMime(mimeType);
   if (ftype == CMime::FileTypeUnknown)
     ftype = CMime::GetFileTypeFromContent(strHTML);
@@ -360,7 +392,7 @@ bool CScraperUrl::Get(const SUrlEntry& scrURL,
                 scrURL.m_url);
   }
 
-  const auto reportedCharset = http.GetProperty(XFILE::FILE_PROPERTY_CONTENT_CHARSET);
+  const auto reportedCharset = headers.GetCharset();
   if (ftype == CMime::FileTypeHtml)
   {
     std::string realHtmlCharset, converted;
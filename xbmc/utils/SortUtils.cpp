@@ -1139,6 +1139,16 @@ std::string SortUtils::RemoveArticles(const std::string &label)
   return label;
 }
 
+std::string SortUtils::GetSortKey(const std::string& label)
+{
+  return StringUtils::AlphaNumericSortKey(RemoveArticles(label));
+}
+
+std::string SortUtils::GetSortKeyTokens()
+{
+  return StringUtils::Join(g_langInfo.GetSortTokens(), "\n");
+}
+
 typedef struct
 {
   SortBy        sort;
@@ -218,6 +218,12 @@ public:
   static void GetFieldsForSQLSort(const MediaType& mediaType, SortBy sortMethod, FieldList& fields);
   static const Fields& GetFieldsForSorting(SortBy sortBy);
   static std::string RemoveArticles(const std::string &label);
+  /*! \brief Get the binary sort key of a label ignoring its articles
+   \sa StringUtils::AlphaNumericSortKey
+   */
+  static std::string GetSortKey(const std::string& label);
+  /*! \brief Get the articles ignored by GetSortKey(), keys need refreshing when they change */
+  static std::string GetSortKeyTokens();
 
   typedef std::string (*SortPreparator) (SortAttribute, const SortItem&);
   typedef bool (*Sorter) (const DatabaseResult &, const DatabaseResult &);
@@ -1317,6 +1317,84 @@ int StringUtils::AlphaNumericCollation(int nKey1, const void* pKey1, int nKey2,
   return (nKey1 - nKey2);
 }
 
+std::string StringUtils::AlphaNumericSortKey(const std::string& strUTF8)
+{
+  /*
+  Byte values below any folded character keep the ordering of AlphaNumericCollation():
+  ascii punctuation and symbols first, then control characters, then digit runs, then the rest.
+  A digit run of up to 15 digits is stored without leading zeros after its length, so that
+  longer numbers sort after shorter ones and equal numbers give equal keys.
+  */
+  const unsigned char* z = reinterpret_cast<const unsigned char*>(strUTF8.c_str());
+  const int nKey = static_cast<int>(strUTF8.size());
+  std::string key;
+  key.reserve(strUTF8.size() + 8);
+  unsigned char bytes;
+  int i = 0;
+  while (i < nKey)
+  {
+    if (isdigit(z[i]))
+    {
+      int end = i + 1;
+      while (end < nKey && isdigit(z[end]) && end < i + 15)
+        end++;
+      int first = i;
+      while (first < end && z[first] == '0')
+        first++;
+      key += '\x03';
+      key += static_cast<char>('0' + end - first);
+      key.append(reinterpret_cast<const char*>(&z[first]), end - first);
+      i = end;
+      continue;
+    }
+    if ((z[i] >= 32 && z[i] < '0') || (z[i] > '9' && z[i] < 'A') || (z[i] > 'Z' && z[i] < 'a') ||
+        (z[i] > 'z' && z[i] < 128))
+    {
+      key += '\x01';
+      key += static_cast<char>(z[i]);
+      i++;
+      continue;
+    }
+    if (z[i] < 32)
+    {
+      key += '\x02';
+      key += static_cast<char>(z[i] + 1); // no embedded nul
+      i++;
+      continue;
+    }
+
+    uint32_t c = UTF8ToUnicode(&z[i], nKey - i, bytes);
+    i += bytes + 1;
+    if (c > 128)
+      c = GetCollationWeight(static_cast<wchar_t>(c));
+    if (c >= 'A' && c <= 'Z')
+      c += 'a' - 'A';
+
+    // utf8 keeps the order of the unicode points
+    if (c < 0x80)
+      key += static_cast<char>(c);
+    else if (c < 0x800)
+    {
+      key += static_cast<char>(0xC0 | (c >> 6));
+      key += static_cast<char>(0x80 | (c & 0x3F));
+    }
+    else if (c < 0x10000)
+    {
+      key += static_cast<char>(0xE0 | (c >> 12));
+      key += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+      key += static_cast<char>(0x80 | (c & 0x3F));
+    }
+    else
+    {
+      key += static_cast<char>(0xF0 | (c >> 18));
+      key += static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+      key += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+      key += static_cast<char>(0x80 | (c & 0x3F));
+    }
+  }
+  return key;
+}
+
 int StringUtils::DateStringToYYYYMMDD(const std::string &dateString)
 {
   std::vector<std::string> days = StringUtils::Split(dateString, '-');
@@ -237,6 +237,12 @@ public:
   static int FindNumber(const std::string& strInput, const std::string &strFind);
   static int64_t AlphaNumericCompare(const wchar_t *left, const wchar_t *right);
   static int AlphaNumericCollation(int nKey1, const void* pKey1, int nKey2, const void* pKey2);
+  /*! \brief Get a key of UTF8 text that sorts bytewise like AlphaNumericCollation()
+   Symbols come first, digit runs are stored as their number of digits followed by the digits
+   and letters are case and accent folded, so the keys can be stored, indexed and compared
+   with memcmp. Locale collation is not reproduced.
+   */
+  static std::string AlphaNumericSortKey(const std::string& strUTF8);
   static long TimeStringToSeconds(const std::string &timeString);
   static void RemoveCRLF(std::string& strLine);
 
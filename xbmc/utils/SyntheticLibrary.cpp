@@ -0,0 +1,169 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "SyntheticLibrary.h"
+
+#include "utils/StringUtils.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+const char* const WORDS[] = {
+    "love",    "night",  "river",     "shadow",  "summer", "fire",    "dream",  "city",
+    "heart",   "rain",   "stone",     "golden",  "last",   "road",    "winter", "blue",
+    "silent",  "light",  "ocean",     "broken",  "wild",   "forever", "dance",  "star",
+    "Café",    "Déjà",   "Straße",    "Ébène",   "Łódź",   "Ωmega",   "Ночь",   "Москва",
+    "東京",    "夜明け", "Sønderjyl", "İstanbul", "Ñandú", "Παράδεισος", "مدينة", "Über"};
+
+const char* const FIRST_NAMES[] = {"John",  "Maria", "David", "Anna",  "Michael", "Sofia",
+                                   "James", "Elena", "Björn", "Zoë",   "Hiroshi", "Amélie",
+                                   "Ivan",  "Chloé", "Ravi",  "Agnès", "Omar",    "Ingrid"};
+
+const char* const LAST_NAMES[] = {"Smith",  "García",   "Müller", "Rossi",    "Johansson",
+                                  "Novak",  "Kowalski", "Tanaka", "O'Connor", "Dubois",
+                                  "Иванов", "Jensen",   "Silva",  "Nakamura", "Øster"};
+
+const char* const MUSIC_GENRES[] = {"Rock",   "Pop",    "Jazz",    "Classical", "Electronic",
+                                    "Hip-Hop", "Blues",  "Country", "Folk",      "Metal",
+                                    "Soul",   "Reggae", "Punk",    "Ambient",   "Musique Concrète",
+                                    "Latin",  "World",  "Soundtrack"};
+
+const char* const MOVIE_GENRES[] = {"Drama",     "Comedy",      "Action",   "Thriller",
+                                    "Romance",   "Documentary", "Animation", "Horror",
+                                    "Adventure", "Crime",       "Fantasy",  "Science Fiction",
+                                    "Family",    "Mystery",     "War",      "Western"};
+
+const char* const ARTICLES[] = {"The ", "A ", "An "};
+
+template<typename T, size_t N>
+constexpr unsigned int Count(const T (&)[N])
+{
+  return N;
+}
+} // namespace
+
+std::vector<CSyntheticLibrary::Song> CSyntheticLibrary::GetSongs(unsigned int count)
+{
+  // a popular artist has many albums, most have one or two
+  std::vector<std::string> artists(std::max(count / 40, 10u));
+  for (auto& artist : artists)
+    artist = Random(10) == 0 ? "The " + GetTitle(1, 2) : GetName();
+
+  std::vector<Song> songs;
+  songs.reserve(count);
+  while (songs.size() < count)
+  {
+    const std::string& artist = artists[RandomRank(artists.size())];
+    const std::string album = GetTitle(1, 5);
+    const std::string genre = MUSIC_GENRES[RandomRank(Count(MUSIC_GENRES))];
+    const std::string dateAdded = GetDateAdded();
+    const int year = 1960 + Random(65);
+    const unsigned int tracks = 8 + Random(7);
+    for (unsigned int track = 1; track <= tracks && songs.size() < count; ++track)
+    {
+      Song song;
+      song.title = GetTitle(1, 6);
+      song.artist = artist;
+      song.albumArtist = artist;
+      if (Random(10) == 0)
+        song.artist += " feat. " + artists[Random(artists.size())];
+      song.album = album;
+      song.genre = genre;
+      song.year = year;
+      song.track = track;
+      song.duration = 90 + Random(420);
+      song.path = StringUtils::Format("smb://nas/music/{}/{} ({})/{:02} - {}.flac", artist, album,
+                                      year, track, song.title);
+      song.dateAdded = dateAdded;
+      songs.push_back(std::move(song));
+    }
+  }
+  return songs;
+}
+
+std::vector<CSyntheticLibrary::Movie> CSyntheticLibrary::GetMovies(unsigned int count)
+{
+  std::vector<std::string> directors(std::max(count / 5, 10u));
+  for (auto& director : directors)
+    director = GetName();
+
+  std::vector<Movie> movies(count);
+  for (auto& movie : movies)
+  {
+    movie.title = GetTitle(1, 6);
+    movie.plot = GetWords(20 + Random(40));
+    for (unsigned int genres = 1 + Random(3); genres > 0; --genres)
+    {
+      const std::string genre = MOVIE_GENRES[RandomRank(Count(MOVIE_GENRES))];
+      if (std::find(movie.genres.begin(), movie.genres.end(), genre) == movie.genres.end())
+        movie.genres.push_back(genre);
+    }
+    movie.director = directors[RandomRank(directors.size())];
+    movie.year = 1950 + Random(75);
+    movie.rating = (10 + Random(91)) / 10.0f;
+    movie.runtime = (80 + Random(100)) * 60;
+    movie.path = StringUtils::Format("smb://nas/movies/{} ({})/", movie.title, movie.year);
+    movie.file = StringUtils::Format("{} ({}).mkv", movie.title, movie.year);
+    movie.dateAdded = GetDateAdded();
+  }
+  return movies;
+}
+
+unsigned int CSyntheticLibrary::RandomRank(unsigned int count)
+{
+  // inverse of the cumulative weights, which are about log(i + 1)
+  const double random = m_generator() / 4294967296.0;
+  const double rank = std::exp(random * std::log(count + 1.0)) - 1.0;
+  return std::min(static_cast<unsigned int>(rank), count - 1);
+}
+
+std::string CSyntheticLibrary::GetWords(unsigned int count)
+{
+  std::string words;
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    if (i > 0)
+      words += ' ';
+    // mostly ASCII, the other words are at the end
+    words += WORDS[Random(5) == 0 ? Random(Count(WORDS)) : Random(24)];
+  }
+  return words;
+}
+
+std::string CSyntheticLibrary::GetTitle(unsigned int minWords, unsigned int maxWords)
+{
+  // every twentieth title is a long one
+  const unsigned int words =
+      Random(20) == 0 ? 10 + Random(8) : minWords + Random(maxWords - minWords + 1);
+  std::string title = GetWords(words);
+  if (title[0] >= 'a' && title[0] <= 'z')
+    title[0] -= 'a' - 'A';
+  if (Random(6) == 0)
+    title = ARTICLES[Random(Count(ARTICLES))] + title;
+  return title;
+}
+
+// the order of evaluating function arguments is unspecified, random numbers are drawn one by one
+std::string CSyntheticLibrary::GetName()
+{
+  const char* first = FIRST_NAMES[Random(Count(FIRST_NAMES))];
+  const char* last = LAST_NAMES[Random(Count(LAST_NAMES))];
+  return StringUtils::Format("{} {}", first, last);
+}
+
+std::string CSyntheticLibrary::GetDateAdded()
+{
+  unsigned int date[6] = {2010, 1, 1, 0, 0, 0};
+  const unsigned int ranges[6] = {15, 12, 28, 24, 60, 60};
+  for (int i = 0; i < 6; ++i)
+    date[i] += Random(ranges[i]);
+  return StringUtils::Format("{}-{:02}-{:02} {:02}:{:02}:{:02}", date[0], date[1], date[2], date[3],
+                             date[4], date[5]);
+}
@@ -0,0 +1,69 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <random>
+#include <string>
+#include <vector>
+
+/*!
+ \brief Made-up music and video libraries for the benchmarks.
+
+ The same seed always gives the same library, on any platform. A few artists, genres and
+ directors are much more common than the rest, as in real collections, and a share of the titles
+ start with an article, are long or aren't ASCII.
+ */
+class CSyntheticLibrary
+{
+public:
+  struct Song
+  {
+    std::string title;
+    std::string artist; ///< may feature another artist
+    std::string albumArtist;
+    std::string album;
+    std::string genre;
+    int year;
+    int track;
+    int duration; ///< in seconds
+    std::string path;
+    std::string dateAdded; ///< as a database date time
+  };
+
+  struct Movie
+  {
+    std::string title;
+    std::string plot;
+    std::vector<std::string> genres;
+    std::string director;
+    int year;
+    float rating;
+    int runtime; ///< in seconds
+    std::string path;
+    std::string file;
+    std::string dateAdded; ///< as a database date time
+  };
+
+  explicit CSyntheticLibrary(unsigned int seed = 1) : m_generator(seed) {}
+
+  /*! \brief Songs of whole albums, each by one artist */
+  std::vector<Song> GetSongs(unsigned int count);
+  std::vector<Movie> GetMovies(unsigned int count);
+
+private:
+  unsigned int Random(unsigned int range) { return m_generator() % range; }
+  /*! \brief Pick an index below count, index i being picked about 1 / (i + 1) as often as 0 */
+  unsigned int RandomRank(unsigned int count);
+  std::string GetWords(unsigned int count);
+  std::string GetTitle(unsigned int minWords, unsigned int maxWords);
+  std::string GetName();
+  std::string GetDateAdded();
+
+  std::mt19937 m_generator;
+};
@@ -15,6 +15,7 @@
 #include "settings/AdvancedSettings.h"
 #include "URL.h"
 #include "utils/FileExtensionProvider.h"
+#include "utils/FileExtensionSet.h"
 #include "ServiceBroker.h"
 #include "StringUtils.h"
 #include "utils/log.h"
@@ -25,6 +26,8 @@
 
 #include <algorithm>
 #include <cassert>
+#include <ctype.h>
+#include <string_view>
 #ifdef NXDK
 #include <lwip/netdb.h>
 #else
@@ -101,20 +104,47 @@ bool URIUtils::HasExtension(const std::string& strFileName, const std::string& s
   if (pos == std::string::npos || strFileName[pos] != '.')
     return false;
 
-  const std::string extensionLower = StringUtils::ToLower(strFileName.substr(pos));
+  const std::string_view extension = std::string_view(strFileName).substr(pos);
+  const std::string_view extensions(strExtensions);
 
-  const std::vector<std::string> extensionsLower =
-      StringUtils::Split(StringUtils::ToLower(strExtensions), '|');
-
-  for (const auto& ext : extensionsLower)
+  // walk the list in place rather than splitting it, this is called for every item of a listing
+  size_t start = 0;
+  while (start <= extensions.size())
   {
-    if (StringUtils::EndsWith(ext, extensionLower))
+    size_t end = extensions.find('|', start);
+    if (end == std::string_view::npos)
+      end = extensions.size();
+
+    const std::string_view entry = extensions.substr(start, end - start);
+    if (entry.size() >= extension.size() &&
+        std::equal(extension.begin(), extension.end(), entry.end() - extension.size(),
+                   [](char a, char b) {
+                     return ::tolower(static_cast<unsigned char>(a)) ==
+                            ::tolower(static_cast<unsigned char>(b));
+                   }))
       return true;
+
+    start = end + 1;
   }
 
   return false;
 }
 
+bool URIUtils::HasExtension(const std::string& strFileName, const CFileExtensionSet& extensions)
+{
+  if (IsURL(strFileName))
+  {
+    const CURL url(strFileName);
+    return HasExtension(url.GetFileName(), extensions);
+  }
+
+  const size_t pos = strFileName.find_last_of("./\\");
+  if (pos == std::string::npos || strFileName[pos] != '.')
+    return false;
+
+  return extensions.Contains(std::string_view(strFileName).substr(pos));
+}
+
 void URIUtils::RemoveExtension(std::string& strFileName)
 {
   if(IsURL(strFileName))
@@ -14,6 +14,7 @@
 class CURL;
 class CAdvancedSettings;
 class CFileItem;
+class CFileExtensionSet;
 
 class URIUtils
 {
@@ -58,6 +59,15 @@ public:
   static bool HasExtension(const std::string& strFileName, const std::string& strExtensions);
   static bool HasExtension(const CURL& url, const std::string& strExtensions);
 
+  /*!
+   \brief Check if filename have any of the extensions of a precompiled set
+   \param strFileName Path or URL to check
+   \param extensions Compiled extension set, see CFileExtensionSet
+   \return \e true if strFileName have any one of the extensions.
+   \sa CFileExtensionProvider::GetVideoExtensionSet
+   */
+  static bool HasExtension(const std::string& strFileName, const CFileExtensionSet& extensions);
+
   static void RemoveExtension(std::string& strFileName);
   static std::string ReplaceExtension(const std::string& strFile,
                                      const std::string& strNewExtension);
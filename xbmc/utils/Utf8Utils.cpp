@@ -146,3 +146,43 @@ inline size_t CUtf8Utils::SizeOfUtf8Char(const char* const str)
 
   return 0; // invalid UTF-8 char sequence
 }
+
+size_t CUtf8Utils::SizeOfValidUtf8Char(const char* str, size_t length)
+{
+  const unsigned char* const strU = reinterpret_cast<const unsigned char*>(str);
+  const unsigned char c = strU[0];
+  size_t bytes;
+  unsigned char min = 0x80;
+  unsigned char max = 0xBF;
+  if (c < 0x80)
+    return 1;
+  else if (c >= 0xC2 && c <= 0xDF)
+    bytes = 2;
+  else if (c >= 0xE0 && c <= 0xEF)
+  {
+    bytes = 3;
+    if (c == 0xE0)
+      min = 0xA0; // overlong
+    else if (c == 0xED)
+      max = 0x9F; // surrogates
+  }
+  else if (c >= 0xF0 && c <= 0xF4)
+  {
+    bytes = 4;
+    if (c == 0xF0)
+      min = 0x90; // overlong
+    else if (c == 0xF4)
+      max = 0x8F; // above U+10FFFF
+  }
+  else
+    return 0;
+
+  if (bytes > length || strU[1] < min || strU[1] > max)
+    return 0;
+  for (size_t i = 2; i < bytes; i++)
+  {
+    if ((strU[i] & 0xC0) != 0x80)
+      return 0;
+  }
+  return bytes;
+}
@@ -37,6 +37,14 @@ public:
   static size_t RFindValidUtf8Char(const std::string& str, const size_t startPos);
 
   static size_t SizeOfUtf8Char(const std::string& str, const size_t charStart = 0);
+
+  /**
+   * Get the size of the UTF-8 character at the start of a buffer that isn't null-terminated
+   * @param str the buffer
+   * @param length size of the buffer, at least 1
+   * @return size of the character, 0 if not a valid UTF-8 sequence
+   */
+  static size_t SizeOfValidUtf8Char(const char* str, size_t length);
 private:
   static size_t SizeOfUtf8Char(const char* const str);
 };
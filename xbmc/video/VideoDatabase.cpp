@@ -25,6 +25,7 @@
 #include "dialogs/GUIDialogYesNo.h"
 #include "filesystem/Directory.h"
 #include "filesystem/File.h"
+#include "filesystem/FileExistenceChecker.h"
 #include "filesystem/MultiPathDirectory.h"
 #include "filesystem/PluginDirectory.h"
 #include "filesystem/StackDirectory.h"
@@ -46,6 +47,7 @@
 #include "utils/FileUtils.h"
 #include "utils/GroupUtils.h"
 #include "utils/LabelFormatter.h"
+#include "utils/Random.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 #include "utils/Variant.h"
@@ -70,6 +72,33 @@ using namespace ADDON;
 using namespace KODI::MESSAGING;
 using namespace KODI::GUILIB;
 
+// full text search indexes, the first column is the most relevant one
+struct VideoSearchIndex
+{
+  const char* searchTable;
+  const char* contentTable;
+  const char* idColumn;
+  std::vector<std::string> columns;
+};
+
+static const VideoSearchIndex videoSearchIndexes[] = {
+    {"moviesearch",
+     "movie",
+     "idMovie",
+     {StringUtils::Format("c{:02}", VIDEODB_ID_TITLE),
+      StringUtils::Format("c{:02}", VIDEODB_ID_ORIGINALTITLE)}},
+    {"tvshowsearch", "tvshow", "idShow", {StringUtils::Format("c{:02}", VIDEODB_ID_TV_TITLE)}},
+    {"episodesearch",
+     "episode",
+     "idEpisode",
+     {StringUtils::Format("c{:02}", VIDEODB_ID_EPISODE_TITLE)}},
+    {"musicvideosearch",
+     "musicvideo",
+     "idMVideo",
+     {StringUtils::Format("c{:02}", VIDEODB_ID_MUSICVIDEO_TITLE)}},
+    {"actorsearch", "actor", "actor_id", {"name"}},
+};
+
 //********************************************************************************************************************************
 CVideoDatabase::CVideoDatabase(void) = default;
 
@@ -198,6 +227,9 @@ void CVideoDatabase::CreateTables()
 
   CLog::Log(LOGINFO, "create uniqueid table");
   m_pDS->exec("CREATE TABLE uniqueid (uniqueid_id INTEGER PRIMARY KEY, media_id INTEGER, media_type TEXT, value TEXT, type TEXT)");
+
+  for (const auto& index : videoSearchIndexes)
+    CreateSearchTable(index.searchTable, index.contentTable, index.idColumn, index.columns);
 }
 
 void CVideoDatabase::CreateLinkIndex(const char *table)
@@ -208,6 +240,24 @@ void CVideoDatabase::CreateLinkIndex(const char *table)
   m_pDS->exec(PrepareSQL("CREATE INDEX ix_%s_link_3 ON %s_link (media_type(20))", table, table));
 }
 
+std::string CVideoDatabase::PrepareNameSearch(const std::string& searchTable,
+                                              const std::string& idColumn,
+                                              const std::vector<std::string>& columns,
+                                              const std::string& search)
+{
+  std::string condition = PrepareSearchCondition(searchTable, idColumn, search);
+  if (!condition.empty())
+    return condition;
+
+  for (const auto& column : columns)
+  {
+    if (!condition.empty())
+      condition += " OR ";
+    condition += PrepareSQL("%s LIKE '%%%s%%'", column.c_str(), search.c_str());
+  }
+  return "(" + condition + ")";
+}
+
 void CVideoDatabase::CreateForeignLinkIndex(const char *table, const char *foreignkey)
 {
   m_pDS->exec(PrepareSQL("CREATE UNIQUE INDEX ix_%s_link_1 ON %s_link (%s_id, media_type(20), media_id)", table, table, foreignkey));
@@ -349,6 +399,9 @@ void CVideoDatabase::CreateAnalytics()
               "DELETE FROM streamdetails WHERE idFile=old.idFile; "
               "END");
 
+  for (const auto& index : videoSearchIndexes)
+    CreateSearchTriggers(index.searchTable, index.contentTable, index.idColumn, index.columns);
+
   CreateViews();
 }
 
@@ -5902,11 +5955,21 @@ void CVideoDatabase::UpdateTables(int iVersion)
     }
     m_pDS->close();
   }
+
+  if (iVersion < 122)
+  {
+    for (const auto& index : videoSearchIndexes)
+      CreateSearchTable(index.searchTable, index.contentTable, index.idColumn, index.columns);
+  }
+
+  // The search triggers don't exist while updating, so index whatever has been changed
+  for (const auto& index : videoSearchIndexes)
+    RebuildSearchTable(index.searchTable);
 }
 
 int CVideoDatabase::GetSchemaVersion() const
 {
-  return 121;
+  return 122;
 }
 
 bool CVideoDatabase::LookupByFolders(const std::string &path, bool shows)
@@ -8535,10 +8598,12 @@ void CVideoDatabase::GetMovieActorsByName(const std::string& strSearch, CFileIte
     if (nullptr == m_pDS)
       return;
 
+    std::string nameCondition =
+        PrepareNameSearch("actorsearch", "actor.actor_id", {"actor.name"}, strSearch);
     if (m_profileManager.GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL=PrepareSQL("SELECT actor.actor_id, actor.name, path.strPath FROM actor INNER JOIN actor_link ON actor_link.actor_id=actor.actor_id INNER JOIN movie ON actor_link.media_id=movie.idMovie INNER JOIN files ON files.idFile=movie.idFile INNER JOIN path ON path.idPath=files.idPath WHERE actor_link.media_type='movie' AND actor.name LIKE '%%%s%%'", strSearch.c_str());
+      strSQL="SELECT actor.actor_id, actor.name, path.strPath FROM actor INNER JOIN actor_link ON actor_link.actor_id=actor.actor_id INNER JOIN movie ON actor_link.media_id=movie.idMovie INNER JOIN files ON files.idFile=movie.idFile INNER JOIN path ON path.idPath=files.idPath WHERE actor_link.media_type='movie' AND " + nameCondition;
     else
-      strSQL=PrepareSQL("SELECT DISTINCT actor.actor_id, actor.name FROM actor INNER JOIN actor_link ON actor_link.actor_id=actor.actor_id INNER JOIN movie ON actor_link.media_id=movie.idMovie WHERE actor_link.media_type='movie' AND actor.name LIKE '%%%s%%'", strSearch.c_str());
+      strSQL="SELECT DISTINCT actor.actor_id, actor.name FROM actor INNER JOIN actor_link ON actor_link.actor_id=actor.actor_id INNER JOIN movie ON actor_link.media_id=movie.idMovie WHERE actor_link.media_type='movie' AND " + nameCondition;
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -8576,10 +8641,12 @@ void CVideoDatabase::GetTvShowsActorsByName(const std::string& strSearch, CFileI
     if (nullptr == m_pDS)
       return;
 
+    std::string nameCondition =
+        PrepareNameSearch("actorsearch", "actor.actor_id", {"actor.name"}, strSearch);
     if (m_profileManager.GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL=PrepareSQL("SELECT actor.actor_id, actor.name, path.strPath FROM actor INNER JOIN actor_link ON actor_link.actor_id=actor.actor_id INNER JOIN tvshow ON actor_link.media_id=tvshow.idShow INNER JOIN tvshowlinkpath ON tvshowlinkpath.idPath=tvshow.idShow INNER JOIN path ON path.idPath=tvshowlinkpath.idPath WHERE actor_link.media_type='tvshow' AND actor.name LIKE '%%%s%%'", strSearch.c_str());
+      strSQL="SELECT actor.actor_id, actor.name, path.strPath FROM actor INNER JOIN actor_link ON actor_link.actor_id=actor.actor_id INNER JOIN tvshow ON actor_link.media_id=tvshow.idShow INNER JOIN tvshowlinkpath ON tvshowlinkpath.idPath=tvshow.idShow INNER JOIN path ON path.idPath=tvshowlinkpath.idPath WHERE actor_link.media_type='tvshow' AND " + nameCondition;
     else
-      strSQL=PrepareSQL("SELECT DISTINCT actor.actor_id, actor.name FROM actor INNER JOIN actor_link ON actor_link.actor_id=actor.actor_id INNER JOIN tvshow ON actor_link.media_id=tvshow.idShow WHERE actor_link.media_type='tvshow' AND actor.name LIKE '%%%s%%'",strSearch.c_str());
+      strSQL="SELECT DISTINCT actor.actor_id, actor.name FROM actor INNER JOIN actor_link ON actor_link.actor_id=actor.actor_id INNER JOIN tvshow ON actor_link.media_id=tvshow.idShow WHERE actor_link.media_type='tvshow' AND " + nameCondition;
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -8619,11 +8686,12 @@ void CVideoDatabase::GetMusicVideoArtistsByName(const std::string& strSearch, CF
 
     std::string strLike;
     if (!strSearch.empty())
-      strLike = "and actor.name like '%%%s%%'";
+      strLike = "and " +
+                PrepareNameSearch("actorsearch", "actor.actor_id", {"actor.name"}, strSearch);
     if (m_profileManager.GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL=PrepareSQL("SELECT actor.actor_id, actor.name, path.strPath FROM actor INNER JOIN actor_link ON actor_link.actor_id=actor.actor_id INNER JOIN musicvideo ON actor_link.media_id=musicvideo.idMVideo INNER JOIN files ON files.idFile=musicvideo.idFile INNER JOIN path ON path.idPath=files.idPath WHERE actor_link.media_type='musicvideo' "+strLike, strSearch.c_str());
+      strSQL="SELECT actor.actor_id, actor.name, path.strPath FROM actor INNER JOIN actor_link ON actor_link.actor_id=actor.actor_id INNER JOIN musicvideo ON actor_link.media_id=musicvideo.idMVideo INNER JOIN files ON files.idFile=musicvideo.idFile INNER JOIN path ON path.idPath=files.idPath WHERE actor_link.media_type='musicvideo' "+strLike;
     else
-      strSQL=PrepareSQL("SELECT DISTINCT actor.actor_id, actor.name from actor INNER JOIN actor_link ON actor_link.actor_id=actor.actor_id WHERE actor_link.media_type='musicvideo' "+strLike,strSearch.c_str());
+      strSQL="SELECT DISTINCT actor.actor_id, actor.name from actor INNER JOIN actor_link ON actor_link.actor_id=actor.actor_id WHERE actor_link.media_type='musicvideo' "+strLike;
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -8891,7 +8959,9 @@ bool CVideoDatabase::GetMusicVideosByWhere(const std::string &baseDir, const Fil
   return false;
 }
 
-unsigned int CVideoDatabase::GetRandomMusicVideoIDs(const std::string& strWhere, std::vector<std::pair<int,int> > &songIDs)
+unsigned int CVideoDatabase::GetRandomMusicVideoIDs(const std::string& strWhere,
+                                                    unsigned int count,
+                                                    std::vector<std::pair<int, int>>& songIDs)
 {
   try
   {
@@ -8900,26 +8970,50 @@ unsigned int CVideoDatabase::GetRandomMusicVideoIDs(const std::string& strWhere,
     if (nullptr == m_pDS)
       return 0;
 
-    std::string strSQL = "select distinct idMVideo from musicvideo_view";
+    // music videos picked before, for as long as this connection is open
+    m_pDS->exec("CREATE TEMPORARY TABLE IF NOT EXISTS tmp_randommusicvideos "
+                "(idMVideo INTEGER PRIMARY KEY)");
+    std::string where = "NOT EXISTS (SELECT 1 FROM tmp_randommusicvideos "
+                        "WHERE tmp_randommusicvideos.idMVideo = musicvideo_view.idMVideo)";
     if (!strWhere.empty())
-      strSQL += " where " + strWhere;
-    strSQL += PrepareSQL(" ORDER BY RANDOM()");
+      where = "(" + strWhere + ") AND " + where;
+    where = " where " + where;
 
-    if (!m_pDS->query(strSQL)) return 0;
-    songIDs.clear();
-    if (m_pDS->num_rows() == 0)
-    {
-      m_pDS->close();
+    if (!m_pDS->query("select count(distinct idMVideo) from musicvideo_view" + where))
       return 0;
-    }
-    songIDs.reserve(m_pDS->num_rows());
-    while (!m_pDS->eof())
+    const unsigned int total = m_pDS->eof() ? 0 : m_pDS->fv(0).get_asInt();
+    m_pDS->close();
+    if (count == 0 || total == 0)
+      return total;
+
+    // collected in a single pass over the ids in order, rather than sorting all at random
+    std::vector<unsigned int> offsets = KODI::UTILS::RandomSample(total, count);
+    std::sort(offsets.begin(), offsets.end());
+    if (!m_pDS->query("select distinct idMVideo from musicvideo_view" + where +
+                      PrepareSQL(" order by idMVideo limit %u", offsets.back() + 1)))
+      return 0;
+
+    std::vector<std::string> picked;
+    picked.reserve(offsets.size());
+    auto offset = offsets.begin();
+    for (unsigned int row = 0; !m_pDS->eof() && offset != offsets.end(); row++, m_pDS->next())
     {
-      songIDs.push_back(std::make_pair<int,int>(2,m_pDS->fv(0).get_asInt()));
-      m_pDS->next();
-    }    // cleanup
+      if (row == *offset)
+      {
+        picked.emplace_back(m_pDS->fv(0).get_asString());
+        ++offset;
+      }
+    }
     m_pDS->close();
-    return songIDs.size();
+    if (picked.empty())
+      return total;
+
+    m_pDS->exec("INSERT INTO tmp_randommusicvideos (idMVideo) VALUES (" +
+                StringUtils::Join(picked, "),(") + ")");
+    KODI::UTILS::RandomShuffle(picked.begin(), picked.end());
+    for (const std::string& idMVideo : picked)
+      songIDs.emplace_back(2, std::stoi(idMVideo));
+    return total;
   }
   catch (...)
   {
@@ -8986,18 +9080,21 @@ void CVideoDatabase::GetMoviesByName(const std::string& strSearch, CFileItemList
     if (nullptr == m_pDS)
       return;
 
+    std::string nameCondition = PrepareNameSearch(
+        "moviesearch", "movie.idMovie",
+        {PrepareSQL("movie.c%02d", VIDEODB_ID_TITLE),
+         PrepareSQL("movie.c%02d", VIDEODB_ID_ORIGINALTITLE)},
+        strSearch);
     if (m_profileManager.GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
       strSQL = PrepareSQL("SELECT movie.idMovie, movie.c%02d, path.strPath, movie.idSet FROM movie "
                           "INNER JOIN files ON files.idFile=movie.idFile INNER JOIN path ON "
-                          "path.idPath=files.idPath "
-                          "WHERE movie.c%02d LIKE '%%%s%%' OR movie.c%02d LIKE '%%%s%%'",
-                          VIDEODB_ID_TITLE, VIDEODB_ID_TITLE, strSearch.c_str(),
-                          VIDEODB_ID_ORIGINALTITLE, strSearch.c_str());
+                          "path.idPath=files.idPath WHERE ",
+                          VIDEODB_ID_TITLE) +
+               nameCondition;
     else
-      strSQL = PrepareSQL("SELECT movie.idMovie,movie.c%02d, movie.idSet FROM movie WHERE "
-                          "movie.c%02d like '%%%s%%' OR movie.c%02d LIKE '%%%s%%'",
-                          VIDEODB_ID_TITLE, VIDEODB_ID_TITLE, strSearch.c_str(),
-                          VIDEODB_ID_ORIGINALTITLE, strSearch.c_str());
+      strSQL = PrepareSQL("SELECT movie.idMovie,movie.c%02d, movie.idSet FROM movie WHERE ",
+                          VIDEODB_ID_TITLE) +
+               nameCondition;
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -9041,10 +9138,13 @@ void CVideoDatabase::GetTvShowsByName(const std::string& strSearch, CFileItemLis
     if (nullptr == m_pDS)
       return;
 
+    std::string nameCondition = PrepareNameSearch(
+        "tvshowsearch", "tvshow.idShow", {PrepareSQL("tvshow.c%02d", VIDEODB_ID_TV_TITLE)},
+        strSearch);
     if (m_profileManager.GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = PrepareSQL("SELECT tvshow.idShow, tvshow.c%02d, path.strPath FROM tvshow INNER JOIN tvshowlinkpath ON tvshowlinkpath.idShow=tvshow.idShow INNER JOIN path ON path.idPath=tvshowlinkpath.idPath WHERE tvshow.c%02d LIKE '%%%s%%'", VIDEODB_ID_TV_TITLE, VIDEODB_ID_TV_TITLE, strSearch.c_str());
+      strSQL = PrepareSQL("SELECT tvshow.idShow, tvshow.c%02d, path.strPath FROM tvshow INNER JOIN tvshowlinkpath ON tvshowlinkpath.idShow=tvshow.idShow INNER JOIN path ON path.idPath=tvshowlinkpath.idPath WHERE ", VIDEODB_ID_TV_TITLE) + nameCondition;
     else
-      strSQL = PrepareSQL("select tvshow.idShow,tvshow.c%02d from tvshow where tvshow.c%02d like '%%%s%%'",VIDEODB_ID_TV_TITLE,VIDEODB_ID_TV_TITLE,strSearch.c_str());
+      strSQL = PrepareSQL("select tvshow.idShow,tvshow.c%02d from tvshow where ",VIDEODB_ID_TV_TITLE) + nameCondition;
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -9085,10 +9185,13 @@ void CVideoDatabase::GetEpisodesByName(const std::string& strSearch, CFileItemLi
     if (nullptr == m_pDS)
       return;
 
+    std::string nameCondition = PrepareNameSearch(
+        "episodesearch", "episode.idEpisode",
+        {PrepareSQL("episode.c%02d", VIDEODB_ID_EPISODE_TITLE)}, strSearch);
     if (m_profileManager.GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d, path.strPath FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow INNER JOIN files ON files.idFile=episode.idFile INNER JOIN path ON path.idPath=files.idPath WHERE episode.c%02d LIKE '%%%s%%'", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE, VIDEODB_ID_EPISODE_TITLE, strSearch.c_str());
+      strSQL = PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d, path.strPath FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow INNER JOIN files ON files.idFile=episode.idFile INNER JOIN path ON path.idPath=files.idPath WHERE ", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE) + nameCondition;
     else
-      strSQL = PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow WHERE episode.c%02d like '%%%s%%'", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE, VIDEODB_ID_EPISODE_TITLE, strSearch.c_str());
+      strSQL = PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow WHERE ", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE) + nameCondition;
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -9132,10 +9235,13 @@ void CVideoDatabase::GetMusicVideosByName(const std::string& strSearch, CFileIte
     if (nullptr == m_pDS)
       return;
 
+    std::string nameCondition = PrepareNameSearch(
+        "musicvideosearch", "musicvideo.idMVideo",
+        {PrepareSQL("musicvideo.c%02d", VIDEODB_ID_MUSICVIDEO_TITLE)}, strSearch);
     if (m_profileManager.GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = PrepareSQL("SELECT musicvideo.idMVideo, musicvideo.c%02d, path.strPath FROM musicvideo INNER JOIN files ON files.idFile=musicvideo.idFile INNER JOIN path ON path.idPath=files.idPath WHERE musicvideo.c%02d LIKE '%%%s%%'", VIDEODB_ID_MUSICVIDEO_TITLE, VIDEODB_ID_MUSICVIDEO_TITLE, strSearch.c_str());
+      strSQL = PrepareSQL("SELECT musicvideo.idMVideo, musicvideo.c%02d, path.strPath FROM musicvideo INNER JOIN files ON files.idFile=musicvideo.idFile INNER JOIN path ON path.idPath=files.idPath WHERE ", VIDEODB_ID_MUSICVIDEO_TITLE) + nameCondition;
     else
-      strSQL = PrepareSQL("select musicvideo.idMVideo,musicvideo.c%02d from musicvideo where musicvideo.c%02d like '%%%s%%'",VIDEODB_ID_MUSICVIDEO_TITLE,VIDEODB_ID_MUSICVIDEO_TITLE,strSearch.c_str());
+      strSQL = PrepareSQL("select musicvideo.idMVideo,musicvideo.c%02d from musicvideo where ",VIDEODB_ID_MUSICVIDEO_TITLE) + nameCondition;
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -9270,10 +9376,12 @@ void CVideoDatabase::GetMovieDirectorsByName(const std::string& strSearch, CFile
     if (nullptr == m_pDS)
       return;
 
+    std::string nameCondition =
+        PrepareNameSearch("actorsearch", "actor.actor_id", {"actor.name"}, strSearch);
     if (m_profileManager.GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = PrepareSQL("SELECT DISTINCT director_link.actor_id, actor.name, path.strPath FROM movie INNER JOIN director_link ON (director_link.media_id=movie.idMovie AND director_link.media_type='movie') INNER JOIN actor ON actor.actor_id=director_link.actor_id INNER JOIN files ON files.idFile=movie.idFile INNER JOIN path ON path.idPath=files.idPath WHERE actor.name LIKE '%%%s%%'", strSearch.c_str());
+      strSQL = "SELECT DISTINCT director_link.actor_id, actor.name, path.strPath FROM movie INNER JOIN director_link ON (director_link.media_id=movie.idMovie AND director_link.media_type='movie') INNER JOIN actor ON actor.actor_id=director_link.actor_id INNER JOIN files ON files.idFile=movie.idFile INNER JOIN path ON path.idPath=files.idPath WHERE " + nameCondition;
     else
-      strSQL = PrepareSQL("SELECT DISTINCT director_link.actor_id, actor.name FROM actor INNER JOIN director_link ON director_link.actor_id=actor.actor_id INNER JOIN movie ON director_link.media_id=movie.idMovie WHERE director_link.media_type='movie' AND actor.name like '%%%s%%'", strSearch.c_str());
+      strSQL = "SELECT DISTINCT director_link.actor_id, actor.name FROM actor INNER JOIN director_link ON director_link.actor_id=actor.actor_id INNER JOIN movie ON director_link.media_id=movie.idMovie WHERE director_link.media_type='movie' AND " + nameCondition;
 
     m_pDS->query( strSQL );
 
@@ -9313,10 +9421,12 @@ void CVideoDatabase::GetTvShowsDirectorsByName(const std::string& strSearch, CFi
     if (nullptr == m_pDS)
       return;
 
+    std::string nameCondition =
+        PrepareNameSearch("actorsearch", "actor.actor_id", {"actor.name"}, strSearch);
     if (m_profileManager.GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = PrepareSQL("SELECT DISTINCT director_link.actor_id, actor.name, path.strPath FROM actor INNER JOIN director_link ON director_link.actor_id=actor.actor_id INNER JOIN tvshow ON director_link.media_id=tvshow.idShow INNER JOIN tvshowlinkpath ON tvshowlinkpath.idShow=tvshow.idShow INNER JOIN path ON path.idPath=tvshowlinkpath.idPath WHERE director_link.media_type='tvshow' AND actor.name LIKE '%%%s%%'", strSearch.c_str());
+      strSQL = "SELECT DISTINCT director_link.actor_id, actor.name, path.strPath FROM actor INNER JOIN director_link ON director_link.actor_id=actor.actor_id INNER JOIN tvshow ON director_link.media_id=tvshow.idShow INNER JOIN tvshowlinkpath ON tvshowlinkpath.idShow=tvshow.idShow INNER JOIN path ON path.idPath=tvshowlinkpath.idPath WHERE director_link.media_type='tvshow' AND " + nameCondition;
     else
-      strSQL = PrepareSQL("SELECT DISTINCT director_link.actor_id, actor.name FROM actor INNER JOIN director_link ON director_link.actor_id=actor.actor_id INNER JOIN tvshow ON director_link.media_id=tvshow.idShow WHERE director_link.media_type='tvshow' AND actor.name LIKE '%%%s%%'", strSearch.c_str());
+      strSQL = "SELECT DISTINCT director_link.actor_id, actor.name FROM actor INNER JOIN director_link ON director_link.actor_id=actor.actor_id INNER JOIN tvshow ON director_link.media_id=tvshow.idShow WHERE director_link.media_type='tvshow' AND " + nameCondition;
 
     m_pDS->query( strSQL );
 
@@ -9356,10 +9466,12 @@ void CVideoDatabase::GetMusicVideoDirectorsByName(const std::string& strSearch,
     if (nullptr == m_pDS)
       return;
 
+    std::string nameCondition =
+        PrepareNameSearch("actorsearch", "actor.actor_id", {"actor.name"}, strSearch);
     if (m_profileManager.GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = PrepareSQL("SELECT DISTINCT director_link.actor_id, actor.name, path.strPath FROM actor INNER JOIN director_link ON director_link.actor_id=actor.actor_id INNER JOIN musicvideo ON director_link.media_id=musicvideo.idMVideo INNER JOIN files ON files.idFile=musicvideo.idFile INNER JOIN path ON path.idPath=files.idPath WHERE director_link.media_type='musicvideo' AND actor.name LIKE '%%%s%%'", strSearch.c_str());
+      strSQL = "SELECT DISTINCT director_link.actor_id, actor.name, path.strPath FROM actor INNER JOIN director_link ON director_link.actor_id=actor.actor_id INNER JOIN musicvideo ON director_link.media_id=musicvideo.idMVideo INNER JOIN files ON files.idFile=musicvideo.idFile INNER JOIN path ON path.idPath=files.idPath WHERE director_link.media_type='musicvideo' AND " + nameCondition;
     else
-      strSQL = PrepareSQL("SELECT DISTINCT director_link.actor_id, actor.name FROM actor INNER JOIN director_link ON director_link.actor_id=actor.actor_id INNER JOIN musicvideo ON director_link.media_id=musicvideo.idMVideo WHERE director_link.media_type='musicvideo' AND actor.name LIKE '%%%s%%'", strSearch.c_str());
+      strSQL = "SELECT DISTINCT director_link.actor_id, actor.name FROM actor INNER JOIN director_link ON director_link.actor_id=actor.actor_id INNER JOIN musicvideo ON director_link.media_id=musicvideo.idMVideo WHERE director_link.media_type='musicvideo' AND " + nameCondition;
 
     m_pDS->query( strSQL );
 
@@ -9441,9 +9553,6 @@ void CVideoDatabase::CleanDatabase(CGUIDialogProgressBarHandle* handle,
       sql += PrepareSQL(" AND path.idPath IN (%s)", strPaths.substr(1).c_str());
     }
 
-    // For directory caching to work properly, we need to sort the files by path
-    sql += " ORDER BY path.strPath";
-
     m_pDS2->query(sql);
     if (m_pDS2->num_rows() > 0)
     {
@@ -9451,10 +9560,9 @@ void CVideoDatabase::CleanDatabase(CGUIDialogProgressBarHandle* handle,
       VECSOURCES videoSources(*CMediaSourceSettings::GetInstance().GetSources("video"));
       CServiceBroker::GetMediaManager().GetRemovableDrives(videoSources);
 
-      int total = m_pDS2->num_rows();
-      int current = 0;
-      std::string lastDir;
-      bool gotDir = true;
+      // files are checked all at once, listing every folder only once
+      CFileExistenceChecker checker;
+      std::vector<std::pair<std::string, size_t>> filesToCheck;
 
       while (!m_pDS2->eof())
       {
@@ -9488,25 +9596,21 @@ void CVideoDatabase::CleanDatabase(CGUIDialogProgressBarHandle* handle,
           if (!URIUtils::IsOnDVD(fullPath) &&
               CUtil::GetMatchingSource(fullPath, videoSources, bIsSource) >= 0)
           {
-            const std::string pathDir = URIUtils::GetDirectory(fullPath);
-
-            // Cache file's directory in case it's different from the previous file
-            if (lastDir != pathDir)
-            {
-              lastDir = pathDir;
-              CFileItemList items; // Dummy list
-              gotDir = CDirectory::GetDirectory(pathDir, items, "",
-                                                DIR_FLAG_NO_FILE_DIRS | DIR_FLAG_NO_FILE_INFO);
-            }
-
-            // Keep existing files
-            if (gotDir && CFile::Exists(fullPath, true))
-              del = false;
+            filesToCheck.emplace_back(m_pDS2->fv("files.idFile").get_asString(),
+                                      checker.Add(fullPath));
+            del = false;
           }
         }
         if (del)
           filesToTestForDelete += m_pDS2->fv("files.idFile").get_asString() + ",";
 
+        m_pDS2->next();
+      }
+      m_pDS2->close();
+
+      bool canceled = !checker.Check([handle, progress](unsigned int current, unsigned int total) {
+        if (total == 0)
+          return true;
         if (handle == NULL && progress != NULL)
         {
           int percentage = current * 100 / total;
@@ -9516,21 +9620,33 @@ void CVideoDatabase::CleanDatabase(CGUIDialogProgressBarHandle* handle,
             progress->Progress();
           }
           if (progress->IsCanceled())
-          {
-            progress->Close();
-            m_pDS2->close();
-            CServiceBroker::GetAnnouncementManager()->Announce(ANNOUNCEMENT::VideoLibrary,
-                                                               "OnCleanFinished");
-            return;
-          }
+            return false;
         }
         else if (handle != NULL)
           handle->SetPercentage(current * 100 / (float)total);
+        return true;
+      });
+      if (canceled)
+      {
+        progress->Close();
+        CServiceBroker::GetAnnouncementManager()->Announce(ANNOUNCEMENT::VideoLibrary,
+                                                           "OnCleanFinished");
+        return;
+      }
 
-        m_pDS2->next();
-        current++;
+      // Files on a share that can't be reached are kept, they are probably just offline
+      unsigned int unreachable = 0;
+      for (const auto& file : filesToCheck)
+      {
+        CFileExistenceChecker::State state = checker.GetState(file.second);
+        if (state == CFileExistenceChecker::State::MISSING)
+          filesToTestForDelete += file.first + ",";
+        else if (state == CFileExistenceChecker::State::UNKNOWN)
+          unreachable++;
       }
-      m_pDS2->close();
+      if (unreachable > 0)
+        CLog::Log(LOGINFO, "{}: keeping {} files that can't be reached", __FUNCTION__,
+                  unreachable);
 
       std::string filesToDelete;
 
@@ -896,12 +896,16 @@ public:
   std::string GetItemById(const std::string &itemType, int id);
 
   // partymode
-  /*! \brief Gets music video IDs in random order that match the where clause
+  /*! \brief Picks music video IDs at random from those that match the where clause
+  Music videos picked are not picked again for as long as the database stays open.
   \param strWhere the SQL where clause to apply in the query
-  \param songIDs a vector of <2, id> pairs suited to party mode use
-  \return count of music video IDs found.
+  \param count how many music video IDs to pick, 0 to only count the matching ones
+  \param songIDs [out] the picked IDs are appended as <2, id> pairs suited to party mode use
+  \return count of music videos matching the where clause that weren't picked before.
   */
-  unsigned int GetRandomMusicVideoIDs(const std::string& strWhere, std::vector<std::pair<int, int> > &songIDs);
+  unsigned int GetRandomMusicVideoIDs(const std::string& strWhere,
+                                      unsigned int count,
+                                      std::vector<std::pair<int, int>>& songIDs);
 
   static void VideoContentTypeToString(VideoDbContentType type, std::string& out)
   {
@@ -1084,6 +1088,15 @@ private:
   void CreateLinkIndex(const char *table);
   void CreateForeignLinkIndex(const char *table, const char *foreignkey);
 
+  /*! \brief Get a WHERE condition matching the rows whose columns contain the user input
+   Uses the full text search index of the table when available, so only words starting with the
+   input match, and falls back to a LIKE on each column otherwise.
+   */
+  std::string PrepareNameSearch(const std::string& searchTable,
+                                const std::string& idColumn,
+                                const std::vector<std::string>& columns,
+                                const std::string& search);
+
   /*! \brief (Re)Create the generic database views for movies, tvshows,
      episodes and music videos
    */
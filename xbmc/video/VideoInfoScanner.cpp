@@ -34,8 +34,10 @@
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
 #include "tags/VideoInfoTagLoaderFactory.h"
+#include "threads/Event.h"
 #include "utils/Digest.h"
 #include "utils/FileExtensionProvider.h"
+#include "utils/JobManager.h"
 #include "utils/RegExp.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
@@ -44,8 +46,10 @@
 #include "video/VideoThumbLoader.h"
 
 #include <algorithm>
+#include <chrono>
 #include <utility>
 
+using namespace std::chrono_literals;
 using namespace XFILE;
 using namespace ADDON;
 using namespace KODI::MESSAGING;
@@ -56,6 +60,21 @@ using KODI::UTILITY::CDigest;
 namespace VIDEO
 {
 
+  //! Scraper lookup of a movie or music video, run ahead of the item being processed
+  struct CVideoInfoScanner::VideoLookup
+  {
+    ScraperPtr scraper; ///< an instance of its own, scrapers keep state while they run
+    std::unique_ptr<IVideoInfoTagLoader> loader;
+    CInfoScanner::INFO_TYPE nfo = CInfoScanner::NO_NFO;
+    std::string title;
+    int year = -1;
+    CScraperUrl url; ///< set from the nfo, or by the search
+    int found = 0; ///< result of the search, as from CVideoInfoDownloader::FindMovie()
+    bool gotDetails = false;
+    CVideoInfoTag details;
+    CEvent done{true};
+  };
+
   CVideoInfoScanner::CVideoInfoScanner()
   {
     m_bStop = false;
@@ -428,11 +447,26 @@ namespace VIDEO
     }
 
     m_database.Open();
+    m_clearedCaches.clear();
+
+    // look movies and music videos up in the background while scanning, the progress dialog of
+    // a single item refresh only follows one lookup at a time
+    const int lookups =
+        CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_iVideoScannerLookups;
+    if (!pDlgProgress && !pURL && lookups > 1 && items.Size() > 1 &&
+        (content == CONTENT_MOVIES || content == CONTENT_MUSICVIDEOS))
+    {
+      m_lookupQueue = std::make_unique<CJobQueue>(false, lookups, CJob::PRIORITY_DEDICATED);
+      m_nextLookup = 0;
+    }
 
     bool FoundSomeInfo = false;
     std::vector<int> seenPaths;
     for (int i = 0; i < items.Size(); ++i)
     {
+      if (m_lookupQueue)
+        QueueLookups(items, i, bDirNames, useLocal);
+
       CFileItemPtr pItem = items[i];
 
       // we do this since we may have a override per dir
@@ -456,7 +490,7 @@ namespace VIDEO
       }
 
       // clear our scraper cache
-      info2->ClearCache();
+      ClearScraperCache(info2);
 
       INFO_RET ret = INFO_CANCELLED;
       if (info2->Content() == CONTENT_TVSHOWS)
@@ -516,6 +550,10 @@ namespace VIDEO
     if(pDlgProgress)
       pDlgProgress->ShowProgressBar(false);
 
+    // lookups still running complete on their own, nothing waits for them
+    m_lookupQueue.reset();
+    m_lookups.clear();
+
     m_database.Close();
     return FoundSomeInfo;
   }
@@ -657,7 +695,14 @@ namespace VIDEO
     CScraperUrl scrUrl;
     // handle .nfo files
     std::unique_ptr<IVideoInfoTagLoader> loader;
-    if (useLocal)
+    std::shared_ptr<VideoLookup> lookup = TakeLookup(pItem);
+    if (lookup)
+    {
+      // already read when the lookup was queued
+      result = lookup->nfo;
+      loader = std::move(lookup->loader);
+    }
+    else if (useLocal)
     {
       loader.reset(CVideoInfoTagLoaderFactory::CreateLoader(*pItem, info2, bDirNames));
       if (loader)
@@ -688,7 +733,12 @@ namespace VIDEO
       movieTitle = tag->GetTitle();
       movieYear = tag->GetYear(); // movieYear is expected to be >= 0
     }
-    if (pURL && pURL->HasUrls())
+    if (lookup)
+    {
+      if ((retVal = WaitForLookup(*lookup, url)) <= 0)
+        return retVal < 0 ? INFO_CANCELLED : INFO_NOT_FOUND;
+    }
+    else if (pURL && pURL->HasUrls())
       url = *pURL;
     else if ((retVal = FindVideo(movieTitle, movieYear, info2, url, pDlgProgress)) <= 0)
       return retVal < 0 ? INFO_CANCELLED : INFO_NOT_FOUND;
@@ -699,7 +749,7 @@ namespace VIDEO
     if (GetDetails(pItem, url, info2,
                    (result == CInfoScanner::COMBINED_NFO ||
                     result == CInfoScanner::OVERRIDE_NFO) ? loader.get() : nullptr,
-                   pDlgProgress))
+                   pDlgProgress, lookup.get()))
     {
       if (AddVideo(pItem, info2->Content(), bDirNames, useLocal) < 0)
         return INFO_ERROR;
@@ -734,7 +784,14 @@ namespace VIDEO
     CScraperUrl scrUrl;
     // handle .nfo files
     std::unique_ptr<IVideoInfoTagLoader> loader;
-    if (useLocal)
+    std::shared_ptr<VideoLookup> lookup = TakeLookup(pItem);
+    if (lookup)
+    {
+      // already read when the lookup was queued
+      result = lookup->nfo;
+      loader = std::move(lookup->loader);
+    }
+    else if (useLocal)
     {
       loader.reset(CVideoInfoTagLoaderFactory::CreateLoader(*pItem, info2, bDirNames));
       if (loader)
@@ -765,7 +822,12 @@ namespace VIDEO
       movieTitle = tag->GetTitle();
       movieYear = tag->GetYear(); // movieYear is expected to be >= 0
     }
-    if (pURL && pURL->HasUrls())
+    if (lookup)
+    {
+      if ((retVal = WaitForLookup(*lookup, url)) <= 0)
+        return retVal < 0 ? INFO_CANCELLED : INFO_NOT_FOUND;
+    }
+    else if (pURL && pURL->HasUrls())
       url = *pURL;
     else if ((retVal = FindVideo(movieTitle, movieYear, info2, url, pDlgProgress)) <= 0)
       return retVal < 0 ? INFO_CANCELLED : INFO_NOT_FOUND;
@@ -776,7 +838,7 @@ namespace VIDEO
     if (GetDetails(pItem, url, info2,
                    (result == CInfoScanner::COMBINED_NFO ||
                     result == CInfoScanner::OVERRIDE_NFO) ? loader.get() : nullptr,
-                   pDlgProgress))
+                   pDlgProgress, lookup.get()))
     {
       if (AddVideo(pItem, info2->Content(), bDirNames, useLocal) < 0)
         return INFO_ERROR;
@@ -1931,15 +1993,25 @@ namespace VIDEO
   bool CVideoInfoScanner::GetDetails(CFileItem *pItem, CScraperUrl &url,
                                      const ScraperPtr& scraper,
                                      IVideoInfoTagLoader* loader,
-                                     CGUIDialogProgress* pDialog /* = NULL */)
+                                     CGUIDialogProgress* pDialog /* = NULL */,
+                                     VideoLookup* lookup /* = NULL */)
   {
     CVideoInfoTag movieDetails;
 
     if (m_handle && !url.GetTitle().empty())
       m_handle->SetText(url.GetTitle());
 
-    CVideoInfoDownloader imdb(scraper);
-    bool ret = imdb.GetDetails(url, movieDetails, pDialog);
+    bool ret;
+    if (lookup)
+    {
+      ret = lookup->gotDetails;
+      movieDetails = std::move(lookup->details);
+    }
+    else
+    {
+      CVideoInfoDownloader imdb(scraper);
+      ret = imdb.GetDetails(url, movieDetails, pDialog);
+    }
 
     if (ret)
     {
@@ -2235,4 +2307,126 @@ namespace VIDEO
     return 0;    // didn't find anything
   }
 
+  void CVideoInfoScanner::QueueLookups(const CFileItemList& items,
+                                       int next,
+                                       bool bDirNames,
+                                       bool useLocal)
+  {
+    // keep the lookups just ahead, their results are held in memory until they are used
+    const int end = std::min(items.Size(), next + 2 * static_cast<int>(
+        CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_iVideoScannerLookups));
+    for (m_nextLookup = std::max(m_nextLookup, next); m_nextLookup < end && !m_bStop; ++m_nextLookup)
+    {
+      CFileItemPtr pItem = items[m_nextLookup];
+
+      // only what RetrieveVideoInfo() and RetrieveInfoForMovie() would look up
+      if (pItem->m_bIsFolder || !pItem->IsVideo() || pItem->IsNFO() ||
+          (pItem->IsPlayList() && !URIUtils::HasExtension(pItem->GetPath(), ".strm")))
+        continue;
+
+      ScraperPtr scraper = m_database.GetScraperForPath(items.GetPath());
+      if (!scraper ||
+          (scraper->Content() != CONTENT_MOVIES && scraper->Content() != CONTENT_MUSICVIDEOS))
+        continue;
+
+      if (CUtil::ExcludeFileOrFolder(pItem->GetPath(), CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_moviesExcludeFromScanRegExps))
+        continue;
+
+      if (scraper->Content() == CONTENT_MOVIES ? m_database.HasMovieInfo(pItem->GetDynPath())
+                                               : m_database.HasMusicVideoInfo(pItem->GetPath()))
+        continue;
+
+      ClearScraperCache(scraper);
+
+      auto lookup = std::make_shared<VideoLookup>();
+      lookup->scraper = scraper;
+      lookup->title = pItem->GetMovieName(bDirNames);
+      if (useLocal)
+      {
+        lookup->loader.reset(CVideoInfoTagLoaderFactory::CreateLoader(*pItem, scraper, bDirNames));
+        if (lookup->loader)
+        {
+          pItem->GetVideoInfoTag()->Reset();
+          lookup->nfo = lookup->loader->Load(*pItem->GetVideoInfoTag(), false);
+        }
+      }
+
+      if (lookup->nfo == CInfoScanner::FULL_NFO)
+        lookup->done.Set(); // nothing to look up
+      else
+      {
+        if (lookup->nfo == CInfoScanner::URL_NFO || lookup->nfo == CInfoScanner::COMBINED_NFO)
+          lookup->url = lookup->loader->ScraperUrl();
+        else if (lookup->nfo == CInfoScanner::TITLE_NFO)
+        {
+          lookup->title = pItem->GetVideoInfoTag()->GetTitle();
+          lookup->year = pItem->GetVideoInfoTag()->GetYear();
+        }
+        m_lookupQueue->Submit([lookup]() { RunLookup(*lookup); });
+      }
+      m_lookups[pItem.get()] = lookup;
+    }
+  }
+
+  std::shared_ptr<CVideoInfoScanner::VideoLookup> CVideoInfoScanner::TakeLookup(const CFileItem* item)
+  {
+    std::shared_ptr<VideoLookup> lookup;
+    auto it = m_lookups.find(item);
+    if (it != m_lookups.end())
+    {
+      lookup = std::move(it->second);
+      m_lookups.erase(it);
+    }
+    return lookup;
+  }
+
+  int CVideoInfoScanner::WaitForLookup(VideoLookup& lookup, CScraperUrl& url)
+  {
+    while (!lookup.done.Wait(100ms))
+    {
+      if (m_bStop)
+        return -1;
+    }
+
+    // the same as FindVideo()
+    if (lookup.found < 0 || (lookup.found == 0 && (m_bStop || !DownloadFailed(nullptr))))
+    {
+      m_bStop = true;
+      return -1;
+    }
+    if (lookup.found > 0 && lookup.url.HasUrls())
+    {
+      url = lookup.url;
+      return 1;
+    }
+    return 0;
+  }
+
+  void CVideoInfoScanner::RunLookup(VideoLookup& lookup)
+  {
+    // runs on a job worker, the scanner is only touched through the lookup
+    CVideoInfoDownloader imdb(lookup.scraper);
+    if (lookup.url.HasUrls())
+      lookup.found = 1;
+    else
+    {
+      MOVIELIST movielist;
+      lookup.found = imdb.FindMovie(lookup.title, lookup.year, movielist);
+      if (lookup.found > 0 && !movielist.empty())
+        lookup.url = movielist[0];
+    }
+
+    if (lookup.found > 0 && lookup.url.HasUrls())
+      lookup.gotDetails = imdb.GetDetails(lookup.url, lookup.details);
+
+    lookup.done.Set();
+  }
+
+  void CVideoInfoScanner::ClearScraperCache(const ScraperPtr& scraper)
+  {
+    // the cache is shared by all instances of a scraper, and only expires between lists
+    if (m_clearedCaches.insert(scraper->ID()).second)
+      scraper->ClearCache();
+  }
+
 }
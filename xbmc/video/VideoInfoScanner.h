@@ -13,10 +13,13 @@
 #include "addons/Scraper.h"
 #include "guilib/GUIListItem.h"
 
+#include <map>
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
 
+class CJobQueue;
 class CRegExp;
 class CFileItem;
 class CFileItemList;
@@ -106,6 +109,8 @@ namespace VIDEO
     static std::string GetMovieSetInfoFolder(const std::string& setTitle);
 
   protected:
+    struct VideoLookup;
+
     virtual void Process();
     bool DoScan(const std::string& strDirectory) override;
 
@@ -148,12 +153,14 @@ namespace VIDEO
      \param scraper Scraper that handles parsing the online data.
      \param nfoFile if set, we override the online data with the locally supplied data. Defaults to NULL.
      \param pDialog progress dialog to update and check for cancellation during processing. Defaults to NULL.
+     \param lookup if set, the details already retrieved by a queued lookup are used. Defaults to NULL.
      \return true if information is found, false if an error occurred, the lookup was cancelled, or no information was found.
      */
     bool GetDetails(CFileItem *pItem, CScraperUrl &url,
                     const ADDON::ScraperPtr &scraper,
                     VIDEO::IVideoInfoTagLoader* nfoFile = nullptr,
-                    CGUIDialogProgress* pDialog = nullptr);
+                    CGUIDialogProgress* pDialog = nullptr,
+                    VideoLookup* lookup = nullptr);
 
     /*! \brief Extract episode and season numbers from a processed regexp
      \param reg Regular expression object with at least 2 matches
@@ -236,6 +243,32 @@ namespace VIDEO
     bool EnumerateSeriesFolder(CFileItem* item, EPISODELIST& episodeList);
     bool ProcessItemByVideoInfoTag(const CFileItem *item, EPISODELIST &episodeList);
 
+    /*! \brief Start the scraper lookups of the movies and music videos coming up in a list.
+     The lookups run in the background, a few at once, for the items just ahead of the one being
+     processed. RetrieveInfoForMovie() and RetrieveInfoForMusicVideo() pick up their results, so
+     the items are still added to the database one by one in the order of the list.
+     \param items the list being processed.
+     \param next index of the item processed next.
+     \param bDirNames whether we should use folder or file names for lookups.
+     \param useLocal should local data (.nfo) be used.
+     */
+    void QueueLookups(const CFileItemList& items, int next, bool bDirNames, bool useLocal);
+
+    /*! \brief Take the lookup queued for an item, if any */
+    std::shared_ptr<VideoLookup> TakeLookup(const CFileItem* item);
+
+    /*! \brief Wait for a queued lookup to complete
+     \param lookup the lookup to wait for.
+     \param url [out] url of the item found.
+     \return the same as FindVideo().
+     */
+    int WaitForLookup(VideoLookup& lookup, CScraperUrl& url);
+
+    static void RunLookup(VideoLookup& lookup);
+
+    /*! \brief Clear the cache of a scraper, the first time it is used for a list */
+    void ClearScraperCache(const ADDON::ScraperPtr& scraper);
+
     bool m_bStop;
     bool m_scanAll;
     std::string m_strStartDir;
@@ -243,6 +276,11 @@ namespace VIDEO
     std::set<std::string> m_pathsToCount;
     std::set<int> m_pathsToClean;
 
+    std::unique_ptr<CJobQueue> m_lookupQueue;
+    std::map<const CFileItem*, std::shared_ptr<VideoLookup>> m_lookups;
+    int m_nextLookup = 0; ///< index of the next item QueueLookups() looks at
+    std::set<std::string> m_clearedCaches;
+
   private:
     static void AddLocalItemArtwork(CGUIListItem::ArtMap& itemArt,
       const std::vector<std::string>& wantedArtTypes, const std::string& itemPath,
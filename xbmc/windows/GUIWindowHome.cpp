@@ -32,7 +32,8 @@ CGUIWindowHome::CGUIWindowHome(void) : CGUIWindow(WINDOW_HOME, "Home.xml")
   m_updateRA = (Audio | Video | Totals);
   m_loadType = KEEP_IN_MEMORY;
 
-  CServiceBroker::GetAnnouncementManager()->AddAnnouncer(this);
+  CServiceBroker::GetAnnouncementManager()->AddAnnouncer(
+      this, ANNOUNCEMENT::VideoLibrary | ANNOUNCEMENT::AudioLibrary);
 }
 
 CGUIWindowHome::~CGUIWindowHome(void)
@@ -75,19 +76,44 @@ void CGUIWindowHome::Announce(ANNOUNCEMENT::AnnouncementFlag flag,
                               const CVariant& data)
 {
   int ra_flag = 0;
+  if (GetUpdateFlag(flag, sender, message, data, ra_flag))
+    RefreshRecentlyAdded(ra_flag);
+}
+
+void CGUIWindowHome::AnnounceBatch(const std::vector<ANNOUNCEMENT::Announcement>& announcements)
+{
+  // a library scan announces every item, refresh once for all of them
+  int ra_flag = 0;
+  bool refresh = false;
+  for (const auto& announcement : announcements)
+  {
+    if (GetUpdateFlag(announcement.flag, announcement.sender, announcement.message,
+                      announcement.data, ra_flag))
+      refresh = true;
+  }
 
+  if (refresh)
+    RefreshRecentlyAdded(ra_flag);
+}
+
+bool CGUIWindowHome::GetUpdateFlag(ANNOUNCEMENT::AnnouncementFlag flag,
+                                   const std::string& sender,
+                                   const std::string& message,
+                                   const CVariant& data,
+                                   int& ra_flag)
+{
   CLog::Log(LOGDEBUG, LOGANNOUNCE, "GOT ANNOUNCEMENT, type: {}, from {}, message {}",
             AnnouncementFlagToString(flag), sender, message);
 
   // we are only interested in library changes
   if ((flag & (ANNOUNCEMENT::VideoLibrary | ANNOUNCEMENT::AudioLibrary)) == 0)
-    return;
+    return false;
 
   if (data.isMember("transaction") && data["transaction"].asBoolean())
-    return;
+    return false;
 
   if (message == "OnScanStarted" || message == "OnCleanStarted")
-    return;
+    return false;
 
   bool onUpdate = message == "OnUpdate";
   // always update Totals except on an OnUpdate with no playcount update
@@ -103,6 +129,11 @@ void CGUIWindowHome::Announce(ANNOUNCEMENT::AnnouncementFlag flag,
       ra_flag |= Audio;
   }
 
+  return true;
+}
+
+void CGUIWindowHome::RefreshRecentlyAdded(int ra_flag)
+{
   CGUIMessage reload(GUI_MSG_NOTIFY_ALL, GetID(), 0, GUI_MSG_REFRESH_THUMBS, ra_flag);
   CServiceBroker::GetGUI()->GetWindowManager().SendThreadMessage(reload, GetID());
 }
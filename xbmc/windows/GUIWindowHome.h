@@ -27,6 +27,7 @@ public:
                 const std::string& sender,
                 const std::string& message,
                 const CVariant& data) override;
+  void AnnounceBatch(const std::vector<ANNOUNCEMENT::Announcement>& announcements) override;
 
   bool OnMessage(CGUIMessage& message) override;
   bool OnAction(const CAction &action) override;
@@ -35,6 +36,12 @@ public:
 private:
   int m_updateRA; // flag for which recently added items needs to be queried
   void AddRecentlyAddedJobs(int flag);
+  bool GetUpdateFlag(ANNOUNCEMENT::AnnouncementFlag flag,
+                     const std::string& sender,
+                     const std::string& message,
+                     const CVariant& data,
+                     int& ra_flag);
+  void RefreshRecentlyAdded(int ra_flag);
 
   bool m_recentlyAddedRunning = false;
   int m_cumulativeUpdateFlag = 0;